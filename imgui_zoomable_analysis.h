@@ -0,0 +1,1105 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Analysis
+// ===============================
+// Measurement tools drawn over a zoomable view, and the engines answering
+// their queries on large single-channel images.
+//
+// Contents
+// --------
+// - `SelectRect()`: rectangle selection in image pixels, dragged with the
+//   right mouse button so it does not interfere with panning.
+// - `RegionStatistics`: count, mean, standard deviation, minimum and maximum
+//   of any rectangle of a tiled image. Each tile gets a summed-area table of
+//   its values and of their squares (in double precision) and a min/max
+//   pyramid, so a rectangle costs a constant number of lookups per tile it
+//   touches instead of a loop over its pixels. Tables are built in the
+//   background the first time a query needs them.
+// - `SelectLine()` and `SampleLineProfile()`: intensity profile along a
+//   segment, with nearest or bilinear interpolation and an optional band
+//   averaged across the line. Long lines are sampled on a coarser level of
+//   a `ScalarPyramid`, so profiles stay within a sample budget.
+//
+// Usage
+// -----
+//    ImGuiImage::RegionStatistics stats(grid, 0,
+//      [&](const ImGuiImage::TileKey& key, float* values) {
+//        // fill TileWidth(key) x TileHeight(key) values, row-major
+//        return ReadTile(key, values);
+//      });
+//    ImGuiImage::RectSelection selection;
+//
+//    ...
+//
+//    ImGuiImage::ZoomableCustom(displaySize, &state,
+//      [&](ImDrawList* drawList, const ImGuiImage::ViewTransform& view) {
+//        ImGuiImage::DrawImageRect(drawList, view, textureId,
+//          ImVec2(0, 0), state.textureSize);
+//        ImGuiImage::SelectRect(drawList, view, &selection);
+//      });
+//    if (selection.valid)
+//    {
+//      const ImGuiImage::RegionStats s{
+//        stats.Query(selection.min, selection.max) };
+//      ImGui::Text("mean %.2f  std %.2f  min %g  max %g%s", s.Mean(),
+//        s.StdDev(), s.min, s.max, s.complete ? "" : " (computing)");
+//    }
+//
+//    // line profile of a 16-bit image, updated while the segment is edited
+//    ImGuiImage::ScalarPyramid<uint16_t> pyramid({ pixels, width, height });
+//    ImGuiImage::LineSelection line;
+//    std::vector<float> profile;
+//
+//    ...
+//
+//    // in the draw callback
+//    if (ImGuiImage::SelectLine(drawList, view, &line, options.width))
+//    {
+//      ImGuiImage::SampleLineProfile(pyramid, line.start, line.end,
+//        &profile, options);
+//    }
+//
+//    // after the widget
+//    ImGuiImage::PlotProfile("Profile", profile);
+//
+
+#ifndef IMGUI_ZOOMABLE_ANALYSIS_H
+#define IMGUI_ZOOMABLE_ANALYSIS_H
+
+#include "imgui_zoomable_tiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Rectangle selected with `SelectRect()`, in image pixels.
+  //
+  // Members:
+  // - min, max: Corners of the selection, snapped to pixel edges and
+  //             clamped to the image.
+  // - valid: Whether there is a selection.
+  // - dragging: Whether the selection is being dragged.
+  struct RectSelection
+  {
+    ImVec2 min = ImVec2(0.0f, 0.0f);
+    ImVec2 max = ImVec2(0.0f, 0.0f);
+    bool valid = false;
+    bool dragging = false;
+  };
+
+  // Edit and draw a rectangle selection. Call it from the draw callback of
+  // `ZoomableCustom()`, after the image content. Dragging with `button`
+  // over the image selects a rectangle; clicking without dragging clears
+  // it. Returns true when the selection changed this frame.
+  IMGUI_API bool SelectRect(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    RectSelection* selection,
+    ImGuiMouseButton button = ImGuiMouseButton_Right,
+    ImU32 color = IM_COL32(255, 255, 0, 255));
+
+  // Statistics of the values of an image region.
+  //
+  // Members:
+  // - count: Number of pixels included.
+  // - sum, sumSquares: Sum of the values and of their squares.
+  // - min, max: Value range (+inf/-inf when `count` is 0).
+  // - complete: False if tiles of the region were still being prepared or
+  //             did not fit in the cache; the other members then only cover
+  //             the tiles already done.
+  struct RegionStats
+  {
+    std::uint64_t count = 0;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    float min = std::numeric_limits<float>::infinity();
+    float max = -std::numeric_limits<float>::infinity();
+    bool complete = true;
+
+    double Mean() const;
+    double Variance() const;
+    double StdDev() const;
+
+    // Accumulate the statistics of another region.
+    void Add(const RegionStats& other);
+  };
+
+  // Summed-area tables and min/max pyramid of the values of one tile.
+  //
+  // `Query()` takes pixel bounds relative to the tile, [x0, x1) x [y0, y1).
+  // The count, sum and squares come from four table lookups; the range
+  // descends the min/max pyramid, visiting only the cells along the edges of
+  // the rectangle.
+  class IntegralTile
+  {
+  public:
+    IntegralTile(const float* values, int width, int height);
+
+    int Width() const;
+    int Height() const;
+
+    RegionStats Query(int x0, int y0, int x1, int y1) const;
+    RegionStats Total() const;
+
+    // Memory used by the tables, in bytes.
+    std::size_t ByteSize() const;
+
+  private:
+    void Range(int level, int cx, int cy, int x0, int y0, int x1, int y1,
+      float* min, float* max) const;
+
+    int width_;
+    int height_;
+    std::vector<double> sum_;        // (width + 1) x (height + 1)
+    std::vector<double> sumSquares_; // (width + 1) x (height + 1)
+    // level 0 holds the values, level N the range of 2^N x 2^N blocks
+    std::vector<std::vector<float>> minLevels_;
+    std::vector<std::vector<float>> maxLevels_;
+    std::vector<int> levelWidths_;
+  };
+
+  // Region statistics of a tiled single-channel image (level 0 of `grid`).
+  //
+  // `read(key, values)` fills the `TileWidth(key) x TileHeight(key)` values
+  // of a tile, row-major, and returns false if the tile cannot be read. It
+  // runs on the workers of `ThreadPool::Default()` and must be thread-safe.
+  //
+  // Every tile keeps its totals (a few bytes) once computed, so tiles fully
+  // inside a query cost one lookup. Tiles cut by the edges of a query need
+  // their `IntegralTile` (about 1.7 MB for a 256 x 256 tile), kept in an LRU
+  // cache of `cacheCapacity` tiles. A query cutting more tiles than that
+  // stays incomplete: only the cut tiles already cached are counted.
+  //
+  // Statistics
+  //
+  // - tilesBuilt: Number of tile tables computed.
+  // - pending: Tiles being computed.
+  class RegionStatistics
+  {
+  public:
+    using ReadFn = std::function<bool(const TileKey& key, float* values)>;
+
+    struct Stats
+    {
+      std::uint64_t tilesBuilt = 0;
+      std::size_t pending = 0;
+    };
+
+    RegionStatistics(
+      const TileGrid& grid,
+      int layer,
+      ReadFn read,
+      std::size_t cacheCapacity = 32);
+    ~RegionStatistics();
+
+    RegionStatistics(const RegionStatistics&) = delete;
+    RegionStatistics& operator=(const RegionStatistics&) = delete;
+
+    // Statistics of the pixels of the rectangle [min, max] (in image pixels,
+    // rounded outwards to whole pixels). Tiles that are not ready are queued
+    // for computation and reported through `RegionStats::complete`.
+    RegionStats Query(const ImVec2& min, const ImVec2& max);
+
+    // Discard the tables of tiles whose data changed.
+    void Invalidate(int tileX, int tileY);
+    void InvalidateRect(const ImVec2& min, const ImVec2& max);
+    void Clear();
+
+    const TileGrid& Grid() const;
+    Stats GetStats() const;
+
+  private:
+    struct TileState
+    {
+      RegionStats total;
+      std::uint64_t version = 0;
+      bool ready = false;
+      bool pending = false;
+    };
+
+    // State shared with the background tasks.
+    struct Shared : detail::BackgroundTasks
+    {
+      std::unordered_map<TileKey, TileState, TileKeyHash> tiles;
+      std::uint64_t tilesBuilt = 0;
+    };
+
+    void Request(const TileKey& key, TileState* tile);
+
+    TileGrid grid_;
+    int layer_;
+    ReadFn read_;
+    std::shared_ptr<Shared> shared_;
+    std::shared_ptr<TileCache<IntegralTile>> cache_;
+  };
+
+  // Segment selected with `SelectLine()`, in image pixels.
+  //
+  // Members:
+  // - start, end: End points of the segment, clamped to the image.
+  // - valid: Whether there is a segment.
+  // - dragging: Which point is being dragged (0 = none, 1 = start, 2 = end).
+  struct LineSelection
+  {
+    ImVec2 start = ImVec2(0.0f, 0.0f);
+    ImVec2 end = ImVec2(0.0f, 0.0f);
+    bool valid = false;
+    int dragging = 0;
+  };
+
+  // Edit and draw a line segment. Call it from the draw callback of
+  // `ZoomableCustom()`, after the image content. Dragging with `button`
+  // draws a new segment, or moves an end point when the drag starts on its
+  // handle; clicking without dragging clears it. `width` (in image pixels)
+  // outlines the band averaged by `SampleLineProfile()`. Returns true when
+  // the segment changed this frame.
+  IMGUI_API bool SelectLine(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    LineSelection* selection,
+    float width = 1.0f,
+    ImGuiMouseButton button = ImGuiMouseButton_Right,
+    ImU32 color = IM_COL32(255, 255, 0, 255));
+
+  // Single-channel CPU image of any arithmetic pixel type (`uint8_t`,
+  // `uint16_t`, `float`, ...). `stride` is in pixels (0 = `width`).
+  template <typename T>
+  struct ScalarImage
+  {
+    const T* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+
+    float At(int x, int y) const;
+  };
+
+  // Pyramid of a `ScalarImage`, each level averaging 2x2 pixels of the
+  // previous one (in `float`), down to `minSize` pixels on the longer side.
+  // Level 0 refers to the source pixels, which must outlive the pyramid.
+  template <typename T>
+  class ScalarPyramid
+  {
+  public:
+    explicit ScalarPyramid(const ScalarImage<T>& image, int minSize = 256);
+
+    int LevelCount() const;
+    const ScalarImage<T>& Base() const;
+    ScalarImage<float> Level(int level) const; // level >= 1
+
+  private:
+    ScalarImage<T> base_;
+    std::vector<std::vector<float>> levels_; // level 1 first
+    std::vector<int> widths_;
+    std::vector<int> heights_;
+  };
+
+  // Interpolation of the samples of `SampleLineProfile()`.
+  enum class ProfileInterpolation
+  {
+    Nearest,
+    Bilinear,
+  };
+
+  // Options of `SampleLineProfile()`.
+  //
+  // Members:
+  // - interpolation: How values between pixel centers are computed.
+  // - width: Width of the band averaged across the line, in image pixels
+  //          (1 = the values on the line only).
+  // - maxSamples: Maximum number of samples along the line. Longer lines
+  //          are sampled on the pyramid level that keeps them under it,
+  //          so each sample still averages the pixels it stands for.
+  struct ProfileOptions
+  {
+    ProfileInterpolation interpolation = ProfileInterpolation::Bilinear;
+    float width = 1.0f;
+    int maxSamples = 100000;
+  };
+
+  // Sample the values along the segment [start, end] (in image pixels,
+  // e.g. from `LineSelection` or `State::mousePosition`) one pixel apart,
+  // writing them to `samples`. Samples are computed in parallel. Returns
+  // the pyramid level that was sampled, so sample i lies at
+  // `i * 2^level` image pixels from `start`.
+  template <typename T>
+  int SampleLineProfile(
+    const ScalarPyramid<T>& pyramid,
+    const ImVec2& start,
+    const ImVec2& end,
+    std::vector<float>* samples,
+    const ProfileOptions& options = ProfileOptions());
+
+  template <typename T>
+  int SampleLineProfile(
+    const ScalarImage<T>& image,
+    const ImVec2& start,
+    const ImVec2& end,
+    std::vector<float>* samples,
+    const ProfileOptions& options = ProfileOptions());
+
+  // Plot a profile with `ImGui::PlotLines()`, scaled to its value range.
+  IMGUI_API void PlotProfile(
+    const char* label,
+    const std::vector<float>& samples,
+    const ImVec2& size = ImVec2(0.0f, 120.0f));
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  inline bool SelectRect(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    RectSelection* selection,
+    ImGuiMouseButton button,
+    ImU32 color)
+  {
+    const ImVec2 screenMax{
+      view.screenPos.x + view.displaySize.x,
+      view.screenPos.y + view.displaySize.y };
+    const ImVec2 mouse{ ImGui::GetIO().MousePos };
+    const bool hovered{ ImGui::IsWindowHovered() &&
+      ImGui::IsMouseHoveringRect(view.screenPos, screenMax) };
+
+    bool changed{ false };
+    if (hovered && ImGui::IsMouseClicked(button))
+    {
+      selection->dragging = true;
+      selection->valid = false;
+      changed = true;
+    }
+    if (selection->dragging)
+    {
+      if (ImGui::IsMouseDown(button))
+      {
+        // order the corners in image space, whatever the orientation, and
+        // snap them outwards to pixel edges within the image
+        const ImVec2 start{ view.ScreenToImage(
+          ImGui::GetIO().MouseClickedPos[button]) };
+        const ImVec2 end{ view.ScreenToImage(mouse) };
+        const ImVec2& size{ view.textureSize };
+        const ImVec2 p0{
+          std::clamp(std::floor(std::min(start.x, end.x)), 0.0f, size.x),
+          std::clamp(std::floor(std::min(start.y, end.y)), 0.0f, size.y) };
+        const ImVec2 p1{
+          std::clamp(std::ceil(std::max(start.x, end.x)), 0.0f, size.x),
+          std::clamp(std::ceil(std::max(start.y, end.y)), 0.0f, size.y) };
+        const bool valid{ p1.x > p0.x && p1.y > p0.y &&
+          ImGui::IsMouseDragging(button) };
+        changed = changed || valid != selection->valid ||
+          p0.x != selection->min.x || p0.y != selection->min.y ||
+          p1.x != selection->max.x || p1.y != selection->max.y;
+        selection->min = p0;
+        selection->max = p1;
+        selection->valid = valid;
+      }
+      else
+      {
+        selection->dragging = false;
+      }
+    }
+
+    if (selection->valid && drawList != nullptr)
+    {
+      const ImVec2& p0{ selection->min };
+      const ImVec2& p1{ selection->max };
+      drawList->PushClipRect(view.screenPos, screenMax, true);
+      drawList->AddQuadFilled(
+        view.ImageToScreen(p0), view.ImageToScreen(ImVec2(p1.x, p0.y)),
+        view.ImageToScreen(p1), view.ImageToScreen(ImVec2(p0.x, p1.y)),
+        (color & ~IM_COL32_A_MASK) | (((color >> IM_COL32_A_SHIFT) / 8) << IM_COL32_A_SHIFT));
+      drawList->AddQuad(
+        view.ImageToScreen(p0), view.ImageToScreen(ImVec2(p1.x, p0.y)),
+        view.ImageToScreen(p1), view.ImageToScreen(ImVec2(p0.x, p1.y)),
+        color);
+      drawList->PopClipRect();
+    }
+    return changed;
+  }
+
+  inline double RegionStats::Mean() const
+  {
+    return count > 0 ? sum / static_cast<double>(count) : 0.0;
+  }
+
+  inline double RegionStats::Variance() const
+  {
+    if (count == 0)
+    {
+      return 0.0;
+    }
+    const double mean{ Mean() };
+    // rounding may leave a tiny negative value for constant regions
+    return std::max(0.0, sumSquares / static_cast<double>(count) - mean * mean);
+  }
+
+  inline double RegionStats::StdDev() const
+  {
+    return std::sqrt(Variance());
+  }
+
+  inline void RegionStats::Add(const RegionStats& other)
+  {
+    count += other.count;
+    sum += other.sum;
+    sumSquares += other.sumSquares;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    complete = complete && other.complete;
+  }
+
+  inline IntegralTile::IntegralTile(const float* values, int width, int height)
+    : width_(std::max(0, width))
+    , height_(std::max(0, height))
+  {
+    // summed-area tables with a zero first row and column, so a rectangle
+    // is S(x1, y1) - S(x0, y1) - S(x1, y0) + S(x0, y0) without branches
+    const std::size_t stride{ static_cast<std::size_t>(width_) + 1 };
+    sum_.assign(stride * (static_cast<std::size_t>(height_) + 1), 0.0);
+    sumSquares_.assign(sum_.size(), 0.0);
+    for (int y = 0; y < height_; ++y)
+    {
+      const float* row{ values + static_cast<std::size_t>(y) * width_ };
+      const double* sumAbove{ &sum_[static_cast<std::size_t>(y) * stride] };
+      const double* squaresAbove{ &sumSquares_[static_cast<std::size_t>(y) * stride] };
+      double* sumRow{ &sum_[static_cast<std::size_t>(y + 1) * stride] };
+      double* squaresRow{ &sumSquares_[static_cast<std::size_t>(y + 1) * stride] };
+      double rowSum{ 0.0 };
+      double rowSquares{ 0.0 };
+      for (int x = 0; x < width_; ++x)
+      {
+        const double v{ row[x] };
+        rowSum += v;
+        rowSquares += v * v;
+        sumRow[x + 1] = sumAbove[x + 1] + rowSum;
+        squaresRow[x + 1] = squaresAbove[x + 1] + rowSquares;
+      }
+    }
+
+    // min/max pyramid, halving until a single cell covers the tile
+    minLevels_.emplace_back(values, values + static_cast<std::size_t>(width_) * height_);
+    maxLevels_.push_back(minLevels_.back());
+    levelWidths_.push_back(width_);
+    int w{ width_ };
+    int h{ height_ };
+    while (w > 1 || h > 1)
+    {
+      const int nw{ (w + 1) / 2 };
+      const int nh{ (h + 1) / 2 };
+      const std::vector<float>& mins{ minLevels_.back() };
+      const std::vector<float>& maxs{ maxLevels_.back() };
+      std::vector<float> nextMins(static_cast<std::size_t>(nw) * nh);
+      std::vector<float> nextMaxs(nextMins.size());
+      for (int y = 0; y < nh; ++y)
+      {
+        const int y0{ 2 * y };
+        const int y1{ std::min(y0 + 1, h - 1) };
+        for (int x = 0; x < nw; ++x)
+        {
+          const int x0{ 2 * x };
+          const int x1{ std::min(x0 + 1, w - 1) };
+          const std::size_t i00{ static_cast<std::size_t>(y0) * w + x0 };
+          const std::size_t i01{ static_cast<std::size_t>(y0) * w + x1 };
+          const std::size_t i10{ static_cast<std::size_t>(y1) * w + x0 };
+          const std::size_t i11{ static_cast<std::size_t>(y1) * w + x1 };
+          const std::size_t i{ static_cast<std::size_t>(y) * nw + x };
+          nextMins[i] = std::min(std::min(mins[i00], mins[i01]), std::min(mins[i10], mins[i11]));
+          nextMaxs[i] = std::max(std::max(maxs[i00], maxs[i01]), std::max(maxs[i10], maxs[i11]));
+        }
+      }
+      minLevels_.push_back(std::move(nextMins));
+      maxLevels_.push_back(std::move(nextMaxs));
+      levelWidths_.push_back(nw);
+      w = nw;
+      h = nh;
+    }
+  }
+
+  inline int IntegralTile::Width() const
+  {
+    return width_;
+  }
+
+  inline int IntegralTile::Height() const
+  {
+    return height_;
+  }
+
+  inline void IntegralTile::Range(int level, int cx, int cy,
+    int x0, int y0, int x1, int y1, float* min, float* max) const
+  {
+    const int px0{ cx << level };
+    const int py0{ cy << level };
+    const int px1{ std::min(px0 + (1 << level), width_) };
+    const int py1{ std::min(py0 + (1 << level), height_) };
+    if (px0 >= x1 || py0 >= y1 || px1 <= x0 || py1 <= y0)
+    { // disjoint
+      return;
+    }
+    if (px0 >= x0 && py0 >= y0 && px1 <= x1 && py1 <= y1)
+    { // fully inside, the cell range applies
+      const std::size_t i{ static_cast<std::size_t>(cy) * levelWidths_[level] + cx };
+      *min = std::min(*min, minLevels_[level][i]);
+      *max = std::max(*max, maxLevels_[level][i]);
+      return;
+    }
+    // cut by an edge of the rectangle (never at level 0, a single pixel is
+    // either inside or outside)
+    const int childWidth{ levelWidths_[level - 1] };
+    const int childHeight{ static_cast<int>(minLevels_[level - 1].size()) / childWidth };
+    for (int y = 2 * cy; y < std::min(2 * cy + 2, childHeight); ++y)
+    {
+      for (int x = 2 * cx; x < std::min(2 * cx + 2, childWidth); ++x)
+      {
+        Range(level - 1, x, y, x0, y0, x1, y1, min, max);
+      }
+    }
+  }
+
+  inline RegionStats IntegralTile::Query(int x0, int y0, int x1, int y1) const
+  {
+    x0 = std::clamp(x0, 0, width_);
+    x1 = std::clamp(x1, 0, width_);
+    y0 = std::clamp(y0, 0, height_);
+    y1 = std::clamp(y1, 0, height_);
+    RegionStats stats;
+    if (x1 <= x0 || y1 <= y0)
+    {
+      return stats;
+    }
+    const std::size_t stride{ static_cast<std::size_t>(width_) + 1 };
+    const std::size_t i00{ static_cast<std::size_t>(y0) * stride + x0 };
+    const std::size_t i01{ static_cast<std::size_t>(y0) * stride + x1 };
+    const std::size_t i10{ static_cast<std::size_t>(y1) * stride + x0 };
+    const std::size_t i11{ static_cast<std::size_t>(y1) * stride + x1 };
+    stats.count = static_cast<std::uint64_t>(x1 - x0) * static_cast<std::uint64_t>(y1 - y0);
+    stats.sum = sum_[i11] - sum_[i01] - sum_[i10] + sum_[i00];
+    stats.sumSquares = sumSquares_[i11] - sumSquares_[i01] - sumSquares_[i10] + sumSquares_[i00];
+    Range(static_cast<int>(minLevels_.size()) - 1, 0, 0, x0, y0, x1, y1,
+      &stats.min, &stats.max);
+    return stats;
+  }
+
+  inline RegionStats IntegralTile::Total() const
+  {
+    return Query(0, 0, width_, height_);
+  }
+
+  inline std::size_t IntegralTile::ByteSize() const
+  {
+    std::size_t bytes{ (sum_.size() + sumSquares_.size()) * sizeof(double) };
+    for (std::size_t i = 0; i < minLevels_.size(); ++i)
+    {
+      bytes += (minLevels_[i].size() + maxLevels_[i].size()) * sizeof(float);
+    }
+    return bytes;
+  }
+
+  inline RegionStatistics::RegionStatistics(
+    const TileGrid& grid,
+    int layer,
+    ReadFn read,
+    std::size_t cacheCapacity)
+    : grid_(grid)
+    , layer_(layer)
+    , read_(std::move(read))
+    , shared_(std::make_shared<Shared>())
+    , cache_(std::make_shared<TileCache<IntegralTile>>(cacheCapacity))
+  {
+  }
+
+  inline RegionStatistics::~RegionStatistics()
+  {
+    shared_->Close();
+  }
+
+  inline void RegionStatistics::Request(const TileKey& key, TileState* tile)
+  {
+    // called with the mutex held
+    if (tile->pending)
+    {
+      return;
+    }
+    tile->pending = true;
+    ThreadPool::Default().Submit(0,
+      [shared = shared_, cache = cache_, read = &read_, key,
+       version = tile->version, width = grid_.TileWidth(key),
+       height = grid_.TileHeight(key)] {
+        if (!shared->Begin())
+        {
+          return;
+        }
+        std::vector<float> values(static_cast<std::size_t>(width) * height);
+        std::shared_ptr<const IntegralTile> table;
+        if ((*read)(key, values.data()))
+        {
+          table = std::make_shared<const IntegralTile>(values.data(), width, height);
+        }
+
+        shared->End([&] {
+          TileState& state{ shared->tiles[key] };
+          if (state.version == version)
+          { // still current; a failed read is retried by the next query
+            state.pending = false;
+            if (table != nullptr)
+            {
+              state.total = table->Total();
+              state.ready = true;
+              cache->Insert(key, std::move(table));
+              ++shared->tilesBuilt;
+            }
+          }
+        });
+      });
+  }
+
+  inline RegionStats RegionStatistics::Query(const ImVec2& min, const ImVec2& max)
+  {
+    RegionStats stats;
+    const int x0{ std::max(0, static_cast<int>(std::floor(min.x))) };
+    const int y0{ std::max(0, static_cast<int>(std::floor(min.y))) };
+    const int x1{ std::min(grid_.width, static_cast<int>(std::ceil(max.x))) };
+    const int y1{ std::min(grid_.height, static_cast<int>(std::ceil(max.y))) };
+    if (x1 <= x0 || y1 <= y0)
+    {
+      return stats;
+    }
+
+    const int tileSize{ grid_.tileSize };
+    const int tx0{ x0 / tileSize };
+    const int ty0{ y0 / tileSize };
+    const int tx1{ (x1 - 1) / tileSize };
+    const int ty1{ (y1 - 1) / tileSize };
+    // the tables of the tiles cut by the edges are only built if they all
+    // fit in the cache, otherwise they would evict each other forever
+    const std::size_t edgeTiles{ static_cast<std::size_t>(
+      tx0 == tx1 || ty0 == ty1 ? (tx1 - tx0 + 1) * (ty1 - ty0 + 1) :
+      2 * (tx1 - tx0 + 1) + 2 * (ty1 - ty0 - 1)) };
+    const bool edgesFit{ edgeTiles <= cache_->Capacity() };
+
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    for (int ty = ty0; ty <= ty1; ++ty)
+    {
+      for (int tx = tx0; tx <= tx1; ++tx)
+      {
+        const TileKey key{ layer_, 0, tx, ty };
+        TileState& tile{ shared_->tiles[key] };
+        // rectangle relative to the tile
+        const int rx0{ std::max(x0 - tx * tileSize, 0) };
+        const int ry0{ std::max(y0 - ty * tileSize, 0) };
+        const int rx1{ std::min(x1 - tx * tileSize, grid_.TileWidth(key)) };
+        const int ry1{ std::min(y1 - ty * tileSize, grid_.TileHeight(key)) };
+        const bool whole{ rx0 == 0 && ry0 == 0 &&
+          rx1 == grid_.TileWidth(key) && ry1 == grid_.TileHeight(key) };
+
+        if (tile.ready && whole)
+        {
+          stats.Add(tile.total);
+          continue;
+        }
+        const std::shared_ptr<const IntegralTile> table{
+          tile.ready ? cache_->Find(key) : nullptr };
+        if (table != nullptr)
+        {
+          stats.Add(table->Query(rx0, ry0, rx1, ry1));
+          continue;
+        }
+        // evicted or never computed
+        if (whole || edgesFit)
+        {
+          Request(key, &tile);
+        }
+        stats.complete = false;
+      }
+    }
+    return stats;
+  }
+
+  inline void RegionStatistics::Invalidate(int tileX, int tileY)
+  {
+    const TileKey key{ layer_, 0, tileX, tileY };
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      auto it{ shared_->tiles.find(key) };
+      if (it != shared_->tiles.end())
+      { // a computation in flight no longer matches the version
+        it->second.ready = false;
+        it->second.pending = false;
+        ++it->second.version;
+      }
+    }
+    cache_->Erase(key);
+  }
+
+  inline void RegionStatistics::InvalidateRect(const ImVec2& min, const ImVec2& max)
+  {
+    const int tileSize{ grid_.tileSize };
+    const int tx0{ std::max(0, static_cast<int>(std::floor(min.x)) / tileSize) };
+    const int ty0{ std::max(0, static_cast<int>(std::floor(min.y)) / tileSize) };
+    const int tx1{ std::min(grid_.TilesX(0) - 1, static_cast<int>(std::ceil(max.x) - 1) / tileSize) };
+    const int ty1{ std::min(grid_.TilesY(0) - 1, static_cast<int>(std::ceil(max.y) - 1) / tileSize) };
+    for (int ty = ty0; ty <= ty1; ++ty)
+    {
+      for (int tx = tx0; tx <= tx1; ++tx)
+      {
+        Invalidate(tx, ty);
+      }
+    }
+  }
+
+  inline void RegionStatistics::Clear()
+  {
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      for (auto& [key, tile] : shared_->tiles)
+      {
+        tile.ready = false;
+        tile.pending = false;
+        ++tile.version;
+      }
+    }
+    cache_->Clear();
+  }
+
+  inline const TileGrid& RegionStatistics::Grid() const
+  {
+    return grid_;
+  }
+
+  inline RegionStatistics::Stats RegionStatistics::GetStats() const
+  {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    Stats stats;
+    stats.tilesBuilt = shared_->tilesBuilt;
+    for (const auto& [key, tile] : shared_->tiles)
+    {
+      stats.pending += tile.pending ? 1 : 0;
+    }
+    return stats;
+  }
+
+  inline bool SelectLine(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    LineSelection* selection,
+    float width,
+    ImGuiMouseButton button,
+    ImU32 color)
+  {
+    constexpr float kHandleRadius{ 5.0f };
+    const ImVec2 screenMax{
+      view.screenPos.x + view.displaySize.x,
+      view.screenPos.y + view.displaySize.y };
+    const ImVec2 mouse{ ImGui::GetIO().MousePos };
+    const bool hovered{ ImGui::IsWindowHovered() &&
+      ImGui::IsMouseHoveringRect(view.screenPos, screenMax) };
+
+    // same mapping as `State::mousePosition`
+    auto toImage = [&](const ImVec2& screenPoint) {
+      const ImVec2 p{ view.ScreenToImage(screenPoint) };
+      return ImVec2(
+        std::clamp(p.x, 0.0f, view.textureSize.x),
+        std::clamp(p.y, 0.0f, view.textureSize.y));
+    };
+    auto nearHandle = [&](const ImVec2& imagePoint) {
+      const ImVec2 p{ view.ImageToScreen(imagePoint) };
+      const float dx{ p.x - mouse.x };
+      const float dy{ p.y - mouse.y };
+      return dx * dx + dy * dy <= 4.0f * kHandleRadius * kHandleRadius;
+    };
+
+    const LineSelection previous{ *selection };
+    if (hovered && ImGui::IsMouseClicked(button))
+    {
+      if (selection->valid && nearHandle(selection->end))
+      {
+        selection->dragging = 2;
+      }
+      else if (selection->valid && nearHandle(selection->start))
+      {
+        selection->dragging = 1;
+      }
+      else
+      { // start a new segment, dragging its end point
+        selection->start = toImage(mouse);
+        selection->end = selection->start;
+        selection->valid = false;
+        selection->dragging = 2;
+      }
+    }
+    if (selection->dragging != 0)
+    {
+      if (ImGui::IsMouseDown(button))
+      {
+        (selection->dragging == 1 ? selection->start : selection->end) = toImage(mouse);
+        selection->valid = selection->start.x != selection->end.x ||
+          selection->start.y != selection->end.y;
+      }
+      else
+      {
+        selection->dragging = 0;
+      }
+    }
+
+    if (selection->valid && drawList != nullptr)
+    {
+      const ImVec2 p0{ view.ImageToScreen(selection->start) };
+      const ImVec2 p1{ view.ImageToScreen(selection->end) };
+      drawList->PushClipRect(view.screenPos, screenMax, true);
+      if (width > 1.0f)
+      { // outline of the averaged band, offset along the normal in image space
+        const float dx{ selection->end.x - selection->start.x };
+        const float dy{ selection->end.y - selection->start.y };
+        const float length{ std::sqrt(dx * dx + dy * dy) };
+        const ImVec2 n{ -dy / length * width * 0.5f, dx / length * width * 0.5f };
+        const ImVec2& a{ selection->start };
+        const ImVec2& b{ selection->end };
+        drawList->AddQuad(
+          view.ImageToScreen(ImVec2(a.x + n.x, a.y + n.y)),
+          view.ImageToScreen(ImVec2(b.x + n.x, b.y + n.y)),
+          view.ImageToScreen(ImVec2(b.x - n.x, b.y - n.y)),
+          view.ImageToScreen(ImVec2(a.x - n.x, a.y - n.y)),
+          (color & ~IM_COL32_A_MASK) | (((color >> IM_COL32_A_SHIFT) / 2) << IM_COL32_A_SHIFT));
+      }
+      drawList->AddLine(p0, p1, color);
+      drawList->AddCircle(p0, kHandleRadius, color);
+      drawList->AddCircleFilled(p1, kHandleRadius, color);
+      drawList->PopClipRect();
+    }
+    return selection->valid != previous.valid ||
+      (selection->valid && (
+        selection->start.x != previous.start.x || selection->start.y != previous.start.y ||
+        selection->end.x != previous.end.x || selection->end.y != previous.end.y));
+  }
+
+  template <typename T>
+  inline float ScalarImage<T>::At(int x, int y) const
+  {
+    const std::size_t rowPixels{ static_cast<std::size_t>(stride > 0 ? stride : width) };
+    return static_cast<float>(pixels[static_cast<std::size_t>(y) * rowPixels + x]);
+  }
+
+  template <typename T>
+  inline ScalarPyramid<T>::ScalarPyramid(const ScalarImage<T>& image, int minSize)
+    : base_(image)
+  {
+    int w{ image.width };
+    int h{ image.height };
+    while (std::max(w, h) > std::max(1, minSize))
+    {
+      const int nw{ (w + 1) / 2 };
+      const int nh{ (h + 1) / 2 };
+      std::vector<float> next(static_cast<std::size_t>(nw) * nh);
+      auto source = [&](int x, int y) {
+        return levels_.empty() ? base_.At(x, y) :
+          levels_.back()[static_cast<std::size_t>(y) * w + x];
+      };
+      ParallelFor(0, nh, [&](int y) {
+        const int y0{ 2 * y };
+        const int y1{ std::min(y0 + 1, h - 1) };
+        for (int x = 0; x < nw; ++x)
+        {
+          const int x0{ 2 * x };
+          const int x1{ std::min(x0 + 1, w - 1) };
+          next[static_cast<std::size_t>(y) * nw + x] = 0.25f *
+            (source(x0, y0) + source(x1, y0) + source(x0, y1) + source(x1, y1));
+        }
+      }, 16);
+      levels_.push_back(std::move(next));
+      widths_.push_back(nw);
+      heights_.push_back(nh);
+      w = nw;
+      h = nh;
+    }
+  }
+
+  template <typename T>
+  inline int ScalarPyramid<T>::LevelCount() const
+  {
+    return static_cast<int>(levels_.size()) + 1;
+  }
+
+  template <typename T>
+  inline const ScalarImage<T>& ScalarPyramid<T>::Base() const
+  {
+    return base_;
+  }
+
+  template <typename T>
+  inline ScalarImage<float> ScalarPyramid<T>::Level(int level) const
+  {
+    const std::size_t i{ static_cast<std::size_t>(level - 1) };
+    return ScalarImage<float>{ levels_[i].data(), widths_[i], heights_[i], widths_[i] };
+  }
+
+  namespace detail
+  {
+    // Sample the segment [start, end] (in image pixels) on a pyramid level
+    // `scale` times smaller than the image, one level pixel apart.
+    template <typename T>
+    inline void SampleLine(
+      const ScalarImage<T>& image,
+      float scale,
+      const ImVec2& start,
+      const ImVec2& end,
+      const ProfileOptions& options,
+      std::vector<float>* samples)
+    {
+      const ImVec2 p0{ start.x * scale, start.y * scale };
+      const float dx{ (end.x - start.x) * scale };
+      const float dy{ (end.y - start.y) * scale };
+      const float length{ std::sqrt(dx * dx + dy * dy) };
+      const int count{ std::clamp(static_cast<int>(std::ceil(length)) + 1,
+        1, std::max(1, options.maxSamples)) };
+      samples->resize(static_cast<std::size_t>(count));
+      if (image.width <= 0 || image.height <= 0)
+      {
+        std::fill(samples->begin(), samples->end(), 0.0f);
+        return;
+      }
+
+      // step along the line and across it, for the averaged band
+      const ImVec2 step{ count > 1 ? ImVec2(dx / (count - 1), dy / (count - 1)) :
+        ImVec2(0.0f, 0.0f) };
+      const ImVec2 normal{ length > 0.0f ? ImVec2(-dy / length, dx / length) :
+        ImVec2(0.0f, 0.0f) };
+      const int taps{ std::max(1, static_cast<int>(std::lround(options.width * scale))) };
+      const float firstTap{ -0.5f * static_cast<float>(taps - 1) };
+      const bool bilinear{ options.interpolation == ProfileInterpolation::Bilinear };
+      const int maxX{ image.width - 1 };
+      const int maxY{ image.height - 1 };
+
+      // pixel i covers [i, i + 1), so its center is at i + 0.5
+      auto value = [&](float x, float y) {
+        if (!bilinear)
+        {
+          return image.At(
+            std::clamp(static_cast<int>(std::floor(x)), 0, maxX),
+            std::clamp(static_cast<int>(std::floor(y)), 0, maxY));
+        }
+        const float fx{ x - 0.5f };
+        const float fy{ y - 0.5f };
+        const float x0f{ std::floor(fx) };
+        const float y0f{ std::floor(fy) };
+        const float tx{ fx - x0f };
+        const float ty{ fy - y0f };
+        const int x0{ std::clamp(static_cast<int>(x0f), 0, maxX) };
+        const int y0{ std::clamp(static_cast<int>(y0f), 0, maxY) };
+        const int x1{ std::clamp(static_cast<int>(x0f) + 1, 0, maxX) };
+        const int y1{ std::clamp(static_cast<int>(y0f) + 1, 0, maxY) };
+        const float top{ image.At(x0, y0) + (image.At(x1, y0) - image.At(x0, y0)) * tx };
+        const float bottom{ image.At(x0, y1) + (image.At(x1, y1) - image.At(x0, y1)) * tx };
+        return top + (bottom - top) * ty;
+      };
+
+      constexpr int kBlock{ 4096 };
+      float* out{ samples->data() };
+      ParallelFor(0, (count + kBlock - 1) / kBlock, [&](int block) {
+        const int i1{ std::min(count, (block + 1) * kBlock) };
+        for (int i = block * kBlock; i < i1; ++i)
+        {
+          const float cx{ p0.x + step.x * static_cast<float>(i) };
+          const float cy{ p0.y + step.y * static_cast<float>(i) };
+          float sum{ 0.0f };
+          for (int k = 0; k < taps; ++k)
+          {
+            const float offset{ firstTap + static_cast<float>(k) };
+            sum += value(cx + normal.x * offset, cy + normal.y * offset);
+          }
+          out[i] = sum / static_cast<float>(taps);
+        }
+      });
+    }
+  } // namespace detail
+
+  template <typename T>
+  inline int SampleLineProfile(
+    const ScalarPyramid<T>& pyramid,
+    const ImVec2& start,
+    const ImVec2& end,
+    std::vector<float>* samples,
+    const ProfileOptions& options)
+  {
+    // coarsest level needed to stay under the sample limit
+    const float dx{ end.x - start.x };
+    const float dy{ end.y - start.y };
+    const float length{ std::sqrt(dx * dx + dy * dy) };
+    int level{ 0 };
+    while (level + 1 < pyramid.LevelCount() &&
+           std::ceil(std::ldexp(length, -level)) + 1.0f > static_cast<float>(options.maxSamples))
+    {
+      ++level;
+    }
+    if (level == 0)
+    {
+      detail::SampleLine(pyramid.Base(), 1.0f, start, end, options, samples);
+    }
+    else
+    {
+      detail::SampleLine(pyramid.Level(level), std::ldexp(1.0f, -level),
+        start, end, options, samples);
+    }
+    return level;
+  }
+
+  template <typename T>
+  inline int SampleLineProfile(
+    const ScalarImage<T>& image,
+    const ImVec2& start,
+    const ImVec2& end,
+    std::vector<float>* samples,
+    const ProfileOptions& options)
+  {
+    detail::SampleLine(image, 1.0f, start, end, options, samples);
+    return 0;
+  }
+
+  inline void PlotProfile(
+    const char* label,
+    const std::vector<float>& samples,
+    const ImVec2& size)
+  {
+    if (samples.empty())
+    {
+      return;
+    }
+    const auto [minIt, maxIt] = std::minmax_element(samples.begin(), samples.end());
+    ImGui::PlotLines(label, samples.data(), static_cast<int>(samples.size()), 0,
+      nullptr, *minIt, *maxIt, size);
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_ANALYSIS_H
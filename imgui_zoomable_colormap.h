@@ -0,0 +1,653 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Colormaps
+// ================================
+// False color display of single-channel data (thermal, depth, scientific
+// measurements) in 8, 16 or 32-bit integers or floats.
+//
+// Values are mapped to colors through a table of 256 or 4096 entries
+// sampled from a built-in colormap (viridis, inferno, magma, plasma, jet,
+// gray) or supplied by the caller, over a `[low, high]` value range:
+//
+// - 8 and 16-bit data go through a table covering every possible value,
+//   rebuilt when the colormap or range changes, so each pixel is a single
+//   lookup.
+// - Other types compute the table index arithmetically, four values at a
+//   time with SSE2.
+//
+// When compiled with AVX2 (e.g. `-mavx2`, `/arch:AVX2`) both paths fetch
+// eight colors per instruction with hardware gathers.
+//
+// `ColormapSource` applies a colormap to a tiled image lazily: tiles are
+// mapped when requested (i.e. visible), and only the requested tiles are
+// mapped again when the colormap or range changes. Raw tiles are cached,
+// so that does not read the data again.
+//
+// Usage
+// -----
+//    ImGuiImage::ColormapSource<float> depth(grid,
+//      [&](const ImGuiImage::TileKey& key, float* values) {
+//        return ReadDepthTile(key, values);
+//      },
+//      [&](const ImGuiImage::TileKey& key,
+//          std::shared_ptr<const ImGuiImage::TileImage> image) {
+//        scheduler.Enqueue(key, std::move(image));
+//      });
+//    depth.SetColormap(ImGuiImage::Colormap::Viridis, 4096);
+//    depth.SetRange(0.5f, 8.0f);
+//
+//    ...
+//
+//    ImGuiImage::ZoomableTiles(grid, 0, displaySize, &state,
+//      [&](const ImGuiImage::TileKey& key) {
+//        depth.Request(key);
+//        return atlas.Lookup(key);
+//      });
+//
+
+#ifndef IMGUI_ZOOMABLE_COLORMAP_H
+#define IMGUI_ZOOMABLE_COLORMAP_H
+
+#include "imgui_zoomable_tiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// AVX2 gathers are used when the target supports them; they are not part of
+// the x86-64 baseline, so this needs the corresponding compiler option.
+#if defined(IMGUI_ZOOMABLE_IMAGE_SSE2) && defined(__AVX2__)
+#define IMGUI_ZOOMABLE_IMAGE_AVX2 1
+#include <immintrin.h>
+#endif
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Built-in colormaps. Viridis, inferno, magma and plasma are perceptually
+  // uniform and readable in grayscale; jet is provided for familiarity.
+  enum class Colormap
+  {
+    Gray,
+    Viridis,
+    Inferno,
+    Magma,
+    Plasma,
+    Jet,
+  };
+
+  // Table of `size` opaque colors sampling `colormap` from its low end to
+  // its high end.
+  IMGUI_API std::vector<ImU32> BuildColormapTable(Colormap colormap, int size = 256);
+
+  // Map `count` values to colors: values at or below `low` take the first
+  // entry of `table`, values at or above `high` the last, NaNs the first.
+  template <typename T>
+  void ApplyColormap(
+    const T* values,
+    std::size_t count,
+    float low,
+    float high,
+    const std::vector<ImU32>& table,
+    ImU32* dst);
+
+  // Table covering every value of an 8 or 16-bit type for `ApplyLut()`,
+  // equivalent to `ApplyColormap()` with the same arguments.
+  template <typename T>
+  std::vector<ImU32> BuildValueLut(float low, float high, const std::vector<ImU32>& table);
+
+  // Map `count` 8 or 16-bit values through a table from `BuildValueLut()`.
+  template <typename T>
+  void ApplyLut(const T* values, std::size_t count, const ImU32* lut, ImU32* dst);
+
+  // Applies a colormap to a tiled single-channel image on demand.
+  //
+  // `read(key, values)` fills the `TileWidth(key) x TileHeight(key)` values
+  // of a tile and returns false if it cannot be read. `ready(key, image)`
+  // receives the mapped tiles. Both run on the workers of
+  // `ThreadPool::Default()` and must be thread-safe.
+  //
+  // Statistics
+  //
+  // - mapped: Tiles mapped to colors.
+  // - reads: Tiles read from the source.
+  // - pending: Tiles being mapped.
+  template <typename T>
+  class ColormapSource
+  {
+    static_assert(std::is_arithmetic_v<T>, "values must be integers or floats");
+
+  public:
+    using ReadFn = std::function<bool(const TileKey& key, T* values)>;
+    using ReadyFn = std::function<void(
+      const TileKey& key, std::shared_ptr<const TileImage> image)>;
+
+    struct Stats
+    {
+      std::uint64_t mapped = 0;
+      std::uint64_t reads = 0;
+      std::size_t pending = 0;
+    };
+
+    // `cacheCapacity` is the number of raw tiles cached.
+    ColormapSource(
+      const TileGrid& grid,
+      ReadFn read,
+      ReadyFn ready,
+      std::size_t cacheCapacity = 256);
+    ~ColormapSource();
+
+    ColormapSource(const ColormapSource&) = delete;
+    ColormapSource& operator=(const ColormapSource&) = delete;
+
+    // Change the colormap (built-in, or a table of any size) or the value
+    // range. Tiles are mapped again when requested.
+    void SetColormap(Colormap colormap, int tableSize = 256);
+    void SetColormap(std::vector<ImU32> table);
+    void SetRange(float low, float high);
+
+    const std::vector<ImU32>& Table() const;
+    float Low() const;
+    float High() const;
+
+    // Make sure the mapped tile for `key` is up to date, queueing it if not.
+    // Call it for the visible tiles every frame (e.g. from the lookup
+    // callback of `ZoomableTiles()`). Returns true if it is up to date.
+    bool Request(const TileKey& key);
+
+    // Discard the data of a tile whose values changed.
+    void Invalidate(const TileKey& key);
+    void Clear();
+
+    Stats GetStats() const;
+
+  private:
+    // Mapping as seen by the tasks.
+    struct Mapping
+    {
+      std::uint64_t version = 0;
+      float low = 0.0f;
+      float high = 1.0f;
+      std::vector<ImU32> table;
+      std::vector<ImU32> valueLut; // 8 and 16-bit types only
+    };
+
+    struct TileState
+    {
+      std::uint64_t mapped = 0;  // version of the last mapped tile
+      std::uint64_t pending = 0; // version being mapped
+      std::uint64_t dataVersion = 0;
+    };
+
+    // State shared with the background tasks.
+    struct Shared : detail::BackgroundTasks
+    {
+      std::unordered_map<TileKey, TileState, TileKeyHash> tiles;
+      TileCache<std::vector<T>> cache;
+      std::uint64_t mapped = 0;
+      std::uint64_t reads = 0;
+
+      explicit Shared(std::size_t capacity) : cache(capacity) {}
+    };
+
+    static constexpr bool kValueLut{ std::is_integral_v<T> && sizeof(T) <= 2 };
+
+    void UpdateMapping();
+
+    TileGrid grid_;
+    ReadFn read_;
+    ReadyFn ready_;
+    std::vector<ImU32> table_;
+    float low_ = 0.0f;
+    float high_ = 1.0f;
+    std::shared_ptr<const Mapping> mapping_;
+    std::shared_ptr<Shared> shared_;
+  };
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  inline std::vector<ImU32> BuildColormapTable(Colormap colormap, int size)
+  {
+    // ten evenly spaced stops, interpolated linearly
+    static constexpr ImU32 kStops[][10]{
+      { // viridis
+        0x440154, 0x482878, 0x3E4989, 0x31688E, 0x26828E,
+        0x1F9E89, 0x35B779, 0x6ECE58, 0xB5DE2B, 0xFDE725 },
+      { // inferno
+        0x000004, 0x1B0C42, 0x4B0C6B, 0x781C6D, 0xA52C60,
+        0xCF4446, 0xED6925, 0xFB9A06, 0xF7D03C, 0xFCFFA4 },
+      { // magma
+        0x000004, 0x180F3E, 0x451077, 0x721F81, 0x9F2F7F,
+        0xCD4071, 0xF1605D, 0xFD9567, 0xFEC98D, 0xFCFDBF },
+      { // plasma
+        0x0D0887, 0x47039F, 0x7301A8, 0x9C179E, 0xBD3786,
+        0xD8576B, 0xED7953, 0xFA9E3B, 0xFDC926, 0xF0F921 },
+    };
+
+    size = std::max(2, size);
+    std::vector<ImU32> table(static_cast<std::size_t>(size));
+    for (int i = 0; i < size; ++i)
+    {
+      const float t{ static_cast<float>(i) / static_cast<float>(size - 1) };
+      float r, g, b;
+      switch (colormap)
+      {
+      case Colormap::Gray:
+        r = g = b = t;
+        break;
+      case Colormap::Jet:
+        r = std::clamp(1.5f - std::abs(4.0f * t - 3.0f), 0.0f, 1.0f);
+        g = std::clamp(1.5f - std::abs(4.0f * t - 2.0f), 0.0f, 1.0f);
+        b = std::clamp(1.5f - std::abs(4.0f * t - 1.0f), 0.0f, 1.0f);
+        break;
+      default:
+      {
+        const ImU32* stops{ kStops[static_cast<int>(colormap) - 1] };
+        const float x{ t * 9.0f };
+        const int k{ std::min(8, static_cast<int>(x)) };
+        const float f{ x - static_cast<float>(k) };
+        auto channel = [&](int shift) {
+          const float c0{ static_cast<float>((stops[k] >> shift) & 0xFF) };
+          const float c1{ static_cast<float>((stops[k + 1] >> shift) & 0xFF) };
+          return (c0 + (c1 - c0) * f) / 255.0f;
+        };
+        r = channel(16);
+        g = channel(8);
+        b = channel(0);
+        break;
+      }
+      }
+      table[static_cast<std::size_t>(i)] = IM_COL32(
+        static_cast<int>(r * 255.0f + 0.5f),
+        static_cast<int>(g * 255.0f + 0.5f),
+        static_cast<int>(b * 255.0f + 0.5f),
+        255);
+    }
+    return table;
+  }
+
+  template <typename T>
+  inline void ApplyColormap(
+    const T* values,
+    std::size_t count,
+    float low,
+    float high,
+    const std::vector<ImU32>& table,
+    ImU32* dst)
+  {
+    if (table.empty())
+    {
+      return;
+    }
+    // index = (value - low) * scale, rounded and clamped to the table
+    const float last{ static_cast<float>(table.size() - 1) };
+    const float scale{ high > low ? last / (high - low) : 0.0f };
+    const float offset{ high > low ? 0.5f - low * scale : 0.0f };
+    const ImU32* lut{ table.data() };
+    std::size_t i{ 0 };
+#if defined(IMGUI_ZOOMABLE_IMAGE_AVX2)
+    {
+      const __m256 vScale{ _mm256_set1_ps(scale) };
+      const __m256 vOffset{ _mm256_set1_ps(offset) };
+      const __m256 vLast{ _mm256_set1_ps(last) };
+      for (; i + 8 <= count; i += 8)
+      {
+        __m256 v;
+        if constexpr (std::is_same_v<T, float>)
+        {
+          v = _mm256_loadu_ps(values + i);
+        }
+        else
+        {
+          v = _mm256_setr_ps(
+            static_cast<float>(values[i]), static_cast<float>(values[i + 1]),
+            static_cast<float>(values[i + 2]), static_cast<float>(values[i + 3]),
+            static_cast<float>(values[i + 4]), static_cast<float>(values[i + 5]),
+            static_cast<float>(values[i + 6]), static_cast<float>(values[i + 7]));
+        }
+        // max(x, 0) returns 0 for NaN
+        const __m256 x{ _mm256_min_ps(_mm256_max_ps(
+          _mm256_add_ps(_mm256_mul_ps(v, vScale), vOffset), _mm256_setzero_ps()), vLast) };
+        const __m256i index{ _mm256_cvttps_epi32(x) };
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+          _mm256_i32gather_epi32(reinterpret_cast<const int*>(lut), index, 4));
+      }
+    }
+#elif defined(IMGUI_ZOOMABLE_IMAGE_SSE2)
+    {
+      const __m128 vScale{ _mm_set1_ps(scale) };
+      const __m128 vOffset{ _mm_set1_ps(offset) };
+      const __m128 vLast{ _mm_set1_ps(last) };
+      alignas(16) std::int32_t index[4];
+      for (; i + 4 <= count; i += 4)
+      {
+        __m128 v;
+        if constexpr (std::is_same_v<T, float>)
+        {
+          v = _mm_loadu_ps(values + i);
+        }
+        else
+        {
+          v = _mm_setr_ps(
+            static_cast<float>(values[i]), static_cast<float>(values[i + 1]),
+            static_cast<float>(values[i + 2]), static_cast<float>(values[i + 3]));
+        }
+        // max(x, 0) returns 0 for NaN
+        const __m128 x{ _mm_min_ps(_mm_max_ps(
+          _mm_add_ps(_mm_mul_ps(v, vScale), vOffset), _mm_setzero_ps()), vLast) };
+        _mm_store_si128(reinterpret_cast<__m128i*>(index), _mm_cvttps_epi32(x));
+        // no gather in SSE2
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_setr_epi32(
+          static_cast<int>(lut[index[0]]), static_cast<int>(lut[index[1]]),
+          static_cast<int>(lut[index[2]]), static_cast<int>(lut[index[3]])));
+      }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+      const float x{ static_cast<float>(values[i]) * scale + offset };
+      // written so NaN maps to the first entry
+      const float clamped{ x > 0.0f ? std::min(x, last) : 0.0f };
+      dst[i] = lut[static_cast<std::size_t>(clamped)];
+    }
+  }
+
+  template <typename T>
+  inline std::vector<ImU32> BuildValueLut(float low, float high, const std::vector<ImU32>& table)
+  {
+    static_assert(std::is_integral_v<T> && sizeof(T) <= 2,
+      "value tables are for 8 and 16-bit types");
+    constexpr std::size_t kSize{ std::size_t{ 1 } << (8 * sizeof(T)) };
+    std::vector<T> values(kSize);
+    for (std::size_t v = 0; v < kSize; ++v)
+    { // in index order, so signed types map like unsigned bit patterns
+      values[v] = static_cast<T>(v);
+    }
+    std::vector<ImU32> lut(kSize);
+    ApplyColormap(values.data(), kSize, low, high, table, lut.data());
+    return lut;
+  }
+
+  template <typename T>
+  inline void ApplyLut(const T* values, std::size_t count, const ImU32* lut, ImU32* dst)
+  {
+    static_assert(std::is_integral_v<T> && sizeof(T) <= 2,
+      "value tables are for 8 and 16-bit types");
+    using Index = std::make_unsigned_t<T>;
+    std::size_t i{ 0 };
+#if defined(IMGUI_ZOOMABLE_IMAGE_AVX2)
+    for (; i + 8 <= count; i += 8)
+    {
+      __m256i index;
+      if constexpr (sizeof(T) == 1)
+      {
+        index = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(values + i)));
+      }
+      else
+      {
+        index = _mm256_cvtepu16_epi32(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)));
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+        _mm256_i32gather_epi32(reinterpret_cast<const int*>(lut), index, 4));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+      dst[i] = lut[static_cast<Index>(values[i])];
+    }
+  }
+
+  template <typename T>
+  inline ColormapSource<T>::ColormapSource(
+    const TileGrid& grid,
+    ReadFn read,
+    ReadyFn ready,
+    std::size_t cacheCapacity)
+    : grid_(grid)
+    , read_(std::move(read))
+    , ready_(std::move(ready))
+    , table_(BuildColormapTable(Colormap::Gray))
+    , shared_(std::make_shared<Shared>(cacheCapacity))
+  {
+    if constexpr (std::is_integral_v<T>)
+    { // full range of the type by default
+      low_ = static_cast<float>(std::numeric_limits<T>::min());
+      high_ = static_cast<float>(std::numeric_limits<T>::max());
+    }
+    UpdateMapping();
+  }
+
+  template <typename T>
+  inline ColormapSource<T>::~ColormapSource()
+  {
+    shared_->Close();
+  }
+
+  template <typename T>
+  inline void ColormapSource<T>::SetColormap(Colormap colormap, int tableSize)
+  {
+    SetColormap(BuildColormapTable(colormap, tableSize));
+  }
+
+  template <typename T>
+  inline void ColormapSource<T>::SetColormap(std::vector<ImU32> table)
+  {
+    if (table != table_ && !table.empty())
+    {
+      table_ = std::move(table);
+      UpdateMapping();
+    }
+  }
+
+  template <typename T>
+  inline void ColormapSource<T>::SetRange(float low, float high)
+  {
+    if (low != low_ || high != high_)
+    {
+      low_ = low;
+      high_ = high;
+      UpdateMapping();
+    }
+  }
+
+  template <typename T>
+  inline const std::vector<ImU32>& ColormapSource<T>::Table() const
+  {
+    return table_;
+  }
+
+  template <typename T>
+  inline float ColormapSource<T>::Low() const
+  {
+    return low_;
+  }
+
+  template <typename T>
+  inline float ColormapSource<T>::High() const
+  {
+    return high_;
+  }
+
+  template <typename T>
+  inline void ColormapSource<T>::UpdateMapping()
+  {
+    auto mapping{ std::make_shared<Mapping>() };
+    mapping->version = mapping_ != nullptr ? mapping_->version + 1 : 1;
+    mapping->low = low_;
+    mapping->high = high_;
+    mapping->table = table_;
+    if constexpr (kValueLut)
+    {
+      mapping->valueLut = BuildValueLut<T>(low_, high_, table_);
+    }
+    mapping_ = std::move(mapping);
+  }
+
+  template <typename T>
+  inline bool ColormapSource<T>::Request(const TileKey& key)
+  {
+    std::uint64_t dataVersion;
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      TileState& tile{ shared_->tiles[key] };
+      if (tile.mapped == mapping_->version)
+      {
+        return true;
+      }
+      if (tile.pending == mapping_->version)
+      {
+        return false;
+      }
+      tile.pending = mapping_->version;
+      dataVersion = tile.dataVersion;
+    }
+
+    ThreadPool::Default().Submit(0,
+      [shared = shared_, mapping = mapping_, read = &read_, ready = &ready_,
+       key, dataVersion, width = grid_.TileWidth(key),
+       height = grid_.TileHeight(key)] {
+        if (!shared->Begin([&] {
+          const TileState& state{ shared->tiles[key] };
+          return state.pending != mapping->version || state.dataVersion != dataVersion;
+        }))
+        { // superseded while queued
+          return;
+        }
+
+        const std::size_t count{ static_cast<std::size_t>(width) * height };
+        std::shared_ptr<const std::vector<T>> values{ shared->cache.Find(key) };
+        bool fromSource{ false };
+        if (values == nullptr)
+        {
+          auto data{ std::make_shared<std::vector<T>>(count) };
+          if ((*read)(key, data->data()))
+          {
+            values = std::move(data);
+            fromSource = true;
+          }
+        }
+
+        std::shared_ptr<TileImage> image;
+        if (values != nullptr)
+        {
+          image = std::make_shared<TileImage>();
+          image->width = width;
+          image->height = height;
+          image->pixels.resize(count);
+          if constexpr (kValueLut)
+          {
+            ApplyLut(values->data(), count, mapping->valueLut.data(), image->pixels.data());
+          }
+          else
+          {
+            ApplyColormap(values->data(), count, mapping->low, mapping->high,
+              mapping->table, image->pixels.data());
+          }
+        }
+
+        shared->End([&] {
+          TileState& state{ shared->tiles[key] };
+          shared->reads += fromSource ? 1 : 0;
+          if (state.dataVersion != dataVersion)
+          {
+            return false;
+          }
+          if (fromSource)
+          { // not invalidated while reading
+            shared->cache.Insert(key, values);
+          }
+          if (state.pending == mapping->version)
+          { // a failed read is retried by the next request
+            state.pending = 0;
+          }
+          if (image == nullptr || state.mapped >= mapping->version)
+          { // failed, or a task started later finished first
+            return false;
+          }
+          state.mapped = mapping->version;
+          ++shared->mapped;
+          return true;
+        },
+        [&] { (*ready)(key, std::move(image)); });
+      });
+    return false;
+  }
+
+  template <typename T>
+  inline void ColormapSource<T>::Invalidate(const TileKey& key)
+  {
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      TileState& tile{ shared_->tiles[key] };
+      ++tile.dataVersion;
+      tile.mapped = 0;
+      tile.pending = 0;
+    }
+    shared_->cache.Erase(key);
+  }
+
+  template <typename T>
+  inline void ColormapSource<T>::Clear()
+  {
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      for (auto& [key, tile] : shared_->tiles)
+      {
+        ++tile.dataVersion;
+        tile.mapped = 0;
+        tile.pending = 0;
+      }
+    }
+    shared_->cache.Clear();
+  }
+
+  template <typename T>
+  inline typename ColormapSource<T>::Stats ColormapSource<T>::GetStats() const
+  {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    Stats stats;
+    stats.mapped = shared_->mapped;
+    stats.reads = shared_->reads;
+    for (const auto& [key, tile] : shared_->tiles)
+    {
+      stats.pending += tile.pending != 0 ? 1 : 0;
+    }
+    return stats;
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_COLORMAP_H
@@ -0,0 +1,538 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Comparison
+// =================================
+// Before/after review of two images of the same size in a single widget: a
+// divider splits the display area, image A is drawn on one side and image B
+// on the other, both with the zoom, pan and orientation of the shared
+// `State`. Dragging the divider with the left mouse button moves it;
+// dragging anywhere else pans as usual.
+//
+// The divider is placed in screen space (a fraction of the display width or
+// height), so it stays put while the view moves. Each side is clipped to
+// its part of the display area and, for tiled images, only the tiles under
+// that part are looked up and drawn, so the comparison costs about the same
+// as a single view.
+//
+// Two more ways to compare registered images are provided:
+//
+// - `DifferenceSource`: |A - B| of two tiled images through a colormap,
+//   computed only for the tiles requested (i.e. visible) with SSE2, and
+//   cached per tile like `ColormapSource` (see `imgui_zoomable_colormap.h`),
+//   so no full difference image is ever allocated. The low end of the range
+//   acts as a threshold: smaller differences take the first color.
+// - `UpdateBlink()`: alternates between A and B at a fixed interval, for
+//   displaying either image in the same view.
+//
+// Usage
+// -----
+//    ImGuiImage::State state;
+//    ImGuiImage::CompareState compare;
+//    state.textureSize = ImVec2(width, height);
+//
+//    ...
+//
+//    ImGuiImage::ZoomableCompare(beforeTexture, afterTexture, displaySize,
+//      &state, &compare);
+//
+//    // tiled images sharing a grid
+//    ImGuiImage::ZoomableTilesCompare(grid, 0, displaySize, &state, &compare,
+//      [&](const ImGuiImage::TileKey& key) { return before.Lookup(key); },
+//      [&](const ImGuiImage::TileKey& key) { return after.Lookup(key); });
+//
+//    // difference of two 16-bit images, showing changes above 20 levels
+//    ImGuiImage::DifferenceSource<uint16_t> difference(grid,
+//      [&](const ImGuiImage::TileKey& key, uint16_t* values) {
+//        return before.Read(key, values);
+//      },
+//      [&](const ImGuiImage::TileKey& key, uint16_t* values) {
+//        return after.Read(key, values);
+//      },
+//      [&](const ImGuiImage::TileKey& key,
+//          std::shared_ptr<const ImGuiImage::TileImage> image) {
+//        scheduler.Enqueue(key, std::move(image));
+//      });
+//    difference.SetColormap(ImGuiImage::Colormap::Inferno);
+//    difference.SetRange(20.0f, 1000.0f);
+//
+//    ...
+//
+//    ImGuiImage::ZoomableTiles(grid, 0, displaySize, &state,
+//      [&](const ImGuiImage::TileKey& key) {
+//        difference.Request(key);
+//        return atlas.Lookup(key);
+//      });
+//
+//    // blink between the two images
+//    const bool showAfter{ ImGuiImage::UpdateBlink(&blink) };
+//    ImGuiImage::Zoomable(showAfter ? afterTexture : beforeTexture,
+//      displaySize, &state);
+//
+
+#ifndef IMGUI_ZOOMABLE_COMPARE_H
+#define IMGUI_ZOOMABLE_COMPARE_H
+
+#include "imgui_zoomable_colormap.h"
+#include "imgui_zoomable_tiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Divider of a comparison view, kept across frames.
+  //
+  // Members:
+  // - split: Position of the divider, as a fraction of the display width
+  //          (or height when `horizontal` is set). Image A is drawn before
+  //          it (left or top), image B after it.
+  // - horizontal: Split the display area into top and bottom halves
+  //          instead of left and right.
+  // - dividerColor: Color of the divider line and handle.
+  // - dragging: Whether the divider is being dragged.
+  struct CompareState
+  {
+    float split = 0.5f;
+    bool horizontal = false;
+    ImU32 dividerColor = IM_COL32(255, 255, 255, 220);
+    bool dragging = false;
+  };
+
+  // Zoomable comparison of two textures
+  // ===================================
+  // Same as `Zoomable()`, but shows `texA` and `texB` on each side of the
+  // divider of `compare` (see `CompareState`). Both textures must have the
+  // size given by `state->textureSize`. `compare` may be `nullptr` to show
+  // a fixed split in the middle.
+  IMGUI_API void ZoomableCompare(
+    ImTextureRef texA,
+    ImTextureRef texB,
+    const ImVec2& displaySize,
+    State* state,
+    CompareState* compare,
+    const ImVec4& bgColor = kDefaultBackgroundColor,
+    const ImVec4& tintColor = kDefaultTintColor);
+
+  // Zoomable comparison of two tiled images
+  // =======================================
+  // Same as `ZoomableTiles()`, but the tiles on each side of the divider are
+  // looked up with `lookupA` and `lookupB` respectively. Both images share
+  // the geometry of `grid`; each lookup is only called for the tiles under
+  // its side of the display area.
+  template <typename LookupA, typename LookupB>
+  void ZoomableTilesCompare(
+    const TileGrid& grid,
+    int layer,
+    const ImVec2& displaySize,
+    State* state,
+    CompareState* compare,
+    LookupA&& lookupA,
+    LookupB&& lookupB,
+    const ImVec4& bgColor = kDefaultBackgroundColor,
+    const ImVec4& tintColor = kDefaultTintColor);
+
+  // Write |a[i] - b[i]| to `dst[i]` for `count` values. Signed integers
+  // saturate to the largest value of the type. `dst` may alias `a` or `b`.
+  template <typename T>
+  void AbsDifference(const T* a, const T* b, std::size_t count, T* dst);
+
+  // Absolute difference of two tiled images, mapped to colors on demand.
+  //
+  // `readA(key, values)` and `readB(key, values)` fill the values of a tile
+  // of each image, as the `read` callback of `ColormapSource`; `ready(key,
+  // image)` receives the mapped tiles. All run on the workers of
+  // `ThreadPool::Default()` and must be thread-safe. The statistic `reads`
+  // counts the difference tiles computed (each reading both images).
+  //
+  // Call `Invalidate()` for the tiles where either image changed.
+  template <typename T>
+  class DifferenceSource
+  {
+  public:
+    using ReadFn = typename ColormapSource<T>::ReadFn;
+    using ReadyFn = typename ColormapSource<T>::ReadyFn;
+    using Stats = typename ColormapSource<T>::Stats;
+
+    // `cacheCapacity` is the number of difference tiles cached.
+    DifferenceSource(
+      const TileGrid& grid,
+      ReadFn readA,
+      ReadFn readB,
+      ReadyFn ready,
+      std::size_t cacheCapacity = 256);
+
+    // Same as in `ColormapSource`. Differences at or below `low` take the
+    // first color of the table, so `low` is the threshold.
+    void SetColormap(Colormap colormap, int tableSize = 256);
+    void SetColormap(std::vector<ImU32> table);
+    void SetRange(float low, float high);
+    void SetThreshold(float threshold);
+
+    const std::vector<ImU32>& Table() const;
+    float Low() const;
+    float High() const;
+
+    bool Request(const TileKey& key);
+    void Invalidate(const TileKey& key);
+    void Clear();
+
+    Stats GetStats() const;
+
+  private:
+    ColormapSource<T> source_;
+  };
+
+  // Blink between two images, kept across frames.
+  //
+  // Members:
+  // - interval: Seconds each image is shown.
+  // - playing: Whether the images alternate; when false `showB` is kept.
+  // - showB: Whether image B is shown.
+  // - elapsed: Seconds since the last switch.
+  struct BlinkState
+  {
+    float interval = 0.5f;
+    bool playing = true;
+    bool showB = false;
+    float elapsed = 0.0f;
+  };
+
+  // Advance the blink by the frame time and return whether image B should
+  // be shown this frame.
+  IMGUI_API bool UpdateBlink(BlinkState* blink);
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  namespace detail
+  {
+    // Lay out a comparison view and handle its divider. `drawSide(drawList,
+    // view, side, clipMin, clipMax)` draws image A (`side` 0) or B (1) in
+    // the given screen rectangle.
+    template <typename DrawSideFn>
+    inline void ZoomableSplit(
+      const ImVec2& displaySize,
+      State* state,
+      CompareState* compare,
+      const ImVec4& bgColor,
+      DrawSideFn&& drawSide)
+    {
+      constexpr float kGrabRadius{ 4.0f };
+      CompareState defaultCompare;
+      CompareState* c{ compare != nullptr ? compare : &defaultCompare };
+
+      ZoomableCustom(displaySize, state,
+        [&](ImDrawList* drawList, const ViewTransform& view) {
+          const ImVec2 screenMax{
+            view.screenPos.x + view.displaySize.x,
+            view.screenPos.y + view.displaySize.y };
+          if (bgColor.w > 0.0f)
+          {
+            drawList->AddRectFilled(view.screenPos, screenMax,
+              ImGui::GetColorU32(bgColor));
+          }
+
+          // divider position along the split axis, in screen coordinates
+          const bool h{ c->horizontal };
+          const float origin{ h ? view.screenPos.y : view.screenPos.x };
+          const float length{ h ? view.displaySize.y : view.displaySize.x };
+          auto dividerAt = [&]() {
+            return origin + std::clamp(c->split, 0.0f, 1.0f) * length;
+          };
+
+          float at{ dividerAt() };
+          const bool hovered{ compare != nullptr && ImGui::IsWindowHovered() &&
+            ImGui::IsMouseHoveringRect(
+              h ? ImVec2(view.screenPos.x, at - kGrabRadius) : ImVec2(at - kGrabRadius, view.screenPos.y),
+              h ? ImVec2(screenMax.x, at + kGrabRadius) : ImVec2(at + kGrabRadius, screenMax.y)) };
+          if (hovered && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+          {
+            c->dragging = true;
+          }
+          if (c->dragging)
+          {
+            if (ImGui::IsMouseDown(ImGuiMouseButton_Left))
+            {
+              const ImVec2 mouse{ ImGui::GetIO().MousePos };
+              c->split = std::clamp(((h ? mouse.y : mouse.x) - origin) / length,
+                0.0f, 1.0f);
+              at = dividerAt();
+            }
+            else
+            {
+              c->dragging = false;
+            }
+          }
+          if (hovered || c->dragging)
+          {
+            ImGui::SetMouseCursor(h ? ImGuiMouseCursor_ResizeNS : ImGuiMouseCursor_ResizeEW);
+            if (state != nullptr)
+            { // the drag moves the divider, not the image
+              state->zoomPanSuspended = true;
+            }
+          }
+
+          const ImVec2 dividerMin{ h ? ImVec2(view.screenPos.x, at) : ImVec2(at, view.screenPos.y) };
+          const ImVec2 dividerMax{ h ? ImVec2(screenMax.x, at) : ImVec2(at, screenMax.y) };
+          drawSide(drawList, view, 0, view.screenPos, dividerMax);
+          drawSide(drawList, view, 1, dividerMin, screenMax);
+
+          const ImVec2 center{
+            (dividerMin.x + dividerMax.x) * 0.5f,
+            (dividerMin.y + dividerMax.y) * 0.5f };
+          drawList->AddLine(dividerMin, dividerMax, c->dividerColor,
+            c->dragging ? 2.0f : 1.0f);
+          drawList->AddCircleFilled(center, kGrabRadius + 1.0f, c->dividerColor);
+        });
+    }
+  } // namespace detail
+
+  inline void ZoomableCompare(
+    ImTextureRef texA,
+    ImTextureRef texB,
+    const ImVec2& displaySize,
+    State* state,
+    CompareState* compare,
+    const ImVec4& bgColor,
+    const ImVec4& tintColor)
+  {
+    const ImU32 tint{ ImGui::GetColorU32(tintColor) };
+    detail::ZoomableSplit(displaySize, state, compare, bgColor,
+      [&](ImDrawList* drawList, const ViewTransform& view, int side,
+          const ImVec2& clipMin, const ImVec2& clipMax) {
+        if (clipMax.x <= clipMin.x || clipMax.y <= clipMin.y)
+        {
+          return;
+        }
+        drawList->PushClipRect(clipMin, clipMax, true);
+        DrawImageRect(drawList, view, side == 0 ? texA : texB,
+          ImVec2(0.0f, 0.0f), view.textureSize, kDefaultUV0, kDefaultUV1, tint);
+        drawList->PopClipRect();
+      });
+  }
+
+  template <typename LookupA, typename LookupB>
+  inline void ZoomableTilesCompare(
+    const TileGrid& grid,
+    int layer,
+    const ImVec2& displaySize,
+    State* state,
+    CompareState* compare,
+    LookupA&& lookupA,
+    LookupB&& lookupB,
+    const ImVec4& bgColor,
+    const ImVec4& tintColor)
+  {
+    if (state != nullptr)
+    {
+      state->textureSize = ImVec2(
+        static_cast<float>(grid.width), static_cast<float>(grid.height));
+    }
+
+    detail::ZoomableSplit(displaySize, state, compare, bgColor,
+      [&](ImDrawList* drawList, const ViewTransform& view, int side,
+          const ImVec2& clipMin, const ImVec2& clipMax) {
+        if (side == 0)
+        {
+          DrawTileLayer(drawList, view, grid, layer, lookupA,
+            clipMin, clipMax, tintColor);
+        }
+        else
+        {
+          DrawTileLayer(drawList, view, grid, layer, lookupB,
+            clipMin, clipMax, tintColor);
+        }
+      });
+  }
+
+  namespace detail
+  {
+    template <typename T>
+    inline T AbsDifference(T a, T b)
+    {
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        return std::abs(a - b);
+      }
+      else
+      { // modular unsigned subtraction gives the exact distance
+        using U = std::make_unsigned_t<T>;
+        const U d{ a > b ? static_cast<U>(static_cast<U>(a) - static_cast<U>(b)) :
+          static_cast<U>(static_cast<U>(b) - static_cast<U>(a)) };
+        constexpr U kMax{ static_cast<U>(std::numeric_limits<T>::max()) };
+        return static_cast<T>(d > kMax ? kMax : d);
+      }
+    }
+  } // namespace detail
+
+  template <typename T>
+  inline void AbsDifference(const T* a, const T* b, std::size_t count, T* dst)
+  {
+    std::size_t i{ 0 };
+#ifdef IMGUI_ZOOMABLE_IMAGE_SSE2
+    if constexpr (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::uint16_t>)
+    { // |a - b| = (a -sat b) | (b -sat a)
+      constexpr std::size_t kStep{ 16 / sizeof(T) };
+      for (; i + kStep <= count; i += kStep)
+      {
+        const __m128i va{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)) };
+        const __m128i vb{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)) };
+        const __m128i d{ sizeof(T) == 1 ?
+          _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va)) :
+          _mm_or_si128(_mm_subs_epu16(va, vb), _mm_subs_epu16(vb, va)) };
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), d);
+      }
+    }
+    else if constexpr (std::is_same_v<T, float>)
+    { // clear the sign bit of the difference
+      const __m128 mask{ _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)) };
+      for (; i + 4 <= count; i += 4)
+      {
+        _mm_storeu_ps(dst + i,
+          _mm_and_ps(mask, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i))));
+      }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+      dst[i] = detail::AbsDifference(a[i], b[i]);
+    }
+  }
+
+  template <typename T>
+  inline DifferenceSource<T>::DifferenceSource(
+    const TileGrid& grid,
+    ReadFn readA,
+    ReadFn readB,
+    ReadyFn ready,
+    std::size_t cacheCapacity)
+    : source_(grid,
+        [grid, readA = std::move(readA), readB = std::move(readB)](
+          const TileKey& key, T* values) {
+          // only the tile of B needs a buffer, A is read in place
+          const std::size_t count{
+            static_cast<std::size_t>(grid.TileWidth(key)) * grid.TileHeight(key) };
+          std::vector<T> other(count);
+          if (!readA(key, values) || !readB(key, other.data()))
+          {
+            return false;
+          }
+          AbsDifference(values, other.data(), count, values);
+          return true;
+        },
+        std::move(ready), cacheCapacity)
+  {
+  }
+
+  template <typename T>
+  inline void DifferenceSource<T>::SetColormap(Colormap colormap, int tableSize)
+  {
+    source_.SetColormap(colormap, tableSize);
+  }
+
+  template <typename T>
+  inline void DifferenceSource<T>::SetColormap(std::vector<ImU32> table)
+  {
+    source_.SetColormap(std::move(table));
+  }
+
+  template <typename T>
+  inline void DifferenceSource<T>::SetRange(float low, float high)
+  {
+    source_.SetRange(low, high);
+  }
+
+  template <typename T>
+  inline void DifferenceSource<T>::SetThreshold(float threshold)
+  {
+    source_.SetRange(threshold, source_.High());
+  }
+
+  template <typename T>
+  inline const std::vector<ImU32>& DifferenceSource<T>::Table() const
+  {
+    return source_.Table();
+  }
+
+  template <typename T>
+  inline float DifferenceSource<T>::Low() const
+  {
+    return source_.Low();
+  }
+
+  template <typename T>
+  inline float DifferenceSource<T>::High() const
+  {
+    return source_.High();
+  }
+
+  template <typename T>
+  inline bool DifferenceSource<T>::Request(const TileKey& key)
+  {
+    return source_.Request(key);
+  }
+
+  template <typename T>
+  inline void DifferenceSource<T>::Invalidate(const TileKey& key)
+  {
+    source_.Invalidate(key);
+  }
+
+  template <typename T>
+  inline void DifferenceSource<T>::Clear()
+  {
+    source_.Clear();
+  }
+
+  template <typename T>
+  inline typename DifferenceSource<T>::Stats DifferenceSource<T>::GetStats() const
+  {
+    return source_.GetStats();
+  }
+
+  inline bool UpdateBlink(BlinkState* blink)
+  {
+    if (blink->playing && blink->interval > 0.0f)
+    {
+      blink->elapsed += ImGui::GetIO().DeltaTime;
+      if (blink->elapsed >= blink->interval)
+      { // long frames may skip whole periods
+        const int switches{ static_cast<int>(blink->elapsed / blink->interval) };
+        blink->elapsed -= static_cast<float>(switches) * blink->interval;
+        blink->showB = (switches & 1) != 0 ? !blink->showB : blink->showB;
+      }
+    }
+    return blink->showB;
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_COMPARE_H
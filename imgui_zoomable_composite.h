@@ -0,0 +1,553 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Channel Compositing
+// ==========================================
+// Display of multi-channel images (fluorescence microscopy, multispectral
+// imaging, ...) where every channel has its own color, contrast window and
+// visibility, composited on the fly for the visible tiles only.
+//
+// The channels are kept separate: raw channel tiles are read once and cached,
+// and each composite tile remembers the settings it was made with. Changing
+// a channel only recomposites the tiles that are requested again (i.e. the
+// visible ones) and only if that channel takes part in them; editing a hidden
+// channel recomposites nothing. No channel data is read again.
+//
+// Each channel maps its values to a color through a lookup table (256 or
+// 65536 entries for 8 or 16-bit data), and the channel colors are blended
+// with saturating additive or maximum blending, four pixels at a time with
+// SSE2.
+//
+// Composite tiles are computed on `ThreadPool::Default()` and handed to a
+// callback, typically `UploadScheduler::Enqueue()`; until a new composite
+// arrives the previous one stays on screen.
+//
+// Usage
+// -----
+//    ImGuiImage::ChannelCompositor<uint16_t> compositor(grid, 4,
+//      [&](const ImGuiImage::TileKey& key, int channel, uint16_t* values) {
+//        return ReadChannelTile(key, channel, values);
+//      },
+//      [&](const ImGuiImage::TileKey& key,
+//          std::shared_ptr<const ImGuiImage::TileImage> image) {
+//        scheduler.Enqueue(key, std::move(image));
+//      });
+//    compositor.SetChannel(0, { IM_COL32(0, 0, 255, 255), 100, 4000 });
+//
+//    ...
+//
+//    ImGuiImage::ZoomableTiles(grid, 0, displaySize, &state,
+//      [&](const ImGuiImage::TileKey& key) {
+//        compositor.Request(key);
+//        return atlas.Lookup(key);
+//      });
+//
+
+#ifndef IMGUI_ZOOMABLE_COMPOSITE_H
+#define IMGUI_ZOOMABLE_COMPOSITE_H
+
+#include "imgui_zoomable_tiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Display settings of a channel.
+  //
+  // Members:
+  // - color: Color of the channel at full intensity.
+  // - low, high: Contrast window; values at or below `low` are black and at
+  //              or above `high` full intensity.
+  // - gamma: Exponent applied to the normalized intensity.
+  // - visible: Whether the channel takes part in the composite.
+  struct ChannelSettings
+  {
+    ImU32 color = IM_COL32_WHITE;
+    float low = 0.0f;
+    float high = 255.0f;
+    float gamma = 1.0f;
+    bool visible = true;
+  };
+
+  // How channel colors are combined.
+  enum class ChannelBlend
+  {
+    Additive, // saturating sum, the usual fluorescence look
+    Max,      // per component maximum, keeps colors from washing out
+  };
+
+  // Lookup table mapping every value of `T` (8 or 16-bit unsigned) to the
+  // color of a channel, with a zero alpha so blending keeps the background
+  // alpha.
+  template <typename T>
+  std::vector<ImU32> BuildChannelLut(const ChannelSettings& settings);
+
+  // Blend `count` values through `lut` into `dst` (RGBA pixels).
+  template <typename T>
+  void BlendChannel(
+    const T* values,
+    const ImU32* lut,
+    ChannelBlend blend,
+    std::size_t count,
+    ImU32* dst);
+
+  // Composites the channels of a tiled image on demand.
+  //
+  // `read(key, channel, values)` fills the `TileWidth(key) x
+  // TileHeight(key)` values of one channel of a tile and returns false if
+  // it cannot be read; the tile is then read again by the next `Request()`.
+  // `ready(key, image)` receives new composite tiles.
+  // Both run on the workers of `ThreadPool::Default()` and must be
+  // thread-safe.
+  //
+  // Statistics
+  //
+  // - composited: Composite tiles produced.
+  // - channelReads: Channel tiles read from the source.
+  // - pending: Composite tiles being computed.
+  template <typename T>
+  class ChannelCompositor
+  {
+    static_assert(std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::uint16_t>,
+      "channels must be 8 or 16-bit unsigned integers");
+
+  public:
+    using ReadFn = std::function<bool(const TileKey& key, int channel, T* values)>;
+    using ReadyFn = std::function<void(
+      const TileKey& key, std::shared_ptr<const TileImage> image)>;
+
+    struct Stats
+    {
+      std::uint64_t composited = 0;
+      std::uint64_t channelReads = 0;
+      std::size_t pending = 0;
+    };
+
+    // `cacheCapacity` is the number of raw tiles cached per channel.
+    ChannelCompositor(
+      const TileGrid& grid,
+      int channelCount,
+      ReadFn read,
+      ReadyFn ready,
+      std::size_t cacheCapacity = 256);
+    ~ChannelCompositor();
+
+    ChannelCompositor(const ChannelCompositor&) = delete;
+    ChannelCompositor& operator=(const ChannelCompositor&) = delete;
+
+    int ChannelCount() const;
+    const ChannelSettings& Channel(int channel) const;
+    ChannelBlend Blend() const;
+
+    // Change the settings of a channel or the blending. Composite tiles
+    // affected by the change are recomputed when requested again.
+    void SetChannel(int channel, const ChannelSettings& settings);
+    void SetBlend(ChannelBlend blend);
+
+    // Make sure the composite of `key` is up to date, queueing it if not.
+    // Call it for the visible tiles every frame (e.g. from the lookup
+    // callback of `ZoomableTiles()`). Returns true if it is up to date.
+    bool Request(const TileKey& key);
+
+    // Discard the data of a tile whose channels changed.
+    void Invalidate(const TileKey& key);
+    void Clear();
+
+    Stats GetStats() const;
+
+  private:
+    // Settings as seen by the tasks; a hidden channel has no table.
+    struct Snapshot
+    {
+      std::uint64_t id = 0; // increasing, so late results can be told apart
+      std::vector<std::shared_ptr<const std::vector<ImU32>>> luts;
+      std::vector<std::uint64_t> versions; // per channel (0 = hidden), then blend
+      ChannelBlend blend = ChannelBlend::Additive;
+    };
+
+    struct TileState
+    {
+      std::vector<std::uint64_t> composited; // versions of the last composite
+      std::vector<std::uint64_t> pending;    // versions being computed
+      std::uint64_t compositedId = 0;
+      std::uint64_t dataVersion = 0;
+    };
+
+    // State shared with the background tasks.
+    struct Shared : detail::BackgroundTasks
+    {
+      std::unordered_map<TileKey, TileState, TileKeyHash> tiles;
+      std::vector<std::unique_ptr<TileCache<std::vector<T>>>> channels;
+      std::uint64_t composited = 0;
+      std::uint64_t channelReads = 0;
+    };
+
+    void UpdateSnapshot();
+
+    TileGrid grid_;
+    ReadFn read_;
+    ReadyFn ready_;
+    std::vector<ChannelSettings> settings_;
+    std::vector<std::uint64_t> channelVersions_;
+    std::uint64_t nextVersion_ = 1;
+    std::uint64_t nextSnapshotId_ = 1;
+    ChannelBlend blend_ = ChannelBlend::Additive;
+    std::shared_ptr<const Snapshot> snapshot_;
+    std::shared_ptr<Shared> shared_;
+  };
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  template <typename T>
+  inline std::vector<ImU32> BuildChannelLut(const ChannelSettings& settings)
+  {
+    constexpr std::size_t kSize{ std::size_t{ 1 } << (8 * sizeof(T)) };
+    std::vector<ImU32> lut(kSize);
+    const float range{ settings.high - settings.low };
+    const float r{ static_cast<float>((settings.color >> IM_COL32_R_SHIFT) & 0xFF) };
+    const float g{ static_cast<float>((settings.color >> IM_COL32_G_SHIFT) & 0xFF) };
+    const float b{ static_cast<float>((settings.color >> IM_COL32_B_SHIFT) & 0xFF) };
+    for (std::size_t v = 0; v < kSize; ++v)
+    {
+      float t{ range > 0.0f ? (static_cast<float>(v) - settings.low) / range :
+        (static_cast<float>(v) >= settings.high ? 1.0f : 0.0f) };
+      t = std::clamp(t, 0.0f, 1.0f);
+      if (settings.gamma != 1.0f && t > 0.0f)
+      {
+        t = std::pow(t, settings.gamma);
+      }
+      lut[v] = IM_COL32(
+        static_cast<int>(r * t + 0.5f),
+        static_cast<int>(g * t + 0.5f),
+        static_cast<int>(b * t + 0.5f),
+        0);
+    }
+    return lut;
+  }
+
+  template <typename T>
+  inline void BlendChannel(
+    const T* values,
+    const ImU32* lut,
+    ChannelBlend blend,
+    std::size_t count,
+    ImU32* dst)
+  {
+    std::size_t i{ 0 };
+#ifdef IMGUI_ZOOMABLE_IMAGE_SSE2
+    // SSE2 has no gather: four table loads, then one saturating blend of
+    // four pixels
+    if (blend == ChannelBlend::Additive)
+    {
+      for (; i + 4 <= count; i += 4)
+      {
+        const __m128i colors{ _mm_set_epi32(
+          static_cast<int>(lut[values[i + 3]]), static_cast<int>(lut[values[i + 2]]),
+          static_cast<int>(lut[values[i + 1]]), static_cast<int>(lut[values[i]])) };
+        __m128i* p{ reinterpret_cast<__m128i*>(dst + i) };
+        _mm_storeu_si128(p, _mm_adds_epu8(_mm_loadu_si128(p), colors));
+      }
+    }
+    else
+    {
+      for (; i + 4 <= count; i += 4)
+      {
+        const __m128i colors{ _mm_set_epi32(
+          static_cast<int>(lut[values[i + 3]]), static_cast<int>(lut[values[i + 2]]),
+          static_cast<int>(lut[values[i + 1]]), static_cast<int>(lut[values[i]])) };
+        __m128i* p{ reinterpret_cast<__m128i*>(dst + i) };
+        _mm_storeu_si128(p, _mm_max_epu8(_mm_loadu_si128(p), colors));
+      }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+      const ImU32 color{ lut[values[i]] };
+      const ImU32 current{ dst[i] };
+      ImU32 result{ 0 };
+      for (int shift = 0; shift < 32; shift += 8)
+      {
+        const ImU32 a{ (current >> shift) & 0xFF };
+        const ImU32 c{ (color >> shift) & 0xFF };
+        const ImU32 v{ blend == ChannelBlend::Additive ? std::min<ImU32>(255, a + c) :
+          std::max(a, c) };
+        result |= v << shift;
+      }
+      dst[i] = result;
+    }
+  }
+
+  template <typename T>
+  inline ChannelCompositor<T>::ChannelCompositor(
+    const TileGrid& grid,
+    int channelCount,
+    ReadFn read,
+    ReadyFn ready,
+    std::size_t cacheCapacity)
+    : grid_(grid)
+    , read_(std::move(read))
+    , ready_(std::move(ready))
+    , settings_(static_cast<std::size_t>(std::max(0, channelCount)))
+    , channelVersions_(settings_.size())
+    , shared_(std::make_shared<Shared>())
+  {
+    for (std::size_t c = 0; c < settings_.size(); ++c)
+    {
+      channelVersions_[c] = nextVersion_++;
+      shared_->channels.push_back(
+        std::make_unique<TileCache<std::vector<T>>>(cacheCapacity));
+    }
+    UpdateSnapshot();
+  }
+
+  template <typename T>
+  inline ChannelCompositor<T>::~ChannelCompositor()
+  {
+    shared_->Close();
+  }
+
+  template <typename T>
+  inline int ChannelCompositor<T>::ChannelCount() const
+  {
+    return static_cast<int>(settings_.size());
+  }
+
+  template <typename T>
+  inline const ChannelSettings& ChannelCompositor<T>::Channel(int channel) const
+  {
+    return settings_[static_cast<std::size_t>(channel)];
+  }
+
+  template <typename T>
+  inline ChannelBlend ChannelCompositor<T>::Blend() const
+  {
+    return blend_;
+  }
+
+  template <typename T>
+  inline void ChannelCompositor<T>::SetChannel(int channel, const ChannelSettings& settings)
+  {
+    const std::size_t c{ static_cast<std::size_t>(channel) };
+    ChannelSettings& current{ settings_[c] };
+    if (current.color == settings.color && current.low == settings.low &&
+        current.high == settings.high && current.gamma == settings.gamma &&
+        current.visible == settings.visible)
+    {
+      return;
+    }
+    current = settings;
+    channelVersions_[c] = nextVersion_++;
+    UpdateSnapshot();
+  }
+
+  template <typename T>
+  inline void ChannelCompositor<T>::SetBlend(ChannelBlend blend)
+  {
+    if (blend != blend_)
+    {
+      blend_ = blend;
+      UpdateSnapshot();
+    }
+  }
+
+  template <typename T>
+  inline void ChannelCompositor<T>::UpdateSnapshot()
+  {
+    auto snapshot{ std::make_shared<Snapshot>() };
+    snapshot->id = nextSnapshotId_++;
+    snapshot->blend = blend_;
+    for (std::size_t c = 0; c < settings_.size(); ++c)
+    {
+      if (!settings_[c].visible)
+      { // edits of hidden channels do not change any composite
+        snapshot->luts.push_back(nullptr);
+        snapshot->versions.push_back(0);
+        continue;
+      }
+      // the tables of unchanged channels are shared with the last snapshot
+      const bool unchanged{ snapshot_ != nullptr &&
+        snapshot_->versions[c] == channelVersions_[c] };
+      snapshot->luts.push_back(unchanged ? snapshot_->luts[c] :
+        std::make_shared<const std::vector<ImU32>>(BuildChannelLut<T>(settings_[c])));
+      snapshot->versions.push_back(channelVersions_[c]);
+    }
+    snapshot->versions.push_back(static_cast<std::uint64_t>(blend_));
+    snapshot_ = std::move(snapshot);
+  }
+
+  template <typename T>
+  inline bool ChannelCompositor<T>::Request(const TileKey& key)
+  {
+    std::uint64_t dataVersion;
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      TileState& tile{ shared_->tiles[key] };
+      if (tile.composited == snapshot_->versions)
+      {
+        return true;
+      }
+      if (tile.pending == snapshot_->versions)
+      {
+        return false;
+      }
+      tile.pending = snapshot_->versions;
+      dataVersion = tile.dataVersion;
+    }
+
+    ThreadPool::Default().Submit(0,
+      [shared = shared_, snapshot = snapshot_, read = &read_, ready = &ready_,
+       key, dataVersion, width = grid_.TileWidth(key),
+       height = grid_.TileHeight(key)] {
+        if (!shared->Begin([&] {
+          const TileState& state{ shared->tiles[key] };
+          return state.pending != snapshot->versions || state.dataVersion != dataVersion;
+        }))
+        { // superseded while queued
+          return;
+        }
+
+        const std::size_t count{ static_cast<std::size_t>(width) * height };
+        auto image{ std::make_shared<TileImage>() };
+        image->width = width;
+        image->height = height;
+        image->pixels.assign(count, IM_COL32(0, 0, 0, 255));
+        std::uint64_t reads{ 0 };
+        bool failed{ false };
+        for (std::size_t c = 0; c < snapshot->luts.size(); ++c)
+        {
+          if (snapshot->luts[c] == nullptr)
+          {
+            continue;
+          }
+          TileCache<std::vector<T>>& cache{ *shared->channels[c] };
+          std::shared_ptr<const std::vector<T>> values{ cache.Find(key) };
+          if (values == nullptr)
+          {
+            auto data{ std::make_shared<std::vector<T>>(count) };
+            if (!(*read)(key, static_cast<int>(c), data->data()))
+            {
+              failed = true;
+              break;
+            }
+            ++reads;
+            values = data;
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            if (shared->tiles[key].dataVersion == dataVersion)
+            { // not invalidated while reading
+              cache.Insert(key, values);
+            }
+          }
+          BlendChannel(values->data(), snapshot->luts[c]->data(), snapshot->blend,
+            count, image->pixels.data());
+        }
+
+        shared->End([&] {
+          TileState& state{ shared->tiles[key] };
+          shared->channelReads += reads;
+          if (state.dataVersion != dataVersion)
+          {
+            return false;
+          }
+          if (state.pending == snapshot->versions)
+          { // a failed read is retried by the next request
+            state.pending.clear();
+          }
+          if (failed || state.compositedId >= snapshot->id)
+          { // failed, or a task started later finished first
+            return false;
+          }
+          state.composited = snapshot->versions;
+          state.compositedId = snapshot->id;
+          ++shared->composited;
+          return true;
+        },
+        [&] { (*ready)(key, std::move(image)); });
+      });
+    return false;
+  }
+
+  template <typename T>
+  inline void ChannelCompositor<T>::Invalidate(const TileKey& key)
+  {
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      TileState& tile{ shared_->tiles[key] };
+      ++tile.dataVersion;
+      tile.composited.clear();
+      tile.pending.clear();
+      tile.compositedId = 0;
+    }
+    for (auto& cache : shared_->channels)
+    {
+      cache->Erase(key);
+    }
+  }
+
+  template <typename T>
+  inline void ChannelCompositor<T>::Clear()
+  {
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      for (auto& [key, tile] : shared_->tiles)
+      {
+        ++tile.dataVersion;
+        tile.composited.clear();
+        tile.pending.clear();
+        tile.compositedId = 0;
+      }
+    }
+    for (auto& cache : shared_->channels)
+    {
+      cache->Clear();
+    }
+  }
+
+  template <typename T>
+  inline typename ChannelCompositor<T>::Stats ChannelCompositor<T>::GetStats() const
+  {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    Stats stats;
+    stats.composited = shared_->composited;
+    stats.channelReads = shared_->channelReads;
+    for (const auto& [key, tile] : shared_->tiles)
+    {
+      stats.pending += tile.pending.empty() ? 0 : 1;
+    }
+    return stats;
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_COMPOSITE_H
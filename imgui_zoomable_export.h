@@ -0,0 +1,400 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Export
+// =============================
+// Export of the region shown by a widget, at native resolution or at a
+// chosen scale, from the CPU-side image or its tile pyramid.
+//
+// The region is streamed: source rows are read in order, resampled in
+// parallel strips (see `imgui_zoomable_resample.h`) and written out row by
+// row, so exporting a 20k x 20k crop needs a few strips of memory, not the
+// whole crop.
+//
+// Usage
+// -----
+//    // from pixels in memory
+//    ImGuiImage::ExportOptions options;
+//    options.scale = 0.5f;
+//    ImGuiImage::ExportViewToBmp("view.bmp", state,
+//      ImGuiImage::ImageRowReader{ pixels, width, width }, options);
+//
+//    // from a tiled source, decoding tiles as rows are needed
+//    ImGuiImage::ExportViewToBmp("slice.bmp", state,
+//      ImGuiImage::TileRowReader(volume.Grid(), slice,
+//        [&](const ImGuiImage::TileKey& key, ImGuiImage::TileImage* tile) {
+//          volume.DecodeTile(key, tile);
+//        }));
+//
+
+#ifndef IMGUI_ZOOMABLE_EXPORT_H
+#define IMGUI_ZOOMABLE_EXPORT_H
+
+#include "imgui_zoomable_resample.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Export options.
+  //
+  // Members:
+  // - scale: Output pixels per image pixel (1 = native resolution).
+  // - filter: Resampling filter used when `scale` is not 1.
+  // - stripRows: Output rows processed together; bounds the memory used.
+  // - parallel: Resample on the shared `ThreadPool`.
+  struct ExportOptions
+  {
+    float scale = 1.0f;
+    ResampleFilter filter = ResampleFilter::Area;
+    int stripRows = 64;
+    bool parallel = true;
+  };
+
+  // Image rectangle [x0, x1) x [y0, y1) shown by a widget using `state`
+  // (see `GetVisibleRect()`), grown to whole pixels.
+  IMGUI_API void GetExportRect(
+    const State& state, int* x0, int* y0, int* x1, int* y1);
+
+  // Size of the exported image of a rectangle.
+  IMGUI_API void GetExportSize(
+    int x0, int y0, int x1, int y1,
+    const ExportOptions& options,
+    int* width,
+    int* height);
+
+  // Export the rectangle [x0, x1) x [y0, y1) of an image of `imageWidth` x
+  // `imageHeight` pixels. `readRow(int y, int x0, int x1, ImU32* dst)`
+  // provides the source pixels and `writeRow(int y, const ImU32* row)`
+  // receives the output rows in order (see `ResampleRows()`). Returns false
+  // if the rectangle is empty.
+  template <typename ReadRowFn, typename WriteRowFn>
+  bool ExportRegion(
+    int imageWidth,
+    int imageHeight,
+    int x0,
+    int y0,
+    int x1,
+    int y1,
+    const ExportOptions& options,
+    ReadRowFn&& readRow,
+    WriteRowFn&& writeRow);
+
+  // Export the region shown by a widget using `state` to a BMP file.
+  // `state.textureSize` gives the image size.
+  template <typename ReadRowFn>
+  bool ExportViewToBmp(
+    const char* path,
+    const State& state,
+    ReadRowFn&& readRow,
+    const ExportOptions& options = ExportOptions());
+
+  // Rows of an RGBA image in memory (`stride` in pixels), as a `readRow`
+  // callback.
+  struct ImageRowReader
+  {
+    const ImU32* pixels = nullptr;
+    int width = 0;
+    int stride = 0;
+
+    void operator()(int y, int x0, int x1, ImU32* dst) const;
+  };
+
+  // Rows of a layer of a tiled image at full resolution, as a `readRow`
+  // callback. `decode(const TileKey&, TileImage*)` produces a level 0 tile
+  // (e.g. `VolumeSource::DecodeTile()`); the tiles of one tile row are
+  // decoded in parallel when the rows reach them, and only that tile row
+  // is kept in memory.
+  template <typename DecodeFn>
+  class TileRowReader
+  {
+  public:
+    TileRowReader(const TileGrid& grid, int layer, DecodeFn decode);
+
+    void operator()(int y, int x0, int x1, ImU32* dst);
+
+  private:
+    TileGrid grid_;
+    int layer_;
+    DecodeFn decode_;
+    int tileRow_ = -1;
+    int firstTile_ = 0;
+    std::vector<TileImage> tiles_;
+  };
+
+  // Streaming writer of 24-bit BMP files, top row first.
+  class BmpWriter
+  {
+  public:
+    BmpWriter() = default;
+    ~BmpWriter();
+
+    BmpWriter(const BmpWriter&) = delete;
+    BmpWriter& operator=(const BmpWriter&) = delete;
+
+    // Create the file and write the header.
+    bool Open(const char* path, int width, int height);
+
+    // Append the next row (`width` RGBA pixels, alpha is dropped).
+    bool WriteRow(const ImU32* row);
+
+    // Close the file. Returns false if writing failed or rows are missing.
+    bool Close();
+
+  private:
+    std::FILE* file_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+    int rowsWritten_ = 0;
+    bool failed_ = false;
+    std::vector<std::uint8_t> row_;
+  };
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  inline void GetExportRect(
+    const State& state, int* x0, int* y0, int* x1, int* y1)
+  {
+    ImVec2 min, max;
+    GetVisibleRect(state, state.view, &min, &max);
+    *x0 = static_cast<int>(std::floor(min.x));
+    *y0 = static_cast<int>(std::floor(min.y));
+    *x1 = static_cast<int>(std::ceil(max.x));
+    *y1 = static_cast<int>(std::ceil(max.y));
+  }
+
+  inline void GetExportSize(
+    int x0, int y0, int x1, int y1,
+    const ExportOptions& options,
+    int* width,
+    int* height)
+  {
+    const float scale{ options.scale > 0.0f ? options.scale : 1.0f };
+    *width = std::max(0, static_cast<int>(std::lround((x1 - x0) * scale)));
+    *height = std::max(0, static_cast<int>(std::lround((y1 - y0) * scale)));
+  }
+
+  template <typename ReadRowFn, typename WriteRowFn>
+  inline bool ExportRegion(
+    int imageWidth,
+    int imageHeight,
+    int x0,
+    int y0,
+    int x1,
+    int y1,
+    const ExportOptions& options,
+    ReadRowFn&& readRow,
+    WriteRowFn&& writeRow)
+  {
+    x0 = std::clamp(x0, 0, imageWidth);
+    x1 = std::clamp(x1, 0, imageWidth);
+    y0 = std::clamp(y0, 0, imageHeight);
+    y1 = std::clamp(y1, 0, imageHeight);
+    int width, height;
+    GetExportSize(x0, y0, x1, y1, options, &width, &height);
+    if (width <= 0 || height <= 0)
+    {
+      return false;
+    }
+    // at native resolution the filter only copies pixels
+    const ResampleFilter filter{ width == x1 - x0 && height == y1 - y0 ?
+      ResampleFilter::Nearest : options.filter };
+    ResampleRows(imageWidth, imageHeight,
+      ImVec2(static_cast<float>(x0), static_cast<float>(y0)),
+      ImVec2(static_cast<float>(x1), static_cast<float>(y1)),
+      width, height, filter, readRow, writeRow,
+      options.stripRows, options.parallel);
+    return true;
+  }
+
+  template <typename ReadRowFn>
+  inline bool ExportViewToBmp(
+    const char* path,
+    const State& state,
+    ReadRowFn&& readRow,
+    const ExportOptions& options)
+  {
+    int x0, y0, x1, y1;
+    GetExportRect(state, &x0, &y0, &x1, &y1);
+    const int imageWidth{ static_cast<int>(state.textureSize.x) };
+    const int imageHeight{ static_cast<int>(state.textureSize.y) };
+    x0 = std::clamp(x0, 0, imageWidth);
+    x1 = std::clamp(x1, 0, imageWidth);
+    y0 = std::clamp(y0, 0, imageHeight);
+    y1 = std::clamp(y1, 0, imageHeight);
+
+    int width, height;
+    GetExportSize(x0, y0, x1, y1, options, &width, &height);
+    BmpWriter writer;
+    if (width <= 0 || height <= 0 || !writer.Open(path, width, height))
+    {
+      return false;
+    }
+    ExportRegion(imageWidth, imageHeight, x0, y0, x1, y1, options, readRow,
+      [&](int, const ImU32* row) { writer.WriteRow(row); });
+    return writer.Close();
+  }
+
+  inline void ImageRowReader::operator()(int y, int x0, int x1, ImU32* dst) const
+  {
+    std::memcpy(dst, pixels + static_cast<std::size_t>(y) * stride + x0,
+      static_cast<std::size_t>(x1 - x0) * sizeof(ImU32));
+  }
+
+  template <typename DecodeFn>
+  inline TileRowReader<DecodeFn>::TileRowReader(
+    const TileGrid& grid, int layer, DecodeFn decode)
+    : grid_(grid)
+    , layer_(layer)
+    , decode_(std::move(decode))
+  {
+  }
+
+  template <typename DecodeFn>
+  inline void TileRowReader<DecodeFn>::operator()(int y, int x0, int x1, ImU32* dst)
+  {
+    const int size{ grid_.tileSize };
+    const int tileRow{ y / size };
+    const int tile0{ x0 / size };
+    const int tile1{ (x1 + size - 1) / size };
+    if (tileRow != tileRow_ || tile0 < firstTile_ ||
+        tile1 > firstTile_ + static_cast<int>(tiles_.size()))
+    { // decode the tiles of the new tile row, in parallel
+      tileRow_ = tileRow;
+      firstTile_ = tile0;
+      tiles_.assign(static_cast<std::size_t>(tile1 - tile0), TileImage());
+      ParallelFor(tile0, tile1, [&](int x) {
+        decode_(TileKey{ layer_, 0, x, tileRow }, &tiles_[x - tile0]);
+      });
+    }
+
+    const int ty{ y - tileRow * size };
+    for (int x = x0; x < x1;)
+    {
+      const TileImage& tile{ tiles_[x / size - firstTile_] };
+      const int tx{ x - (x / size) * size };
+      const int n{ std::min(x1 - x, size - tx) };
+      if (ty < tile.height && tx + n <= tile.width)
+      {
+        std::memcpy(dst + (x - x0),
+          tile.pixels.data() + static_cast<std::size_t>(ty) * tile.width + tx,
+          static_cast<std::size_t>(n) * sizeof(ImU32));
+      }
+      else
+      { // tile not available
+        std::fill(dst + (x - x0), dst + (x - x0) + n, 0u);
+      }
+      x += n;
+    }
+  }
+
+  inline BmpWriter::~BmpWriter()
+  {
+    if (file_ != nullptr)
+    {
+      std::fclose(file_);
+    }
+  }
+
+  inline bool BmpWriter::Open(const char* path, int width, int height)
+  {
+    if (file_ != nullptr || width <= 0 || height <= 0)
+    {
+      return false;
+    }
+    file_ = std::fopen(path, "wb");
+    if (file_ == nullptr)
+    {
+      return false;
+    }
+    width_ = width;
+    height_ = height;
+    rowsWritten_ = 0;
+    failed_ = false;
+    row_.assign((static_cast<std::size_t>(width) * 3 + 3) & ~std::size_t{ 3 }, 0);
+
+    const std::uint64_t imageSize{ static_cast<std::uint64_t>(row_.size()) * height };
+    const std::uint32_t fileSize{ static_cast<std::uint32_t>(
+      std::min<std::uint64_t>(54 + imageSize, 0xFFFFFFFFu)) };
+    std::uint8_t header[54]{};
+    auto put16 = [&](int offset, std::uint32_t v) {
+      header[offset] = static_cast<std::uint8_t>(v);
+      header[offset + 1] = static_cast<std::uint8_t>(v >> 8);
+    };
+    auto put32 = [&](int offset, std::uint32_t v) {
+      put16(offset, v & 0xFFFF);
+      put16(offset + 2, v >> 16);
+    };
+    header[0] = 'B';
+    header[1] = 'M';
+    put32(2, fileSize);
+    put32(10, 54);                                         // pixel data offset
+    put32(14, 40);                                         // info header size
+    put32(18, static_cast<std::uint32_t>(width));
+    put32(22, static_cast<std::uint32_t>(-height));        // top-down rows
+    put16(26, 1);                                          // planes
+    put16(28, 24);                                         // bits per pixel
+    put32(34, static_cast<std::uint32_t>(
+      std::min<std::uint64_t>(imageSize, 0xFFFFFFFFu)));
+    put32(38, 2835);                                       // 72 dpi
+    put32(42, 2835);
+    failed_ = std::fwrite(header, sizeof(header), 1, file_) != 1;
+    return !failed_;
+  }
+
+  inline bool BmpWriter::WriteRow(const ImU32* row)
+  {
+    if (file_ == nullptr || failed_ || rowsWritten_ >= height_)
+    {
+      return false;
+    }
+    for (int x = 0; x < width_; ++x)
+    { // BMP stores B, G, R
+      const ImU32 pixel{ row[x] };
+      row_[3 * x + 0] = static_cast<std::uint8_t>(pixel >> 16);
+      row_[3 * x + 1] = static_cast<std::uint8_t>(pixel >> 8);
+      row_[3 * x + 2] = static_cast<std::uint8_t>(pixel);
+    }
+    failed_ = std::fwrite(row_.data(), row_.size(), 1, file_) != 1;
+    ++rowsWritten_;
+    return !failed_;
+  }
+
+  inline bool BmpWriter::Close()
+  {
+    if (file_ == nullptr)
+    {
+      return false;
+    }
+    const bool ok{ std::fclose(file_) == 0 && !failed_ && rowsWritten_ == height_ };
+    file_ = nullptr;
+    return ok;
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_EXPORT_H
@@ -72,6 +72,13 @@
 // - Left Mouse Button Drag: Pan the image when zoomed in.
 // - Double Click: Reset zoom and pan to default.
 //
+// Frame Timing
+// ------------
+// For live images, set `State::frameId` and `State::frameTimestamp` (capture
+// time on the `ImGuiImage::Clock()` timeline) whenever a new frame is passed
+// to the widget. `State::frameStats` then reports capture-to-display latency
+// percentiles and the number of frames that were never drawn.
+//
 // Requirements
 // ------------
 // - Dear ImGui v1.92.5 or later. Most like works with earlier versions too but
@@ -93,8 +100,12 @@
 
 #include <limits>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <cmath>
+#include <cstddef>
+#include <type_traits>
 
 // Library Version
 // ===============
@@ -106,6 +117,156 @@
 // ----------------------------------- Interface ------------------------------
 namespace ImGuiImage
 {
+  // Seconds on a monotonic clock. Frame capture timestamps passed in
+  // `State::frameTimestamp` must use this timeline.
+  IMGUI_API double Clock();
+
+  // Frame timing statistics, updated by the widget when `State::frameId`
+  // changes. All durations are in seconds.
+  //
+  // The display time of a frame is when the widget first submits it for
+  // drawing; the GPU and the compositor add their own (roughly constant)
+  // delay on top of it.
+  //
+  // Members:
+  // - framesShown: Number of distinct frames drawn.
+  // - framesDropped: Number of frames never drawn, counted from gaps in the
+  //                  frame ids.
+  // - latencyLast: Capture-to-display latency of the current frame.
+  // - latencyP50, latencyP95, latencyP99, latencyMax: Latency percentiles
+  //                  and maximum over the last `kWindow` frames.
+  // - lastDisplayDuration: How long the previous frame stayed on screen
+  //                  before being replaced.
+  struct FrameStats
+  {
+    static constexpr int kWindow = 256;
+
+    std::uint64_t framesShown = 0;
+    std::uint64_t framesDropped = 0;
+    float latencyLast = 0.0f;
+    float latencyP50 = 0.0f;
+    float latencyP95 = 0.0f;
+    float latencyP99 = 0.0f;
+    float latencyMax = 0.0f;
+    float lastDisplayDuration = 0.0f;
+
+    // Bookkeeping
+    std::uint64_t lastFrameId = 0;
+    double firstDrawnTime = 0.0;
+    float samples[kWindow] = {};
+    int sampleCount = 0;
+    int nextSample = 0;
+  };
+
+  // Affine map between two 2D coordinate systems:
+  //
+  //    x' = xx * x + xy * y + x0
+  //    y' = yx * x + yy * y + y0
+  //
+  // Coefficients are kept in double precision, so large images can be
+  // mapped without losing sub-pixel accuracy. The bulk `Apply()` overloads
+  // convert arrays of points stored as `ImVec2`, as interleaved x, y pairs
+  // (AoS) or as separate x and y arrays (SoA), of floats or doubles; the
+  // output may alias the input.
+  struct AffineTransform
+  {
+    double xx = 1.0, xy = 0.0, x0 = 0.0;
+    double yx = 0.0, yy = 1.0, y0 = 0.0;
+
+    ImVec2 Apply(const ImVec2& point) const;
+
+    void Apply(const ImVec2* points, std::size_t count, ImVec2* out) const;
+
+    template <typename T>
+    void Apply(const T* points, std::size_t count, T* out) const;
+
+    template <typename T>
+    void Apply(const T* x, const T* y, std::size_t count, T* outX, T* outY) const;
+
+    // Map that undoes this one.
+    AffineTransform Inverse() const;
+
+    // Map applying this one, then `next`.
+    AffineTransform Then(const AffineTransform& next) const;
+  };
+
+  // View transform
+  // ==============
+  // Describes how image pixels map to screen coordinates for the current
+  // frame. The widget computes it from the `State` and the layout of the
+  // display area, hands it to custom draw callbacks (see `ZoomableCustom()`)
+  // so they can place content in image coordinates, and stores it in
+  // `State::view` for code running after the widget.
+  //
+  // Members:
+  // - screenPos: Screen position of the top-left corner of the display area.
+  // - displaySize: Size of the display area in screen pixels.
+  // - textureSize: Size of the image in pixels.
+  // - uvOffset: Normalized image coordinate shown at the top-left corner of
+  //             the display area (same as `State::panOffset`).
+  // - uvScale: Normalized image extent covered by the display area (same as
+  //            `1 / State::zoomLevel`).
+  // - rotation, flipHorizontal, flipVertical: View orientation (same as in
+  //            `State`).
+  //
+  // The view is laid out in a "frame": the display area before rotation,
+  // with its width and height swapped for odd quarter turns. Frame
+  // coordinates are normalized to [0, 1] and map linearly to image UVs
+  // (`uv = uvOffset + frame * uvScale`); the frame is then flipped and
+  // rotated around the center of the display area.
+  struct ViewTransform
+  {
+    ImVec2 screenPos = ImVec2(0.0f, 0.0f);
+    ImVec2 displaySize = ImVec2(0.0f, 0.0f);
+    ImVec2 textureSize = ImVec2(0.0f, 0.0f);
+    ImVec2 uvOffset = ImVec2(0.0f, 0.0f);
+    float uvScale = 1.0f;
+    float rotation = 0.0f;
+    bool flipHorizontal = false;
+    bool flipVertical = false;
+
+    // Whether the view is neither rotated nor flipped.
+    bool IsIdentityOrientation() const;
+
+    // Whether the image edges are parallel to the display edges.
+    bool IsAxisAligned() const;
+
+    // Size of the frame in screen pixels.
+    ImVec2 FrameSize() const;
+
+    // Map normalized frame coordinates to screen coordinates, and back.
+    ImVec2 FrameToScreen(const ImVec2& framePoint) const;
+    ImVec2 ScreenToFrame(const ImVec2& screenPoint) const;
+
+    // Screen pixels per image pixel along each image axis.
+    ImVec2 Scale() const;
+
+    // Map a point in image pixels to screen coordinates.
+    ImVec2 ImageToScreen(const ImVec2& imagePoint) const;
+
+    // Map a point in screen coordinates to image pixels. The result is not
+    // clamped to the image bounds.
+    ImVec2 ScreenToImage(const ImVec2& screenPoint) const;
+
+    // Rectangle of the image (in pixels) visible in the display area,
+    // clamped to the image bounds. With arbitrary rotations this is the
+    // bounding box of the visible area.
+    void VisibleImageRect(ImVec2* min, ImVec2* max) const;
+
+    // Cosine and sine of the rotation, exact for multiples of 90 degrees.
+    void RotationCosSin(float* c, float* s) const;
+
+    // The mappings above as affine transforms, for converting many points
+    // at once (see `AffineTransform::Apply()`). UV coordinates are
+    // normalized image coordinates, from (0, 0) to (1, 1).
+    AffineTransform ImageToScreenTransform() const;
+    AffineTransform ScreenToImageTransform() const;
+    AffineTransform UVToScreenTransform() const;
+    AffineTransform ScreenToUVTransform() const;
+    AffineTransform ImageToUVTransform() const;
+    AffineTransform UVToImageTransform() const;
+  };
+
   // Structure to hold the state of the zoomable image widget.
   // You can create an instance of this structure and pass it to the
   // `Zoomable()` function to maintain the zoom and pan state across frames.
@@ -120,11 +281,29 @@ namespace ImGuiImage
   //                  the original size of the image in pixels. If not set,
   //                  the widget will attempt to infer the size from the
   //                  displayed image size and UV coordinates.
+  //   - rotation: Clockwise rotation of the view in degrees. Multiples of 90
+  //               swap the display aspect ratio; other angles rotate the
+  //               image within the display area and clip it.
+  //   - flipHorizontal, flipVertical: Mirror the image before rotating it.
+  //               Orientation only changes the drawn geometry, the texture
+  //               is left untouched.
+  //   - frameId: Sequence number of the frame being displayed, increasing by
+  //              one per captured frame (0 = frame timing disabled).
+  //   - frameTimestamp: Capture time of the frame, in `Clock()` seconds.
   // - Outputs (set by the widget):
   //   - zoomLevel: Current zoom level (1.0 = 100%).
   //   - panOffset: Current pan offset in normalized coordinates (-1.0 to 1.0).
   //   - mousePosition: Current mouse position within the image area, or NaN if
   //                    the mouse is outside the image area.
+  //   - frameStats: Latency and dropped frame statistics (see `FrameStats`).
+  //   - view: View transform of the last frame drawn (see `ViewTransform`),
+  //           to map overlay and measurement points without re-deriving the
+  //           widget layout. Set when the mouse handling runs, so it is not
+  //           updated without a state.
+  // - Per frame (cleared by the widget at the end of each frame):
+  //   - zoomPanSuspended: Skip zooming and panning for this frame, e.g. set
+  //                       from the draw callback of `ZoomableCustom()` by an
+  //                       overlay handling a drag itself (see `DrawMinimap()`).
   struct State
   {
     // User Inputs
@@ -132,11 +311,21 @@ namespace ImGuiImage
     bool maintainAspectRatio = false;
     float maxZoomLevel = 0.0f;
     ImVec2 textureSize = ImVec2(0.0f, 0.0f);
+    float rotation = 0.0f;
+    bool flipHorizontal = false;
+    bool flipVertical = false;
+    std::uint64_t frameId = 0;
+    double frameTimestamp = 0.0;
+
+    // Per frame
+    bool zoomPanSuspended = false;
 
     // Outputs
     float zoomLevel = 1.0f;
     ImVec2 panOffset = ImVec2(0.0f, 0.0f);
     ImVec2 mousePosition = ImVec2(0.0f, 0.0f);
+    FrameStats frameStats;
+    ViewTransform view;
   };
 
   // Default values for the Zoomable function parameters
@@ -192,6 +381,37 @@ namespace ImGuiImage
     const ImVec4& bgColor,
     const ImVec4& tintColor,
     State* state = nullptr);
+
+  // Rectangle of the image (in pixels) shown by a widget using `state`,
+  // derived from `State::zoomLevel`, `State::panOffset` and
+  // `State::textureSize` only. It does not need the widget layout, so it can
+  // be used before drawing (e.g. to only prepare the pixels that will be
+  // visible). With rotations other than multiples of 90 degrees it misses
+  // the parts of the image shown in the corners of the display area; use
+  // the overload below then.
+  IMGUI_API void GetVisibleRect(const State& state, ImVec2* min, ImVec2* max);
+
+  // Same as above with the widget laid out as in `view` (usually
+  // `State::view`, set by the last frame drawn): the bounding box of the
+  // image under the whole display area, for any orientation. Falls back to
+  // the overload above until the widget has been drawn.
+  IMGUI_API void GetVisibleRect(
+    const State& state, const ViewTransform& view, ImVec2* min, ImVec2* max);
+
+  // Custom drawing
+  // ==============
+  // Same as `Zoomable()`, but instead of drawing a single texture the widget
+  // invokes `draw(ImDrawList* drawList, const ViewTransform& view)` once the
+  // display area is laid out. The callback is responsible for emitting the
+  // image content, and zooming, panning and mouse tracking work as usual.
+  //
+  // Since there is no texture to infer it from, `State::textureSize` should
+  // be set; otherwise the display size is used as the image size.
+  template <typename DrawFn>
+  void ZoomableCustom(
+    const ImVec2& displaySize,
+    State* state,
+    DrawFn&& draw);
 }
 
 // ----------------------------------- Implementation -------------------------
@@ -217,6 +437,527 @@ namespace ImGuiImage
       kDefaultBackgroundColor, kDefaultTintColor, state);
   }
 
+  namespace detail
+  {
+    // Layout of `view` with the current zoom, pan and orientation of `state`.
+    inline ViewTransform CurrentView(const State& state, const ViewTransform& view)
+    {
+      ViewTransform current{ view };
+      current.uvOffset = state.panOffset;
+      current.uvScale = 1.0f / (state.zoomLevel > 1.0f ? state.zoomLevel : 1.0f);
+      current.rotation = state.rotation;
+      current.flipHorizontal = state.flipHorizontal;
+      current.flipVertical = state.flipVertical;
+      return current;
+    }
+
+    // Number of clockwise quarter turns closest to `degrees`, in [0, 3].
+    inline int QuarterTurns(float degrees)
+    {
+      const int turns{ static_cast<int>(std::lround(degrees / 90.0f)) % 4 };
+      return turns < 0 ? turns + 4 : turns;
+    }
+  } // namespace detail
+
+  inline bool ViewTransform::IsIdentityOrientation() const
+  {
+    return !flipHorizontal && !flipVertical && IsAxisAligned() &&
+      detail::QuarterTurns(rotation) == 0;
+  }
+
+  inline bool ViewTransform::IsAxisAligned() const
+  {
+    return std::fmod(rotation, 90.0f) == 0.0f;
+  }
+
+  inline void ViewTransform::RotationCosSin(float* c, float* s) const
+  {
+    if (IsAxisAligned())
+    {
+      constexpr float kCos[4]{ 1.0f, 0.0f, -1.0f, 0.0f };
+      constexpr float kSin[4]{ 0.0f, 1.0f, 0.0f, -1.0f };
+      const int turns{ detail::QuarterTurns(rotation) };
+      *c = kCos[turns];
+      *s = kSin[turns];
+      return;
+    }
+    const float radians{ rotation * 3.14159265358979f / 180.0f };
+    *c = std::cos(radians);
+    *s = std::sin(radians);
+  }
+
+  inline ImVec2 ViewTransform::FrameSize() const
+  {
+    return (detail::QuarterTurns(rotation) & 1) != 0 ?
+      ImVec2(displaySize.y, displaySize.x) : displaySize;
+  }
+
+  inline ImVec2 ViewTransform::FrameToScreen(const ImVec2& framePoint) const
+  {
+    const ImVec2 frameSize{ FrameSize() };
+    const float fx{ flipHorizontal ? 1.0f - framePoint.x : framePoint.x };
+    const float fy{ flipVertical ? 1.0f - framePoint.y : framePoint.y };
+    const float x{ (fx - 0.5f) * frameSize.x };
+    const float y{ (fy - 0.5f) * frameSize.y };
+    float c, s;
+    RotationCosSin(&c, &s);
+    // clockwise on screen, where y points down
+    return ImVec2(
+      screenPos.x + displaySize.x * 0.5f + x * c - y * s,
+      screenPos.y + displaySize.y * 0.5f + x * s + y * c);
+  }
+
+  inline ImVec2 ViewTransform::ScreenToFrame(const ImVec2& screenPoint) const
+  {
+    const ImVec2 frameSize{ FrameSize() };
+    const float dx{ screenPoint.x - screenPos.x - displaySize.x * 0.5f };
+    const float dy{ screenPoint.y - screenPos.y - displaySize.y * 0.5f };
+    float c, s;
+    RotationCosSin(&c, &s);
+    const float fx{ (dx * c + dy * s) / frameSize.x + 0.5f };
+    const float fy{ (-dx * s + dy * c) / frameSize.y + 0.5f };
+    return ImVec2(
+      flipHorizontal ? 1.0f - fx : fx,
+      flipVertical ? 1.0f - fy : fy);
+  }
+
+  inline ImVec2 ViewTransform::Scale() const
+  {
+    const ImVec2 frameSize{ FrameSize() };
+    return ImVec2(
+      frameSize.x / (textureSize.x * uvScale),
+      frameSize.y / (textureSize.y * uvScale));
+  }
+
+  inline ImVec2 ViewTransform::ImageToScreen(const ImVec2& imagePoint) const
+  {
+    return FrameToScreen(ImVec2(
+      (imagePoint.x / textureSize.x - uvOffset.x) / uvScale,
+      (imagePoint.y / textureSize.y - uvOffset.y) / uvScale));
+  }
+
+  inline ImVec2 ViewTransform::ScreenToImage(const ImVec2& screenPoint) const
+  {
+    const ImVec2 f{ ScreenToFrame(screenPoint) };
+    return ImVec2(
+      (uvOffset.x + f.x * uvScale) * textureSize.x,
+      (uvOffset.y + f.y * uvScale) * textureSize.y);
+  }
+
+  inline ImVec2 AffineTransform::Apply(const ImVec2& point) const
+  {
+    const double x{ point.x };
+    const double y{ point.y };
+    return ImVec2(
+      static_cast<float>(xx * x + xy * y + x0),
+      static_cast<float>(yx * x + yy * y + y0));
+  }
+
+  inline void AffineTransform::Apply(const ImVec2* points, std::size_t count, ImVec2* out) const
+  {
+    static_assert(sizeof(ImVec2) == 2 * sizeof(float), "ImVec2 must be two packed floats");
+    Apply(reinterpret_cast<const float*>(points), count, reinterpret_cast<float*>(out));
+  }
+
+  template <typename T>
+  inline void AffineTransform::Apply(const T* points, std::size_t count, T* out) const
+  {
+    static_assert(std::is_floating_point_v<T>, "coordinates must be float or double");
+    // plain loops over local coefficients vectorize; the inputs are read
+    // before writing so `out` may alias `points`
+    const double cxx{ xx }, cxy{ xy }, cx0{ x0 };
+    const double cyx{ yx }, cyy{ yy }, cy0{ y0 };
+    for (std::size_t i = 0; i < 2 * count; i += 2)
+    {
+      const double x{ points[i] };
+      const double y{ points[i + 1] };
+      out[i] = static_cast<T>(cxx * x + cxy * y + cx0);
+      out[i + 1] = static_cast<T>(cyx * x + cyy * y + cy0);
+    }
+  }
+
+  template <typename T>
+  inline void AffineTransform::Apply(
+    const T* x,
+    const T* y,
+    std::size_t count,
+    T* outX,
+    T* outY) const
+  {
+    static_assert(std::is_floating_point_v<T>, "coordinates must be float or double");
+    const double cxx{ xx }, cxy{ xy }, cx0{ x0 };
+    const double cyx{ yx }, cyy{ yy }, cy0{ y0 };
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      const double px{ x[i] };
+      const double py{ y[i] };
+      outX[i] = static_cast<T>(cxx * px + cxy * py + cx0);
+      outY[i] = static_cast<T>(cyx * px + cyy * py + cy0);
+    }
+  }
+
+  inline AffineTransform AffineTransform::Inverse() const
+  {
+    const double det{ xx * yy - xy * yx };
+    const double inv{ det != 0.0 ? 1.0 / det : 0.0 };
+    AffineTransform r;
+    r.xx = yy * inv;
+    r.xy = -xy * inv;
+    r.yx = -yx * inv;
+    r.yy = xx * inv;
+    r.x0 = -(r.xx * x0 + r.xy * y0);
+    r.y0 = -(r.yx * x0 + r.yy * y0);
+    return r;
+  }
+
+  inline AffineTransform AffineTransform::Then(const AffineTransform& next) const
+  {
+    AffineTransform r;
+    r.xx = next.xx * xx + next.xy * yx;
+    r.xy = next.xx * xy + next.xy * yy;
+    r.x0 = next.xx * x0 + next.xy * y0 + next.x0;
+    r.yx = next.yx * xx + next.yy * yx;
+    r.yy = next.yx * xy + next.yy * yy;
+    r.y0 = next.yx * x0 + next.yy * y0 + next.y0;
+    return r;
+  }
+
+  inline AffineTransform ViewTransform::UVToScreenTransform() const
+  {
+    // same steps as `ImageToScreen()`: UV to normalized frame coordinates,
+    // flip, center and scale to the frame size, then rotate around the
+    // center of the display area
+    const ImVec2 frameSize{ FrameSize() };
+    const double hx{ flipHorizontal ? -1.0 : 1.0 };
+    const double hy{ flipVertical ? -1.0 : 1.0 };
+    const double ax{ frameSize.x * hx / uvScale };
+    const double ay{ frameSize.y * hy / uvScale };
+    const double bx{ frameSize.x * (-hx * uvOffset.x / uvScale + (flipHorizontal ? 1.0 : 0.0) - 0.5) };
+    const double by{ frameSize.y * (-hy * uvOffset.y / uvScale + (flipVertical ? 1.0 : 0.0) - 0.5) };
+    float cf, sf;
+    RotationCosSin(&cf, &sf);
+    const double c{ cf };
+    const double s{ sf };
+    const double cx{ screenPos.x + displaySize.x * 0.5 };
+    const double cy{ screenPos.y + displaySize.y * 0.5 };
+
+    AffineTransform r;
+    r.xx = c * ax;
+    r.xy = -s * ay;
+    r.x0 = cx + c * bx - s * by;
+    r.yx = s * ax;
+    r.yy = c * ay;
+    r.y0 = cy + s * bx + c * by;
+    return r;
+  }
+
+  inline AffineTransform ViewTransform::ScreenToUVTransform() const
+  {
+    return UVToScreenTransform().Inverse();
+  }
+
+  inline AffineTransform ViewTransform::ImageToUVTransform() const
+  {
+    AffineTransform r;
+    r.xx = 1.0 / textureSize.x;
+    r.yy = 1.0 / textureSize.y;
+    return r;
+  }
+
+  inline AffineTransform ViewTransform::UVToImageTransform() const
+  {
+    AffineTransform r;
+    r.xx = textureSize.x;
+    r.yy = textureSize.y;
+    return r;
+  }
+
+  inline AffineTransform ViewTransform::ImageToScreenTransform() const
+  {
+    return ImageToUVTransform().Then(UVToScreenTransform());
+  }
+
+  inline AffineTransform ViewTransform::ScreenToImageTransform() const
+  {
+    return ImageToScreenTransform().Inverse();
+  }
+
+  inline void ViewTransform::VisibleImageRect(ImVec2* min, ImVec2* max) const
+  {
+    // the inverse image of the display corners bounds the visible area
+    const ImVec2 corners[4]{
+      ScreenToImage(screenPos),
+      ScreenToImage(ImVec2(screenPos.x + displaySize.x, screenPos.y)),
+      ScreenToImage(ImVec2(screenPos.x + displaySize.x, screenPos.y + displaySize.y)),
+      ScreenToImage(ImVec2(screenPos.x, screenPos.y + displaySize.y)),
+    };
+    ImVec2 p0{ corners[0] };
+    ImVec2 p1{ corners[0] };
+    for (const ImVec2& corner : corners)
+    {
+      p0.x = std::min(p0.x, corner.x);
+      p0.y = std::min(p0.y, corner.y);
+      p1.x = std::max(p1.x, corner.x);
+      p1.y = std::max(p1.y, corner.y);
+    }
+    if (min != nullptr)
+    {
+      min->x = std::clamp(p0.x, 0.0f, textureSize.x);
+      min->y = std::clamp(p0.y, 0.0f, textureSize.y);
+    }
+    if (max != nullptr)
+    {
+      max->x = std::clamp(p1.x, 0.0f, textureSize.x);
+      max->y = std::clamp(p1.y, 0.0f, textureSize.y);
+    }
+  }
+
+  inline double Clock()
+  {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+  }
+
+  inline void GetVisibleRect(const State& state, ImVec2* min, ImVec2* max)
+  {
+    const float zoom{ state.zoomLevel > 1.0f ? state.zoomLevel : 1.0f };
+    const float s1{ 1.0f / zoom };
+    const ImVec2& size{ state.textureSize };
+    if (min != nullptr)
+    {
+      min->x = std::clamp(state.panOffset.x * size.x, 0.0f, size.x);
+      min->y = std::clamp(state.panOffset.y * size.y, 0.0f, size.y);
+    }
+    if (max != nullptr)
+    {
+      max->x = std::clamp((state.panOffset.x + s1) * size.x, 0.0f, size.x);
+      max->y = std::clamp((state.panOffset.y + s1) * size.y, 0.0f, size.y);
+    }
+  }
+
+  inline void GetVisibleRect(
+    const State& state, const ViewTransform& view, ImVec2* min, ImVec2* max)
+  {
+    if (view.displaySize.x <= 0.0f || view.displaySize.y <= 0.0f)
+    {
+      GetVisibleRect(state, min, max);
+      return;
+    }
+
+    ViewTransform current{ detail::CurrentView(state, view) };
+    current.textureSize = state.textureSize;
+    current.VisibleImageRect(min, max);
+  }
+
+  namespace detail
+  {
+    // Update `State::frameStats` when a new frame is handed to the widget.
+    inline void TrackFrame(State* s)
+    {
+      FrameStats& f{ s->frameStats };
+      if (s->frameId == 0 || s->frameId == f.lastFrameId)
+      { // timing disabled or frame already drawn
+        return;
+      }
+
+      const double now{ Clock() };
+      if (f.lastFrameId != 0)
+      {
+        if (s->frameId > f.lastFrameId + 1)
+        { // frames in between were replaced before being drawn
+          f.framesDropped += s->frameId - f.lastFrameId - 1;
+        }
+        f.lastDisplayDuration = static_cast<float>(now - f.firstDrawnTime);
+      }
+      f.lastFrameId = s->frameId;
+      f.firstDrawnTime = now;
+      ++f.framesShown;
+
+      // rolling window of latencies
+      f.latencyLast = static_cast<float>(now - s->frameTimestamp);
+      f.samples[f.nextSample] = f.latencyLast;
+      f.nextSample = (f.nextSample + 1) % FrameStats::kWindow;
+      f.sampleCount = std::min(f.sampleCount + 1, FrameStats::kWindow);
+
+      // nearest-rank percentiles
+      float sorted[FrameStats::kWindow];
+      std::copy(f.samples, f.samples + f.sampleCount, sorted);
+      std::sort(sorted, sorted + f.sampleCount);
+      auto percentile = [&](float p) {
+        const int rank{ static_cast<int>(std::ceil(p * f.sampleCount)) - 1 };
+        return sorted[std::clamp(rank, 0, f.sampleCount - 1)];
+      };
+      f.latencyP50 = percentile(0.50f);
+      f.latencyP95 = percentile(0.95f);
+      f.latencyP99 = percentile(0.99f);
+      f.latencyMax = sorted[f.sampleCount - 1];
+    }
+
+    // Open the child region and lay out the display area. Returns the view
+    // transform for this frame and leaves the cursor at the top-left corner
+    // of the display area, where the caller must submit exactly one item
+    // covering `view.displaySize`. Must be paired with `EndView()`.
+    inline ViewTransform BeginView(
+      const ImVec2& imageSize,
+      const ImVec2& uv0,
+      const ImVec2& uv1,
+      const State& s)
+    {
+      // Create a child region to limit events to the image area
+      // Without the child region, panning the image with the mouse
+      // moves the parent window as well.
+      ImGui::BeginChild("ImageRegion", ImVec2(0,0), false, ImGuiWindowFlags_NoMove);
+
+      // Get texture size
+      ImVec2 textureSize{ s.textureSize };
+      if (textureSize.x <= 0.0f || textureSize.y <= 0.0f)
+      { // use image size as texture size
+        textureSize = ImVec2(
+          imageSize.x / std::abs(uv1.x - uv0.x),
+          imageSize.y / std::abs(uv1.y - uv0.y));
+      }
+
+      // Respect the image aspect ratio, as seen after rotation
+      ImVec2 widgetSize{ ImGui::GetContentRegionAvail() };
+      ImVec2 displaySize{ widgetSize };
+      if (s.maintainAspectRatio)
+      {
+        const bool swapAxes{ (detail::QuarterTurns(s.rotation) & 1) != 0 };
+        const float aspectRatio{ swapAxes ?
+          textureSize.y / textureSize.x : textureSize.x / textureSize.y };
+        if (displaySize.x / displaySize.y > aspectRatio)
+        {
+          displaySize.x = displaySize.y * aspectRatio;
+        }
+        else
+        {
+          displaySize.y = displaySize.x / aspectRatio;
+        }
+      }
+
+      // Center the image
+      ImVec2 displayPos{
+        (widgetSize.x - displaySize.x) * 0.5f + ImGui::GetCursorPosX(),
+        (widgetSize.y - displaySize.y) * 0.5f + ImGui::GetCursorPosY(),
+      };
+
+      // Set the display position
+      ImGui::SetCursorPos(displayPos);
+
+      // Apply view setting
+      const float zoom{ s.zoomLevel > 1.0f ? s.zoomLevel : 1.0f };
+
+      ViewTransform view;
+      view.screenPos = ImGui::GetCursorScreenPos();
+      view.displaySize = displaySize;
+      view.textureSize = textureSize;
+      view.uvOffset = s.panOffset;
+      view.uvScale = 1.0f / zoom;
+      view.rotation = s.rotation;
+      view.flipHorizontal = s.flipHorizontal;
+      view.flipVertical = s.flipVertical;
+      return view;
+    }
+
+    // Handle mouse events over the item submitted after `BeginView()` and
+    // close the child region.
+    inline void EndView(const ViewTransform& view, State* s)
+    {
+      s->view = view;
+      const ImVec2& textureSize{ view.textureSize };
+      const float s1{ view.uvScale };
+      const ImVec2 t1{ view.uvOffset };
+
+      // Handle mouse events
+      if(ImGui::IsItemHovered())
+      {
+        auto& io = ImGui::GetIO();
+
+        // update mouse position; `screenPoint` is in normalized frame
+        // coordinates, i.e. with the view orientation undone
+        const ImVec2 screenPoint{ view.ScreenToFrame(io.MousePos) };
+        const ImVec2 imagePoint{ t1.x + screenPoint.x * s1, t1.y + screenPoint.y * s1 };
+        s->mousePosition.x = std::clamp(imagePoint.x * textureSize.x, 0.0f, textureSize.x);
+        s->mousePosition.y = std::clamp(imagePoint.y * textureSize.y, 0.0f, textureSize.y);
+
+        if (s->zoomPanEnabled && !s->zoomPanSuspended)
+        { // handle pan and zoom only if enabled
+          if(io.MouseWheel != 0.0f)
+          { // update image zoom when mouse wheel is scrolled
+
+            // compute the new scale
+            constexpr float maxScale{ 1.0f };
+            const float maxZoomLevel{ s->maxZoomLevel > 1.0f ?
+              s->maxZoomLevel : std::max(textureSize.x, textureSize.y) };
+            const float minScale{ 1.0f / maxZoomLevel };
+            const float scaleFactor{ io.MouseWheel < 0 ? 1.1f : 0.9f };
+            const float s2{ std::min(maxScale, std::max(minScale, scaleFactor * s1)) };
+
+            // make the image position below the mouse to stay at a fixed point
+            // before and after zooming, compute the new translation to keep the
+            // fixed point where it was:
+            //
+            //    screenPoint <-> imagePoint
+            //    imagePoint.x = uv0'.x + screenPoint.x * (uv1'.x - uv0'.x)
+            //    imagePoint.y = uv0'.y + screenPoint.y * (uv1'.y - uv0'.y)
+            //    uv0' = (0,0)*s2 + t2 = t2
+            //    uv1' = (1,1)*s2 + t2
+            //    uv1'- uv0' = (1,1)*s2 + t2 -t2 = (s2,s2)
+            //    -> imagePoint = t2 + screenPoint * s2
+            //    -> t2 = imagePoint - screenPoint * s2
+            //
+            ImVec2 t2{ imagePoint.x - screenPoint.x * s2, imagePoint.y - screenPoint.y * s2 };
+            if (t2.x < 0.0f) { t2.x = 0.0f; }
+            if (t2.y < 0.0f) { t2.y = 0.0f; }
+            if (t2.x > 1.0f - s2) { t2.x = 1.0f - s2; }
+            if (t2.y > 1.0f - s2) { t2.y = 1.0f - s2; }
+
+            // update scale and translation
+            s->zoomLevel = 1.0f / s2;
+            s->panOffset.x = t2.x;
+            s->panOffset.y = t2.y;
+          }
+          else if (io.MouseDoubleClicked[0])
+          { // reset view on double click
+            s->zoomLevel = 1.0f;
+            s->panOffset.x = 0.0f;
+            s->panOffset.y = 0.0f;
+          }
+          else if(io.MouseDown[0])
+          { // pan the image if mouse is moved while pressing the left button
+
+            const ImVec2 previousPoint{ view.ScreenToFrame(ImVec2(
+              io.MousePos.x - io.MouseDelta.x, io.MousePos.y - io.MouseDelta.y)) };
+            const ImVec2 screenDelta{
+              screenPoint.x - previousPoint.x,
+              screenPoint.y - previousPoint.y,
+            };
+            const ImVec2 imageDelta{ screenDelta.x * s1, screenDelta.y * s1 };
+
+            ImVec2 t2{ t1.x - imageDelta.x, t1.y - imageDelta.y };
+            if (t2.x < 0.0f) { t2.x = 0.0f; }
+            if (t2.y < 0.0f) { t2.y = 0.0f; }
+            if (t2.x > 1.0f - s1) { t2.x = 1.0f - s1; }
+            if (t2.y > 1.0f - s1) { t2.y = 1.0f - s1; }
+
+            // update translation
+            s->panOffset.x = t2.x;
+            s->panOffset.y = t2.y;
+          }
+        } // if (zoomPanEnabled)
+      }
+      else
+      { // make mouse position invalid if the image is not hovered
+        s->mousePosition.x = std::numeric_limits<float>::quiet_NaN();
+        s->mousePosition.y = std::numeric_limits<float>::quiet_NaN();
+      }
+      s->zoomPanSuspended = false;
+
+      // End child region
+      ImGui::EndChild();
+    }
+  } // namespace detail
+
   inline void Zoomable(
     ImTextureRef texRef,
     const ImVec2& imageSize,
@@ -240,142 +981,77 @@ namespace ImGuiImage
       return;
     }
 
-    // Create a child region to limit events to the image area
-    // Without the child region, panning the image with the mouse
-    // moves the parent window as well.
-    ImGui::BeginChild("ImageRegion", ImVec2(0,0), false, ImGuiWindowFlags_NoMove);
-
-    // Get texture size
-    ImVec2 textureSize{ s->textureSize };
-    if (textureSize.x <= 0.0f || textureSize.y <= 0.0f)
-    { // use image size as texture size
-      textureSize = ImVec2(
-        imageSize.x / std::abs(uv1.x - uv0.x),
-        imageSize.y / std::abs(uv1.y - uv0.y));
-    }
+    detail::TrackFrame(s);
+    const ViewTransform view{ detail::BeginView(imageSize, uv0, uv1, *s) };
+
+    // Apply view setting
+    const float s1{ view.uvScale };
+    const ImVec2 t1{ view.uvOffset };
+    const ImVec2 uv0New{ t1.x + uv0.x * s1, t1.y + uv0.y * s1 };
+    const ImVec2 uv1New{ t1.x + uv1.x * s1, t1.y + uv1.y * s1 };
 
-    // Respect the image aspect ratio
-    ImVec2 widgetSize{ ImGui::GetContentRegionAvail() };
-    ImVec2 displaySize{ widgetSize };
-    if (s->maintainAspectRatio)
+    // Display the texture
+    if (view.IsIdentityOrientation())
     {
-      const float aspectRatio{ textureSize.x / textureSize.y };
-      if (displaySize.x / displaySize.y > aspectRatio)
-      {
-        displaySize.x = displaySize.y * aspectRatio;
-      }
-      else
+      ImGui::Image(texRef, view.displaySize, uv0New, uv1New, tintColor, bgColor);
+    }
+    else
+    { // draw the frame as a transformed quad, the texture is unchanged
+      ImDrawList* drawList{ ImGui::GetWindowDrawList() };
+      const ImVec2 screenMax{
+        view.screenPos.x + view.displaySize.x,
+        view.screenPos.y + view.displaySize.y };
+      if (bgColor.w > 0.0f)
       {
-        displaySize.y = displaySize.x / aspectRatio;
+        drawList->AddRectFilled(view.screenPos, screenMax,
+          ImGui::GetColorU32(bgColor));
       }
+      drawList->PushClipRect(view.screenPos, screenMax, true);
+      drawList->AddImageQuad(texRef,
+        view.FrameToScreen(ImVec2(0.0f, 0.0f)),
+        view.FrameToScreen(ImVec2(1.0f, 0.0f)),
+        view.FrameToScreen(ImVec2(1.0f, 1.0f)),
+        view.FrameToScreen(ImVec2(0.0f, 1.0f)),
+        uv0New, ImVec2(uv1New.x, uv0New.y), uv1New, ImVec2(uv0New.x, uv1New.y),
+        ImGui::GetColorU32(tintColor));
+      drawList->PopClipRect();
+      ImGui::Dummy(view.displaySize);
     }
 
-    // Center the image
-    ImVec2 displayPos{
-      (widgetSize.x - displaySize.x) * 0.5f + ImGui::GetCursorPosX(),
-      (widgetSize.y - displaySize.y) * 0.5f + ImGui::GetCursorPosY(),
-    };
+    detail::EndView(view, s);
+  }
 
-    // Set the display position
-    ImGui::SetCursorPos(displayPos);
-    const ImVec2 screenDisplayPos{ ImGui::GetCursorScreenPos() };
+  template <typename DrawFn>
+  inline void ZoomableCustom(
+    const ImVec2& displaySize,
+    State* state,
+    DrawFn&& draw)
+  {
+    // Check display size
+    if (displaySize.x <= 0.0f || displaySize.y <= 0.0f)
+    { // Invalid size, do nothing
+      return;
+    }
 
-    // Apply view setting
-    const float zoom{ s->zoomLevel > 1.0f ? s->zoomLevel : 1.0f };
-    const float s1{ 1.0f / zoom };
-    const ImVec2 t1{ s->panOffset.x, s->panOffset.y };
-    const ImVec2 uv0New{ t1.x + uv0.x * s1, t1.y + uv0.y * s1 };
-    const ImVec2 uv1New{ t1.x + uv1.x * s1, t1.y + uv1.y * s1 };
+    // Without a state draw the image without zoom or pan
+    State defaultState;
+    State* s{ state != nullptr ? state : &defaultState };
+    detail::TrackFrame(s);
 
-    // Display the texture
-    ImGui::Image(texRef, displaySize, uv0New, uv1New, tintColor, bgColor);
+    const ViewTransform view{
+      detail::BeginView(displaySize, kDefaultUV0, kDefaultUV1, *s) };
 
-    // Handle mouse events
-    if(ImGui::IsItemHovered())
-    {
-      auto& io = ImGui::GetIO();
+    // Let the caller emit the image content, then submit an item covering
+    // the display area so it reacts to the mouse like `ImGui::Image` does.
+    draw(ImGui::GetWindowDrawList(), view);
+    ImGui::Dummy(view.displaySize);
 
-      // update mouse position
-      const ImVec2 screenPoint{
-        (io.MousePos.x - screenDisplayPos.x) / displaySize.x,
-        (io.MousePos.y - screenDisplayPos.y) / displaySize.y,
-      };
-      const ImVec2 imagePoint{ t1.x + screenPoint.x * s1, t1.y + screenPoint.y * s1 };
-      s->mousePosition.x = std::clamp(imagePoint.x * textureSize.x, 0.0f, textureSize.x);
-      s->mousePosition.y = std::clamp(imagePoint.y * textureSize.y, 0.0f, textureSize.y);
-
-      if (s->zoomPanEnabled)
-      { // handle pan and zoom only if enabled
-        if(io.MouseWheel != 0.0f)
-        { // update image zoom when mouse wheel is scrolled
-
-          // compute the new scale
-          constexpr float maxScale{ 1.0f };
-          const float maxZoomLevel{ s->maxZoomLevel > 1.0f ?
-            s->maxZoomLevel : std::max(textureSize.x, textureSize.y) };
-          const float minScale{ 1.0f / maxZoomLevel };
-          const float scaleFactor{ io.MouseWheel < 0 ? 1.1f : 0.9f };
-          const float s2{ std::min(maxScale, std::max(minScale, scaleFactor * s1)) };
-
-          // make the image position below the mouse to stay at a fixed point
-          // before and after zooming, compute the new translation to keep the
-          // fixed point where it was:
-          //
-          //    screenPoint <-> imagePoint
-          //    imagePoint.x = uv0'.x + screenPoint.x * (uv1'.x - uv0'.x)
-          //    imagePoint.y = uv0'.y + screenPoint.y * (uv1'.y - uv0'.y)
-          //    uv0' = (0,0)*s2 + t2 = t2
-          //    uv1' = (1,1)*s2 + t2
-          //    uv1'- uv0' = (1,1)*s2 + t2 -t2 = (s2,s2)
-          //    -> imagePoint = t2 + screenPoint * s2
-          //    -> t2 = imagePoint - screenPoint * s2
-          //
-          ImVec2 t2{ imagePoint.x - screenPoint.x * s2, imagePoint.y - screenPoint.y * s2 };
-          if (t2.x < 0.0f) { t2.x = 0.0f; }
-          if (t2.y < 0.0f) { t2.y = 0.0f; }
-          if (t2.x > 1.0f - s2) { t2.x = 1.0f - s2; }
-          if (t2.y > 1.0f - s2) { t2.y = 1.0f - s2; }
-
-          // update scale and translation
-          s->zoomLevel = 1.0f / s2;
-          s->panOffset.x = t2.x;
-          s->panOffset.y = t2.y;
-        }
-        else if (io.MouseDoubleClicked[0])
-        { // reset view on double click
-          s->zoomLevel = 1.0f;
-          s->panOffset.x = 0.0f;
-          s->panOffset.y = 0.0f;
-        }
-        else if(io.MouseDown[0])
-        { // pan the image if mouse is moved while pressing the left button
-
-          const ImVec2 screenDelta{
-            io.MouseDelta.x / displaySize.x,
-            io.MouseDelta.y / displaySize.y,
-          };
-          const ImVec2 imageDelta{ screenDelta.x * s1, screenDelta.y * s1 };
-
-          ImVec2 t2{ t1.x - imageDelta.x, t1.y - imageDelta.y };
-          if (t2.x < 0.0f) { t2.x = 0.0f; }
-          if (t2.y < 0.0f) { t2.y = 0.0f; }
-          if (t2.x > 1.0f - s1) { t2.x = 1.0f - s1; }
-          if (t2.y > 1.0f - s1) { t2.y = 1.0f - s1; }
-
-          // update translation
-          s->panOffset.x = t2.x;
-          s->panOffset.y = t2.y;
-        }
-      } // if (zoomPanEnabled)
-    }
-    else
-    { // make mouse position invalid if the image is not hovered
-      s->mousePosition.x = std::numeric_limits<float>::quiet_NaN();
-      s->mousePosition.y = std::numeric_limits<float>::quiet_NaN();
+    if (state == nullptr)
+    { // no state to update, just close the region
+      ImGui::EndChild();
+      return;
     }
-
-    // End child region
-    ImGui::EndChild();
+    detail::EndView(view, s);
   }
 } // namespace ImGuiImage
 
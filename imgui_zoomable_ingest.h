@@ -0,0 +1,533 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Camera Frame Ingestion
+// =============================================
+// Conversion of camera frames (NV12, YUYV and raw 8-bit Bayer) to the RGBA
+// layout expected by texture uploads. Rows are converted in parallel on the
+// shared `ThreadPool`, and Bayer frames are demosaiced with bilinear
+// interpolation. All formats use SSE2 when available (see
+// `IMGUI_ZOOMABLE_IMAGE_SSE2`).
+//
+// When zoomed in, only a fraction of the frame is visible. `ConvertVisible()`
+// converts just the region shown by a widget's `State`, leaving the rest of
+// the destination buffer untouched.
+//
+// Usage
+// -----
+//    ImGuiImage::CameraFrame frame;
+//    frame.format = ImGuiImage::PixelFormat::NV12;
+//    frame.width = 4000; frame.height = 3000;
+//    frame.data = nv12; frame.stride = 4000;
+//
+//    // `staging` is the RGBA buffer later uploaded to the texture
+//    ImGuiImage::ConvertVisible(frame, zoomState, staging, 4000);
+//
+
+#ifndef IMGUI_ZOOMABLE_INGEST_H
+#define IMGUI_ZOOMABLE_INGEST_H
+
+#include "imgui_zoomable_tiles.h"
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Camera pixel formats.
+  //
+  // - NV12: 8-bit Y plane followed by an interleaved U/V plane at half
+  //         resolution in both directions.
+  // - YUYV: 8-bit packed 4:2:2, Y0 U Y1 V for each pair of pixels.
+  // - Bayer*: 8-bit raw sensor data, named after the colors of the top-left
+  //           2x2 block.
+  enum class PixelFormat
+  {
+    NV12,
+    YUYV,
+    BayerRGGB,
+    BayerBGGR,
+    BayerGRBG,
+    BayerGBRG,
+  };
+
+  // YUV to RGB conversion matrices.
+  enum class YuvMatrix
+  {
+    BT601,
+    BT709,
+  };
+
+  // A camera frame in one of the supported formats.
+  //
+  // Members:
+  // - format: Pixel format of `data`.
+  // - width, height: Frame size in pixels. Must be even for NV12 and YUYV.
+  // - data: First byte of the frame (of the Y plane for NV12).
+  // - stride: Bytes from one row to the next (0 = tightly packed).
+  // - uvData, uvStride: U/V plane of NV12 frames (nullptr = right after the
+  //                     Y plane; 0 = same stride as the Y plane).
+  struct CameraFrame
+  {
+    PixelFormat format = PixelFormat::NV12;
+    int width = 0;
+    int height = 0;
+    const std::uint8_t* data = nullptr;
+    int stride = 0;
+    const std::uint8_t* uvData = nullptr;
+    int uvStride = 0;
+  };
+
+  // Conversion options.
+  //
+  // Members:
+  // - matrix: YUV matrix for NV12 and YUYV frames.
+  // - fullRange: YUV values span [0, 255] instead of the video range
+  //              [16, 235] / [16, 240].
+  // - parallel: Convert rows on the shared `ThreadPool`.
+  struct ConvertOptions
+  {
+    YuvMatrix matrix = YuvMatrix::BT601;
+    bool fullRange = false;
+    bool parallel = true;
+  };
+
+  // Convert a whole frame to RGBA (`IM_COL32` layout). `dst` is a buffer of
+  // at least `frame.height` rows of `dstStride` pixels.
+  IMGUI_API void ConvertFrame(
+    const CameraFrame& frame,
+    ImU32* dst,
+    int dstStride,
+    const ConvertOptions& options = ConvertOptions());
+
+  // Convert the frame pixels in [x0, x1) x [y0, y1) only. `dst` is the
+  // buffer of the whole frame and the region is written at its position;
+  // other pixels are left untouched. The region is extended to even
+  // coordinates to follow the chroma and Bayer sampling.
+  IMGUI_API void ConvertRegion(
+    const CameraFrame& frame,
+    int x0,
+    int y0,
+    int x1,
+    int y1,
+    ImU32* dst,
+    int dstStride,
+    const ConvertOptions& options = ConvertOptions());
+
+  // Convert only the part of the frame shown by a widget using `state` (see
+  // `GetVisibleRect()`), grown by `margin` pixels on each side so small pans
+  // do not reveal stale pixels. `state.textureSize` must match the frame.
+  IMGUI_API void ConvertVisible(
+    const CameraFrame& frame,
+    const State& state,
+    ImU32* dst,
+    int dstStride,
+    int margin = 16,
+    const ConvertOptions& options = ConvertOptions());
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  namespace detail
+  {
+    // Fixed point (8 fractional bits) YUV to RGB coefficients:
+    //   c = (y - yOffset) * yScale
+    //   r = c + rv * (v - 128)
+    //   g = c + gu * (u - 128) + gv * (v - 128)
+    //   b = c + bu * (u - 128)
+    struct YuvCoefficients
+    {
+      int yOffset;
+      int yScale;
+      int rv;
+      int gu;
+      int gv;
+      int bu;
+    };
+
+    inline YuvCoefficients GetYuvCoefficients(const ConvertOptions& options)
+    {
+      if (options.fullRange)
+      {
+        return options.matrix == YuvMatrix::BT709 ?
+          YuvCoefficients{ 0, 256, 403, -48, -120, 475 } :
+          YuvCoefficients{ 0, 256, 359, -88, -183, 454 };
+      }
+      return options.matrix == YuvMatrix::BT709 ?
+        YuvCoefficients{ 16, 298, 459, -55, -136, 541 } :
+        YuvCoefficients{ 16, 298, 409, -100, -208, 516 };
+    }
+
+    inline ImU32 YuvToRgba(int y, int u, int v, const YuvCoefficients& k)
+    {
+      const int c{ (y - k.yOffset) * k.yScale + 128 };
+      const int d{ u - 128 };
+      const int e{ v - 128 };
+      const int r{ std::clamp((c + k.rv * e) >> 8, 0, 255) };
+      const int g{ std::clamp((c + k.gu * d + k.gv * e) >> 8, 0, 255) };
+      const int b{ std::clamp((c + k.bu * d) >> 8, 0, 255) };
+      return IM_COL32(r, g, b, 255);
+    }
+
+#if defined(IMGUI_ZOOMABLE_IMAGE_SSE2)
+    // Store 8 pixels given as 16-bit R, G and B lanes as RGBA at `dst`,
+    // saturating to bytes.
+    inline void StoreRgba8(__m128i r16, __m128i g16, __m128i b16, ImU32* dst)
+    {
+      const __m128i zero{ _mm_setzero_si128() };
+      const __m128i r8{ _mm_packus_epi16(r16, zero) };
+      const __m128i g8{ _mm_packus_epi16(g16, zero) };
+      const __m128i b8{ _mm_packus_epi16(b16, zero) };
+      const __m128i a8{ _mm_set1_epi8(static_cast<char>(0xFF)) };
+      const __m128i rg{ _mm_unpacklo_epi8(r8, g8) };
+      const __m128i ba{ _mm_unpacklo_epi8(b8, a8) };
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(rg, ba));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(rg, ba));
+    }
+
+    // Convert 8 pixels given as 16-bit Y, U and V lanes and store them as
+    // RGBA at `dst`.
+    inline void YuvToRgba8(
+      __m128i y, __m128i u, __m128i v, const YuvCoefficients& k, ImU32* dst)
+    {
+      const __m128i zero{ _mm_setzero_si128() };
+      const __m128i c{ _mm_sub_epi16(y, _mm_set1_epi16(static_cast<short>(k.yOffset))) };
+      const __m128i d{ _mm_sub_epi16(u, _mm_set1_epi16(128)) };
+      const __m128i e{ _mm_sub_epi16(v, _mm_set1_epi16(128)) };
+
+      // pairs of 16-bit coefficients for _mm_madd_epi16
+      auto pair = [](int a, int b) {
+        return _mm_set1_epi32(static_cast<int>(
+          (static_cast<std::uint32_t>(b) << 16) | (static_cast<std::uint32_t>(a) & 0xFFFFu)));
+      };
+      const __m128i kYR{ pair(k.yScale, k.rv) };
+      const __m128i kYB{ pair(k.yScale, k.bu) };
+      const __m128i kYG{ pair(k.yScale, k.gu) };
+      const __m128i kGV{ pair(k.gv, 0) };
+      const __m128i round{ _mm_set1_epi32(128) };
+
+      auto channel = [&](__m128i ab, __m128i coeff, __m128i extra) {
+        __m128i sum{ _mm_add_epi32(_mm_madd_epi16(ab, coeff), round) };
+        sum = _mm_add_epi32(sum, extra);
+        return _mm_srai_epi32(sum, 8);
+      };
+
+      const __m128i ceLo{ _mm_unpacklo_epi16(c, e) };
+      const __m128i ceHi{ _mm_unpackhi_epi16(c, e) };
+      const __m128i cdLo{ _mm_unpacklo_epi16(c, d) };
+      const __m128i cdHi{ _mm_unpackhi_epi16(c, d) };
+      const __m128i gvLo{ _mm_madd_epi16(_mm_unpacklo_epi16(e, zero), kGV) };
+      const __m128i gvHi{ _mm_madd_epi16(_mm_unpackhi_epi16(e, zero), kGV) };
+
+      const __m128i r16{ _mm_packs_epi32(
+        channel(ceLo, kYR, zero), channel(ceHi, kYR, zero)) };
+      const __m128i g16{ _mm_packs_epi32(
+        channel(cdLo, kYG, gvLo), channel(cdHi, kYG, gvHi)) };
+      const __m128i b16{ _mm_packs_epi32(
+        channel(cdLo, kYB, zero), channel(cdHi, kYB, zero)) };
+
+      StoreRgba8(r16, g16, b16, dst);
+    }
+#endif
+
+    // Convert pixels [x0, x1) of one NV12 row; x0 must be even.
+    inline void ConvertNv12Row(
+      const std::uint8_t* yRow,
+      const std::uint8_t* uvRow,
+      int x0,
+      int x1,
+      ImU32* dst,
+      const YuvCoefficients& k)
+    {
+      int x{ x0 };
+#if defined(IMGUI_ZOOMABLE_IMAGE_SSE2)
+      const __m128i zero{ _mm_setzero_si128() };
+      const __m128i lowWord{ _mm_set1_epi32(0x0000FFFF) };
+      for (; x + 8 <= x1; x += 8)
+      {
+        const __m128i y{ _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(yRow + x)), zero) };
+        // 4 U/V pairs shared by the 8 pixels, as 32-bit U | V << 16 lanes
+        const __m128i uv{ _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(uvRow + x)), zero) };
+        const __m128i u32{ _mm_and_si128(uv, lowWord) };
+        const __m128i v32{ _mm_srli_epi32(uv, 16) };
+        const __m128i u{ _mm_or_si128(u32, _mm_slli_epi32(u32, 16)) };
+        const __m128i v{ _mm_or_si128(v32, _mm_slli_epi32(v32, 16)) };
+        YuvToRgba8(y, u, v, k, dst + x);
+      }
+#endif
+      for (; x < x1; ++x)
+      {
+        const int c{ x & ~1 };
+        dst[x] = YuvToRgba(yRow[x], uvRow[c], uvRow[c + 1], k);
+      }
+    }
+
+    // Convert pixels [x0, x1) of one YUYV row; x0 must be even.
+    inline void ConvertYuyvRow(
+      const std::uint8_t* row,
+      int x0,
+      int x1,
+      ImU32* dst,
+      const YuvCoefficients& k)
+    {
+      int x{ x0 };
+#if defined(IMGUI_ZOOMABLE_IMAGE_SSE2)
+      const __m128i lowByte{ _mm_set1_epi16(0x00FF) };
+      const __m128i lowWord{ _mm_set1_epi32(0x0000FFFF) };
+      for (; x + 8 <= x1; x += 8)
+      {
+        const __m128i p{ _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(row + x * 2)) };
+        const __m128i y{ _mm_and_si128(p, lowByte) };
+        // chroma lanes as 32-bit U | V << 16, one per pair of pixels
+        const __m128i uv{ _mm_srli_epi16(p, 8) };
+        const __m128i u32{ _mm_and_si128(uv, lowWord) };
+        const __m128i v32{ _mm_srli_epi32(uv, 16) };
+        const __m128i u{ _mm_or_si128(u32, _mm_slli_epi32(u32, 16)) };
+        const __m128i v{ _mm_or_si128(v32, _mm_slli_epi32(v32, 16)) };
+        YuvToRgba8(y, u, v, k, dst + x);
+      }
+#endif
+      for (; x < x1; ++x)
+      {
+        const std::uint8_t* pair{ row + (x & ~1) * 2 };
+        dst[x] = YuvToRgba(row[x * 2], pair[1], pair[3], k);
+      }
+    }
+
+    // Bilinear demosaic of pixels [x0, x1) of row `y`. Neighbors outside the
+    // frame are mirrored, which keeps the Bayer phase of each position.
+    inline void DemosaicRow(
+      const CameraFrame& frame,
+      int stride,
+      int y,
+      int x0,
+      int x1,
+      ImU32* dst)
+    {
+      // color (0 = R, 1 = G, 2 = B) at the even/odd positions of the even
+      // and odd rows
+      int redX{ 0 }, redY{ 0 };
+      switch (frame.format)
+      {
+      case PixelFormat::BayerRGGB: redX = 0; redY = 0; break;
+      case PixelFormat::BayerGRBG: redX = 1; redY = 0; break;
+      case PixelFormat::BayerGBRG: redX = 0; redY = 1; break;
+      case PixelFormat::BayerBGGR: redX = 1; redY = 1; break;
+      default: break;
+      }
+
+      auto mirror = [](int i, int n) {
+        return i < 0 ? -i : (i >= n ? 2 * (n - 1) - i : i);
+      };
+      const int w{ frame.width };
+      const std::uint8_t* up{ frame.data +
+        static_cast<std::size_t>(mirror(y - 1, frame.height)) * stride };
+      const std::uint8_t* mid{ frame.data + static_cast<std::size_t>(y) * stride };
+      const std::uint8_t* down{ frame.data +
+        static_cast<std::size_t>(mirror(y + 1, frame.height)) * stride };
+      const bool redRow{ ((y & 1) == redY) };
+
+      auto pixel = [&](int x, int l, int r) {
+        const int c{ mid[x] };
+        const int cross{ (up[x] + down[x] + mid[l] + mid[r] + 2) >> 2 };
+        const int diag{ (up[l] + up[r] + down[l] + down[r] + 2) >> 2 };
+        const int horizontal{ (mid[l] + mid[r] + 1) >> 1 };
+        const int vertical{ (up[x] + down[x] + 1) >> 1 };
+        const bool redColumn{ ((x & 1) == redX) };
+        if (redRow)
+        {
+          return redColumn ?
+            IM_COL32(c, cross, diag, 255) :          // R site
+            IM_COL32(horizontal, c, vertical, 255);  // G site on a red row
+        }
+        return redColumn ?
+          IM_COL32(vertical, c, horizontal, 255) :   // G site on a blue row
+          IM_COL32(diag, cross, c, 255);             // B site
+      };
+
+      int x{ x0 };
+      if (x == 0 && x < x1)
+      {
+        dst[0] = pixel(0, std::min(1, w - 1), std::min(1, w - 1));
+        ++x;
+      }
+      // interior: no mirroring
+      const int interiorEnd{ std::min(x1, w - 1) };
+#if defined(IMGUI_ZOOMABLE_IMAGE_SSE2)
+      {
+        const __m128i zero{ _mm_setzero_si128() };
+        const __m128i one{ _mm_set1_epi16(1) };
+        const __m128i two{ _mm_set1_epi16(2) };
+        // lanes of the red (or, on blue rows, green) columns for blocks
+        // starting on an even and on an odd column
+        const __m128i evenLanes{ _mm_set1_epi32(0x0000FFFF) };
+        const __m128i oddLanes{ _mm_set1_epi32(static_cast<int>(0xFFFF0000u)) };
+        auto load = [&](const std::uint8_t* row, int i) {
+          return _mm_unpacklo_epi8(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + i)), zero);
+        };
+        auto select = [](__m128i mask, __m128i a, __m128i b) {
+          return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        };
+        // the last block reads up to column x + 8 <= w - 1
+        for (; x + 8 <= interiorEnd; x += 8)
+        {
+          const __m128i ul{ load(up, x - 1) }, uc{ load(up, x) }, ur{ load(up, x + 1) };
+          const __m128i ml{ load(mid, x - 1) }, mc{ load(mid, x) }, mr{ load(mid, x + 1) };
+          const __m128i dl{ load(down, x - 1) }, dc{ load(down, x) }, dr{ load(down, x + 1) };
+
+          const __m128i vsum{ _mm_add_epi16(uc, dc) };
+          const __m128i hsum{ _mm_add_epi16(ml, mr) };
+          const __m128i cross{ _mm_srli_epi16(
+            _mm_add_epi16(_mm_add_epi16(vsum, hsum), two), 2) };
+          const __m128i diag{ _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(
+            _mm_add_epi16(ul, ur), _mm_add_epi16(dl, dr)), two), 2) };
+          const __m128i horizontal{ _mm_srli_epi16(_mm_add_epi16(hsum, one), 1) };
+          const __m128i vertical{ _mm_srli_epi16(_mm_add_epi16(vsum, one), 1) };
+
+          const __m128i red{ (x & 1) == redX ? evenLanes : oddLanes };
+          if (redRow)
+          { // R sites and G sites on a red row
+            StoreRgba8(select(red, mc, horizontal), select(red, cross, mc),
+              select(red, diag, vertical), dst + x);
+          }
+          else
+          { // G sites on a blue row and B sites
+            StoreRgba8(select(red, vertical, diag), select(red, mc, cross),
+              select(red, horizontal, mc), dst + x);
+          }
+        }
+      }
+#endif
+      for (; x < interiorEnd; ++x)
+      {
+        dst[x] = pixel(x, x - 1, x + 1);
+      }
+      if (x < x1)
+      {
+        dst[x] = pixel(x, std::max(0, x - 1), std::max(0, x - 1));
+      }
+    }
+  } // namespace detail
+
+  inline void ConvertFrame(
+    const CameraFrame& frame,
+    ImU32* dst,
+    int dstStride,
+    const ConvertOptions& options)
+  {
+    ConvertRegion(frame, 0, 0, frame.width, frame.height, dst, dstStride, options);
+  }
+
+  inline void ConvertRegion(
+    const CameraFrame& frame,
+    int x0,
+    int y0,
+    int x1,
+    int y1,
+    ImU32* dst,
+    int dstStride,
+    const ConvertOptions& options)
+  {
+    if (frame.data == nullptr || dst == nullptr || frame.width <= 0 || frame.height <= 0)
+    {
+      return;
+    }
+    // align to the 2x2 sampling of chroma and Bayer data
+    x0 = std::clamp(x0 & ~1, 0, frame.width);
+    y0 = std::clamp(y0 & ~1, 0, frame.height);
+    x1 = std::clamp((x1 + 1) & ~1, 0, frame.width);
+    y1 = std::clamp((y1 + 1) & ~1, 0, frame.height);
+    if (x1 <= x0 || y1 <= y0)
+    {
+      return;
+    }
+
+    const int bytesPerPixel{ frame.format == PixelFormat::YUYV ? 2 : 1 };
+    const int stride{ frame.stride > 0 ? frame.stride : frame.width * bytesPerPixel };
+    const detail::YuvCoefficients k{ detail::GetYuvCoefficients(options) };
+
+    auto convertRow = [&](int y) {
+      ImU32* row{ dst + static_cast<std::size_t>(y) * dstStride };
+      const std::uint8_t* src{ frame.data + static_cast<std::size_t>(y) * stride };
+      switch (frame.format)
+      {
+      case PixelFormat::NV12:
+      {
+        const std::uint8_t* uvPlane{ frame.uvData != nullptr ? frame.uvData :
+          frame.data + static_cast<std::size_t>(stride) * frame.height };
+        const int uvStride{ frame.uvStride > 0 ? frame.uvStride : stride };
+        detail::ConvertNv12Row(src,
+          uvPlane + static_cast<std::size_t>(y / 2) * uvStride, x0, x1, row, k);
+        break;
+      }
+      case PixelFormat::YUYV:
+        detail::ConvertYuyvRow(src, x0, x1, row, k);
+        break;
+      default:
+        detail::DemosaicRow(frame, stride, y, x0, x1, row);
+        break;
+      }
+    };
+
+    if (!options.parallel)
+    {
+      for (int y = y0; y < y1; ++y)
+      {
+        convertRow(y);
+      }
+      return;
+    }
+    // blocks of rows big enough to amortize the dispatch
+    const int grain{ std::max(8, 65536 / std::max(1, x1 - x0)) };
+    ParallelFor(y0, y1, convertRow, grain);
+  }
+
+  inline void ConvertVisible(
+    const CameraFrame& frame,
+    const State& state,
+    ImU32* dst,
+    int dstStride,
+    int margin,
+    const ConvertOptions& options)
+  {
+    State s{ state };
+    if (s.textureSize.x <= 0.0f || s.textureSize.y <= 0.0f)
+    {
+      s.textureSize = ImVec2(
+        static_cast<float>(frame.width), static_cast<float>(frame.height));
+    }
+    ImVec2 min, max;
+    GetVisibleRect(s, s.view, &min, &max);
+    ConvertRegion(frame,
+      static_cast<int>(std::floor(min.x)) - margin,
+      static_cast<int>(std::floor(min.y)) - margin,
+      static_cast<int>(std::ceil(max.x)) + margin,
+      static_cast<int>(std::ceil(max.y)) + margin,
+      dst, dstStride, options);
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_INGEST_H
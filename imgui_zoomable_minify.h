@@ -0,0 +1,345 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Minification
+// ===================================
+// When an image is displayed smaller than its native size, the GPU sampler
+// skips source pixels (there are no mipmaps behind `Zoomable()`), so fine
+// detail such as text or thin lines shimmers and aliases while zooming.
+//
+// `MinifiedImage` keeps properly filtered copies of the image, one per
+// pyramid level (level N is the image downscaled by 2^N), computed on the
+// CPU with the area or Lanczos filter of `imgui_zoomable_resample.h`. While
+// the view is zoomed out it returns the texture of the level matching the
+// display scale, and the full resolution texture otherwise. Since the copies
+// cover the whole image, they are drawn with the same zoom and pan as the
+// original texture.
+//
+// Levels are computed in the background the first time they are needed and
+// cached; until one is ready, the closest ready level (or the original
+// texture) is shown.
+//
+// Usage
+// -----
+//    ImGuiImage::CpuTextureProvider provider; // or OpenGLTextureProvider
+//    ImGuiImage::TexturePool pool(&provider);
+//    ImGuiImage::MinifiedImage minified(&pool);
+//    minified.filter = ImGuiImage::ResampleFilter::Lanczos3;
+//    minified.SetSource(pixels, width, height, width, textureId);
+//
+//    ...
+//
+//    ImGuiImage::Zoomable(minified.Texture(state, displaySize), displaySize,
+//      &state);
+//
+
+#ifndef IMGUI_ZOOMABLE_MINIFY_H
+#define IMGUI_ZOOMABLE_MINIFY_H
+
+#include "imgui_zoomable_resample.h"
+#include "imgui_zoomable_texture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Display scale (screen pixels per image pixel) of a widget using `state`
+  // in an area of `displaySize`, following the layout of `Zoomable()`.
+  IMGUI_API float GetDisplayScale(const State& state, const ImVec2& displaySize);
+
+  // Filtered pyramid of an image for zoomed-out display, one per widget.
+  //
+  // Members:
+  // - filter: Minification filter. Changing it discards the cached levels.
+  // - levelBias: Added to log2(1 / scale) before rounding down to a level.
+  //              0 picks the finest level that is not magnified (sharpest,
+  //              the GPU still minifies up to 2x); 1 the coarsest that is
+  //              not minified (no aliasing, slightly soft).
+  class MinifiedImage
+  {
+  public:
+    ResampleFilter filter = ResampleFilter::Area;
+    float levelBias = 0.5f;
+
+    explicit MinifiedImage(TexturePool* pool);
+    ~MinifiedImage();
+
+    MinifiedImage(const MinifiedImage&) = delete;
+    MinifiedImage& operator=(const MinifiedImage&) = delete;
+
+    // Set the full resolution image: its RGBA pixels (`stride` in pixels),
+    // which must stay valid until the next `SetSource()` or the destruction
+    // of this object, and the texture holding them. Discards cached levels.
+    void SetSource(
+      const ImU32* pixels,
+      int width,
+      int height,
+      int stride,
+      ImTextureRef texture);
+
+    // Discard the cached levels, e.g. after the pixels changed. Waits for
+    // levels being computed.
+    void Invalidate();
+
+    // Texture to display for the view of `state` in `displaySize`. Call
+    // once per frame from the thread owning the rendering context; finished
+    // levels are uploaded here.
+    ImTextureRef Texture(const State& state, const ImVec2& displaySize);
+
+    // Pyramid level matching the view (0 = full resolution).
+    int LevelFor(const State& state, const ImVec2& displaySize) const;
+
+    // Whether a level is computed and uploaded.
+    bool IsReady(int level) const;
+
+  private:
+    struct Level
+    {
+      PooledTexture texture;
+      bool requested = false;
+    };
+
+    // State shared with the background tasks.
+    struct Shared : detail::BackgroundTasks
+    {
+      std::uint64_t generation = 0;
+      std::vector<std::shared_ptr<TileImage>> results;
+    };
+
+    void Request(int level);
+    void Wait();
+    void ReleaseLevels();
+
+    TexturePool* pool_;
+    const ImU32* pixels_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+    int stride_ = 0;
+    ImTextureRef texture_;
+    ResampleFilter builtFilter_ = ResampleFilter::Area;
+    std::vector<Level> levels_;
+    std::shared_ptr<Shared> shared_;
+  };
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  inline float GetDisplayScale(const State& state, const ImVec2& displaySize)
+  {
+    ImVec2 size{ state.textureSize };
+    if (size.x <= 0.0f || size.y <= 0.0f)
+    {
+      return 1.0f;
+    }
+    if ((detail::QuarterTurns(state.rotation) & 1) != 0)
+    {
+      std::swap(size.x, size.y);
+    }
+    const float zoom{ state.zoomLevel > 1.0f ? state.zoomLevel : 1.0f };
+    const float sx{ displaySize.x / size.x };
+    const float sy{ displaySize.y / size.y };
+    // with the aspect ratio kept, the image fits the display; otherwise it
+    // is stretched and the larger scale shows the most detail
+    return (state.maintainAspectRatio ? std::min(sx, sy) : std::max(sx, sy)) * zoom;
+  }
+
+  inline MinifiedImage::MinifiedImage(TexturePool* pool)
+    : pool_(pool)
+    , shared_(std::make_shared<Shared>())
+  {
+  }
+
+  inline MinifiedImage::~MinifiedImage()
+  {
+    Invalidate();
+  }
+
+  inline void MinifiedImage::SetSource(
+    const ImU32* pixels,
+    int width,
+    int height,
+    int stride,
+    ImTextureRef texture)
+  {
+    Invalidate();
+    pixels_ = pixels;
+    width_ = width;
+    height_ = height;
+    stride_ = stride > 0 ? stride : width;
+    texture_ = texture;
+
+    int levelCount{ 1 };
+    while ((std::max(width, height) >> levelCount) > 0)
+    { // down to a single pixel
+      ++levelCount;
+    }
+    levels_.resize(static_cast<std::size_t>(levelCount));
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    shared_->results.assign(levels_.size(), nullptr);
+  }
+
+  inline void MinifiedImage::Wait()
+  {
+    std::unique_lock<std::mutex> lock(shared_->mutex);
+    ++shared_->generation; // queued tasks that did not start are skipped
+    shared_->WaitIdle(lock);
+    std::fill(shared_->results.begin(), shared_->results.end(), nullptr);
+  }
+
+  inline void MinifiedImage::ReleaseLevels()
+  {
+    for (Level& level : levels_)
+    {
+      if (pool_ != nullptr)
+      {
+        pool_->Release(&level.texture);
+      }
+      level = Level();
+    }
+  }
+
+  inline void MinifiedImage::Invalidate()
+  {
+    Wait();
+    ReleaseLevels();
+  }
+
+  inline int MinifiedImage::LevelFor(const State& state, const ImVec2& displaySize) const
+  {
+    State s{ state };
+    s.textureSize = ImVec2(static_cast<float>(width_), static_cast<float>(height_));
+    const float scale{ GetDisplayScale(s, displaySize) };
+    if (scale <= 0.0f || levels_.empty())
+    {
+      return 0;
+    }
+    const int level{ static_cast<int>(std::floor(std::log2(1.0f / scale) + levelBias)) };
+    return std::clamp(level, 0, static_cast<int>(levels_.size()) - 1);
+  }
+
+  inline bool MinifiedImage::IsReady(int level) const
+  {
+    return level == 0 || (level > 0 && level < static_cast<int>(levels_.size()) &&
+      levels_[level].texture.Valid());
+  }
+
+  inline void MinifiedImage::Request(int level)
+  {
+    levels_[level].requested = true;
+    std::uint64_t generation;
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      generation = shared_->generation;
+    }
+    ThreadPool::Default().Submit(0,
+      [shared = shared_, generation, level, pixels = pixels_, width = width_,
+       height = height_, stride = stride_, levelFilter = filter] {
+        if (!shared->Begin([&] { return shared->generation != generation; }))
+        {
+          return;
+        }
+        auto image{ std::make_shared<TileImage>() };
+        image->width = std::max(1, width >> level);
+        image->height = std::max(1, height >> level);
+        image->pixels.resize(static_cast<std::size_t>(image->width) * image->height);
+        ResampleImage(pixels, width, height, stride,
+          ImVec2(0.0f, 0.0f),
+          ImVec2(static_cast<float>(width), static_cast<float>(height)),
+          image->pixels.data(), image->width, image->height, image->width,
+          levelFilter);
+
+        shared->End([&] {
+          if (shared->generation == generation)
+          {
+            shared->results[level] = std::move(image);
+          }
+        });
+      });
+  }
+
+  inline ImTextureRef MinifiedImage::Texture(const State& state, const ImVec2& displaySize)
+  {
+    if (pixels_ == nullptr || pool_ == nullptr)
+    {
+      return texture_;
+    }
+    if (filter != builtFilter_)
+    {
+      Invalidate();
+      builtFilter_ = filter;
+    }
+
+    // upload the levels finished since the last frame
+    std::vector<std::shared_ptr<TileImage>> finished;
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      finished.swap(shared_->results);
+      shared_->results.resize(levels_.size());
+    }
+    for (std::size_t i = 0; i < finished.size(); ++i)
+    {
+      if (finished[i] != nullptr)
+      {
+        const TileImage& image{ *finished[i] };
+        Level& level{ levels_[i] };
+        level.texture = pool_->Acquire(
+          { image.width, image.height, TextureFormat::RGBA8 });
+        pool_->Upload(level.texture, image.pixels.data());
+      }
+    }
+
+    const int wanted{ LevelFor(state, displaySize) };
+    if (wanted == 0)
+    {
+      return texture_;
+    }
+    if (!levels_[wanted].texture.Valid() && !levels_[wanted].requested)
+    {
+      Request(wanted);
+    }
+
+    // the wanted level, or the closest ready one while it is computed
+    for (int distance = 0; distance < static_cast<int>(levels_.size()); ++distance)
+    {
+      for (int level : { wanted + distance, wanted - distance })
+      {
+        if (level > 0 && level < static_cast<int>(levels_.size()) &&
+            levels_[level].texture.Valid())
+        {
+          return levels_[level].texture.Ref();
+        }
+      }
+    }
+    return texture_;
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_MINIFY_H
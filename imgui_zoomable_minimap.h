@@ -0,0 +1,312 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Minimap
+// ==============================
+// Overview inset drawn in a corner of a zoomable view: the whole image, with
+// the area currently shown outlined. Clicking or dragging in the inset
+// centers the view on that point; the zoom level is kept.
+//
+// The overview is a single small texture: any low resolution copy of the
+// image (e.g. a level of `MinifiedImage`), or for tiled images the coarsest
+// tile of the pyramid, which `ZoomableTiles()` keeps resident anyway. No
+// other tile is looked up, so the inset never causes a full resolution load
+// and costs one textured quad plus an outline per frame.
+//
+// The inset shows the image unrotated. The outline is the part of the image
+// actually shown: the window of `State::panOffset` and `State::zoomLevel`,
+// clipped by the display area, which is a rotated rectangle in image space
+// when the view is not rotated by a multiple of 90 degrees.
+//
+// Usage
+// -----
+//    ImGuiImage::MinimapState minimap;
+//
+//    ...
+//
+//    ImGuiImage::ZoomableCustom(displaySize, &state,
+//      [&](ImDrawList* drawList, const ImGuiImage::ViewTransform& view) {
+//        ImGuiImage::DrawTileLayer(drawList, view, grid, 0, lookup,
+//          view.screenPos, ImVec2(view.screenPos.x + view.displaySize.x,
+//                                 view.screenPos.y + view.displaySize.y));
+//        ImGuiImage::DrawMinimapTiles(drawList, view, &state, &minimap,
+//          grid, 0, lookup);
+//      });
+//
+
+#ifndef IMGUI_ZOOMABLE_MINIMAP_H
+#define IMGUI_ZOOMABLE_MINIMAP_H
+
+#include "imgui_zoomable_tiles.h"
+
+#include <algorithm>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Corner of the display area holding the minimap.
+  enum class MinimapCorner
+  {
+    TopLeft,
+    TopRight,
+    BottomLeft,
+    BottomRight,
+  };
+
+  // Minimap settings and interaction state, kept across frames.
+  //
+  // Members:
+  // - size: Length in screen pixels of the longest side of the inset.
+  // - margin: Distance in screen pixels from the edges of the display area.
+  // - corner: Corner of the display area holding the inset.
+  // - viewColor: Color of the outline of the area shown by the view.
+  // - frameColor: Color of the border and background of the inset.
+  // - dragging: Whether the view is being dragged from the inset. Zooming
+  //             and panning the view are suspended meanwhile, one frame at
+  //             a time (see `State::zoomPanSuspended`).
+  struct MinimapState
+  {
+    float size = 160.0f;
+    float margin = 8.0f;
+    MinimapCorner corner = MinimapCorner::BottomRight;
+    ImU32 viewColor = IM_COL32(255, 200, 0, 255);
+    ImU32 frameColor = IM_COL32(0, 0, 0, 160);
+    bool dragging = false;
+  };
+
+  // Draw the minimap of the view in `view` over it and move the view of
+  // `state` when the inset is clicked or dragged. Call it from the draw
+  // callback of `ZoomableCustom()`, after the image content. `overview` is
+  // a texture of the whole image (or the part between `uv0` and `uv1`).
+  // Returns true when the view moved.
+  IMGUI_API bool DrawMinimap(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    State* state,
+    MinimapState* minimap,
+    ImTextureRef overview,
+    const ImVec2& uv0 = kDefaultUV0,
+    const ImVec2& uv1 = kDefaultUV1);
+
+  // Same as `DrawMinimap()` for a tiled image, drawing the coarsest tile of
+  // `grid` (a single tile covering the whole image) from `lookup`. Nothing
+  // but the background is drawn while it is not resident.
+  template <typename LookupFn>
+  bool DrawMinimapTiles(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    State* state,
+    MinimapState* minimap,
+    const TileGrid& grid,
+    int layer,
+    LookupFn&& lookup);
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  namespace detail
+  {
+    // Screen rectangle of the minimap inset of `view`.
+    inline void MinimapRect(
+      const ViewTransform& view,
+      const MinimapState& minimap,
+      ImVec2* min,
+      ImVec2* max)
+    {
+      const ImVec2& texSize{ view.textureSize };
+      const float longest{ std::max(texSize.x, texSize.y) };
+      const float fit{ std::min(minimap.size,
+        std::min(view.displaySize.x, view.displaySize.y) - 2.0f * minimap.margin) };
+      const ImVec2 size{
+        longest > 0.0f ? std::max(0.0f, fit * texSize.x / longest) : 0.0f,
+        longest > 0.0f ? std::max(0.0f, fit * texSize.y / longest) : 0.0f };
+
+      const bool left{ minimap.corner == MinimapCorner::TopLeft ||
+        minimap.corner == MinimapCorner::BottomLeft };
+      const bool top{ minimap.corner == MinimapCorner::TopLeft ||
+        minimap.corner == MinimapCorner::TopRight };
+      min->x = left ? view.screenPos.x + minimap.margin :
+        view.screenPos.x + view.displaySize.x - minimap.margin - size.x;
+      min->y = top ? view.screenPos.y + minimap.margin :
+        view.screenPos.y + view.displaySize.y - minimap.margin - size.y;
+      max->x = min->x + size.x;
+      max->y = min->y + size.y;
+    }
+
+    // Clip the convex polygon of `count` vertices in `points` to the
+    // rectangle [min, max]. `points` must have room for `count` + 4
+    // vertices. Returns the number of vertices left.
+    inline int ClipPolygon(ImVec2* points, int count, const ImVec2& min, const ImVec2& max)
+    {
+      ImVec2 clipped[12];
+      for (int edge = 0; edge < 4 && count > 0; ++edge)
+      { // left, top, right and bottom edges
+        const bool vertical{ edge % 2 == 0 };
+        const bool lower{ edge < 2 };
+        const float bound{ vertical ? (lower ? min.x : max.x) : (lower ? min.y : max.y) };
+        auto coordinate = [vertical](const ImVec2& p) { return vertical ? p.x : p.y; };
+        auto inside = [&](const ImVec2& p) {
+          return lower ? coordinate(p) >= bound : coordinate(p) <= bound;
+        };
+
+        int n{ 0 };
+        for (int i = 0; i < count; ++i)
+        {
+          const ImVec2& a{ points[i] };
+          const ImVec2& b{ points[(i + 1) % count] };
+          if (inside(a))
+          {
+            clipped[n++] = a;
+          }
+          if (inside(a) != inside(b))
+          {
+            const float t{ (bound - coordinate(a)) / (coordinate(b) - coordinate(a)) };
+            clipped[n++] = ImVec2(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t);
+          }
+        }
+        std::copy(clipped, clipped + n, points);
+        count = n;
+      }
+      return count;
+    }
+
+    // Handle clicks and drags in the inset [min, max] and draw the outline
+    // of the view over it. Returns true when the view moved.
+    inline bool MinimapInteract(
+      ImDrawList* drawList,
+      const ViewTransform& view,
+      const ImVec2& min,
+      const ImVec2& max,
+      State* state,
+      MinimapState* minimap)
+    {
+      const ImVec2 size{ max.x - min.x, max.y - min.y };
+      const float zoom{ state->zoomLevel > 1.0f ? state->zoomLevel : 1.0f };
+      const float extent{ 1.0f / zoom };
+
+      const bool hovered{ ImGui::IsWindowHovered() &&
+        ImGui::IsMouseHoveringRect(min, max) };
+      if (hovered && !minimap->dragging && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+      {
+        minimap->dragging = true;
+      }
+
+      bool moved{ false };
+      if (minimap->dragging)
+      {
+        if (ImGui::IsMouseDown(ImGuiMouseButton_Left))
+        { // center the view on the mouse, within the image
+          const ImVec2 mouse{ ImGui::GetIO().MousePos };
+          const ImVec2 offset{
+            std::clamp((mouse.x - min.x) / size.x - 0.5f * extent, 0.0f, 1.0f - extent),
+            std::clamp((mouse.y - min.y) / size.y - 0.5f * extent, 0.0f, 1.0f - extent) };
+          moved = offset.x != state->panOffset.x || offset.y != state->panOffset.y;
+          state->panOffset = offset;
+          // the drag moves the view, the widget must not pan it as well
+          state->zoomPanSuspended = true;
+        }
+        else
+        {
+          minimap->dragging = false;
+        }
+      }
+
+      // the display area in image space, clipped to the window of the view
+      const ViewTransform current{ detail::CurrentView(*state, view) };
+      const ImVec2 screenMax{
+        current.screenPos.x + current.displaySize.x,
+        current.screenPos.y + current.displaySize.y };
+      ImVec2 outline[8]{
+        current.ScreenToImage(current.screenPos),
+        current.ScreenToImage(ImVec2(screenMax.x, current.screenPos.y)),
+        current.ScreenToImage(screenMax),
+        current.ScreenToImage(ImVec2(current.screenPos.x, screenMax.y)),
+      };
+      const ImVec2& texSize{ current.textureSize };
+      const int count{ ClipPolygon(outline, 4,
+        ImVec2(state->panOffset.x * texSize.x, state->panOffset.y * texSize.y),
+        ImVec2((state->panOffset.x + extent) * texSize.x,
+          (state->panOffset.y + extent) * texSize.y)) };
+      for (int i = 0; i < count; ++i)
+      { // image pixels to inset
+        outline[i] = ImVec2(
+          min.x + outline[i].x / texSize.x * size.x,
+          min.y + outline[i].y / texSize.y * size.y);
+      }
+
+      drawList->AddRect(min, max, minimap->frameColor);
+      drawList->PushClipRect(min, max, true);
+      drawList->AddPolyline(outline, count, minimap->viewColor, ImDrawFlags_Closed, 1.0f);
+      drawList->PopClipRect();
+      return moved;
+    }
+  } // namespace detail
+
+  inline bool DrawMinimap(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    State* state,
+    MinimapState* minimap,
+    ImTextureRef overview,
+    const ImVec2& uv0,
+    const ImVec2& uv1)
+  {
+    ImVec2 min, max;
+    detail::MinimapRect(view, *minimap, &min, &max);
+    if (max.x <= min.x || max.y <= min.y)
+    {
+      return false;
+    }
+    drawList->AddRectFilled(min, max, minimap->frameColor);
+    drawList->AddImage(overview, min, max, uv0, uv1);
+    return detail::MinimapInteract(drawList, view, min, max, state, minimap);
+  }
+
+  template <typename LookupFn>
+  inline bool DrawMinimapTiles(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    State* state,
+    MinimapState* minimap,
+    const TileGrid& grid,
+    int layer,
+    LookupFn&& lookup)
+  {
+    ImVec2 min, max;
+    detail::MinimapRect(view, *minimap, &min, &max);
+    if (max.x <= min.x || max.y <= min.y)
+    {
+      return false;
+    }
+    drawList->AddRectFilled(min, max, minimap->frameColor);
+    const TileTexture tile{ lookup(TileKey{ layer, grid.levelCount - 1, 0, 0 }) };
+    if (tile.valid)
+    {
+      drawList->AddImage(tile.texRef, min, max, tile.uv0, tile.uv1);
+    }
+    return detail::MinimapInteract(drawList, view, min, max, state, minimap);
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_MINIMAP_H
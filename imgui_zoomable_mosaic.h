@@ -0,0 +1,332 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Mosaic
+// =============================
+// Many images placed side by side or overlapping in one zoomable view, e.g.
+// the fields of view of a slide scanner positioned from stage coordinates.
+//
+// Each image of a `Mosaic` has its own tile pyramid (`TileGrid`) and a
+// placement: the rectangle it covers in mosaic pixels, the image space of
+// the view, which starts at (0, 0). Images may be scaled by their
+// placement, and overlap: those with a higher `order` are drawn on top, and
+// for the same order, images added later are on top.
+//
+// Placements are bucketed in an `OverlayIndex`, so each frame only visits
+// the images under the view, whatever their number. Each visible image is
+// drawn at the pyramid level matching its own on-screen scale, from the
+// tiles of its part under the view, with the same coarser fallback as
+// `ZoomableTiles()`. Tiles are looked up with the image index as
+// `TileKey::layer`, so one `TileCache` or `TileAtlas` serves all of them.
+//
+// Usage
+// -----
+//    ImGuiImage::Mosaic mosaic;
+//    for (const Field& field : fields)
+//    {
+//      const ImVec2 min{ field.stageX - stageMinX, field.stageY - stageMinY };
+//      mosaic.Add(min, ImVec2(min.x + field.width, min.y + field.height),
+//        field.width, field.height);
+//    }
+//
+//    ...
+//
+//    ImGuiImage::ZoomableMosaic(mosaic, displaySize, &state,
+//      [&](const ImGuiImage::TileKey& key) -> ImGuiImage::TileTexture {
+//        // key.layer is the index of the field
+//        return LookupTile(key);
+//      });
+//
+
+#ifndef IMGUI_ZOOMABLE_MOSAIC_H
+#define IMGUI_ZOOMABLE_MOSAIC_H
+
+#include "imgui_zoomable_tiles.h"
+#include "imgui_zoomable_overlay.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Placement of an image in a mosaic.
+  //
+  // Members:
+  // - min, max: Rectangle covered by the image, in mosaic pixels.
+  // - order: Overlap order; images with a higher order are drawn on top.
+  struct MosaicPlacement
+  {
+    ImVec2 min;
+    ImVec2 max;
+    int order = 0;
+  };
+
+  // Set of images positioned in a common image space.
+  class Mosaic
+  {
+  public:
+    // Add an image of `width` x `height` pixels, tiled by `tileSize`, placed
+    // over the rectangle [min, max] of the mosaic. Returns its index, which
+    // is the layer of the keys of its tiles.
+    int Add(
+      const ImVec2& min,
+      const ImVec2& max,
+      int width,
+      int height,
+      int tileSize = 256,
+      int order = 0);
+
+    // Move an image or change its overlap order.
+    void SetPlacement(int image, const MosaicPlacement& placement);
+
+    void Clear();
+
+    int Size() const;
+    const MosaicPlacement& Placement(int image) const;
+    const TileGrid& Grid(int image) const;
+
+    // Size of the mosaic: the bottom right corner of the placements.
+    ImVec2 Extent() const;
+
+    // Append to `out` the images overlapping [min, max] (in mosaic pixels)
+    // in drawing order, bottom first.
+    void Visible(const ImVec2& min, const ImVec2& max, std::vector<int>* out) const;
+
+  private:
+    std::vector<MosaicPlacement> placements_;
+    std::vector<TileGrid> grids_;
+    // rebuilt on the first query after a change
+    mutable OverlayIndex index_;
+    mutable bool dirty_ = false;
+  };
+
+  // Draw the images of `mosaic` visible in the screen rectangle [clipMin,
+  // clipMax] of `view`, clipped to it, in overlap order. `view` maps mosaic
+  // pixels to the screen. `lookup(const TileKey&) -> TileTexture` is called
+  // for the visible tiles of each visible image, `TileKey::layer` being the
+  // image index; it must not block.
+  template <typename LookupFn>
+  void DrawMosaic(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    const Mosaic& mosaic,
+    LookupFn&& lookup,
+    const ImVec2& clipMin,
+    const ImVec2& clipMax,
+    const ImVec4& tintColor = kDefaultTintColor);
+
+  // Zoomable display of a mosaic
+  // ============================
+  // Same as `ZoomableTiles()` for the images of `mosaic`.
+  // `state->textureSize` is set to the extent of the mosaic.
+  template <typename LookupFn>
+  void ZoomableMosaic(
+    const Mosaic& mosaic,
+    const ImVec2& displaySize,
+    State* state,
+    LookupFn&& lookup,
+    const ImVec4& bgColor = kDefaultBackgroundColor,
+    const ImVec4& tintColor = kDefaultTintColor);
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  inline int Mosaic::Add(
+    const ImVec2& min,
+    const ImVec2& max,
+    int width,
+    int height,
+    int tileSize,
+    int order)
+  {
+    placements_.push_back(MosaicPlacement{ min, max, order });
+    grids_.emplace_back(width, height, tileSize);
+    dirty_ = true;
+    return static_cast<int>(placements_.size()) - 1;
+  }
+
+  inline void Mosaic::SetPlacement(int image, const MosaicPlacement& placement)
+  {
+    placements_[static_cast<std::size_t>(image)] = placement;
+    dirty_ = true;
+  }
+
+  inline void Mosaic::Clear()
+  {
+    placements_.clear();
+    grids_.clear();
+    index_.Clear();
+    dirty_ = false;
+  }
+
+  inline int Mosaic::Size() const
+  {
+    return static_cast<int>(placements_.size());
+  }
+
+  inline const MosaicPlacement& Mosaic::Placement(int image) const
+  {
+    return placements_[static_cast<std::size_t>(image)];
+  }
+
+  inline const TileGrid& Mosaic::Grid(int image) const
+  {
+    return grids_[static_cast<std::size_t>(image)];
+  }
+
+  inline ImVec2 Mosaic::Extent() const
+  {
+    ImVec2 extent{ 0.0f, 0.0f };
+    for (const MosaicPlacement& placement : placements_)
+    {
+      extent.x = std::max(extent.x, placement.max.x);
+      extent.y = std::max(extent.y, placement.max.y);
+    }
+    return extent;
+  }
+
+  inline void Mosaic::Visible(
+    const ImVec2& min,
+    const ImVec2& max,
+    std::vector<int>* out) const
+  {
+    if (dirty_)
+    {
+      index_.Build(placements_.size(), [this](std::size_t i, ImVec2* boxMin, ImVec2* boxMax) {
+        *boxMin = placements_[i].min;
+        *boxMax = placements_[i].max;
+      });
+      dirty_ = false;
+    }
+
+    const std::size_t first{ out->size() };
+    index_.Query(min, max, out);
+    std::sort(out->begin() + static_cast<std::ptrdiff_t>(first), out->end(),
+      [this](int a, int b) {
+        const int orderA{ placements_[static_cast<std::size_t>(a)].order };
+        const int orderB{ placements_[static_cast<std::size_t>(b)].order };
+        return orderA != orderB ? orderA < orderB : a < b;
+      });
+  }
+
+  template <typename LookupFn>
+  inline void DrawMosaic(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    const Mosaic& mosaic,
+    LookupFn&& lookup,
+    const ImVec2& clipMin,
+    const ImVec2& clipMax,
+    const ImVec4& tintColor)
+  {
+    if (clipMax.x <= clipMin.x || clipMax.y <= clipMin.y)
+    {
+      return;
+    }
+
+    ImVec2 visibleMin, visibleMax;
+    detail::ClipImageRect(view, clipMin, clipMax, &visibleMin, &visibleMax);
+    std::vector<int> images;
+    mosaic.Visible(visibleMin, visibleMax, &images);
+    const ImVec2 viewScale{ view.Scale() };
+
+    drawList->PushClipRect(clipMin, clipMax, true);
+    std::vector<TileKey> keys;
+    std::vector<detail::TileDraw> fallbacks;
+    std::vector<detail::TileDraw> tiles;
+    for (const int image : images)
+    {
+      const MosaicPlacement& placement{ mosaic.Placement(image) };
+      const TileGrid& grid{ mosaic.Grid(image) };
+      if (grid.width <= 0 || grid.height <= 0)
+      {
+        continue;
+      }
+
+      // mosaic pixels per image pixel, and visible part of the image in
+      // its own pixels
+      const ImVec2 scale{
+        (placement.max.x - placement.min.x) / static_cast<float>(grid.width),
+        (placement.max.y - placement.min.y) / static_cast<float>(grid.height) };
+      if (scale.x <= 0.0f || scale.y <= 0.0f)
+      {
+        continue;
+      }
+      const ImVec2 imageMin{
+        (std::max(visibleMin.x, placement.min.x) - placement.min.x) / scale.x,
+        (std::max(visibleMin.y, placement.min.y) - placement.min.y) / scale.y };
+      const ImVec2 imageMax{
+        (std::min(visibleMax.x, placement.max.x) - placement.min.x) / scale.x,
+        (std::min(visibleMax.y, placement.max.y) - placement.min.y) / scale.y };
+      const int level{ grid.LevelForScale(
+        std::max(viewScale.x * scale.x, viewScale.y * scale.y)) };
+
+      keys.clear();
+      grid.VisibleTiles(imageMin, imageMax, level, image, &keys);
+      fallbacks.clear();
+      tiles.clear();
+      detail::CollectTileDraws(grid, image, keys, lookup, tintColor,
+        placement.min, scale, &fallbacks, &tiles);
+
+      // each image is drawn whole before the next one so overlaps follow
+      // the drawing order
+      detail::DrawTiles(drawList, view, &fallbacks);
+      detail::DrawTiles(drawList, view, &tiles);
+    }
+    drawList->PopClipRect();
+  }
+
+  template <typename LookupFn>
+  inline void ZoomableMosaic(
+    const Mosaic& mosaic,
+    const ImVec2& displaySize,
+    State* state,
+    LookupFn&& lookup,
+    const ImVec4& bgColor,
+    const ImVec4& tintColor)
+  {
+    if (state != nullptr)
+    {
+      state->textureSize = mosaic.Extent();
+    }
+
+    ZoomableCustom(displaySize, state,
+      [&](ImDrawList* drawList, const ViewTransform& view) {
+        const ImVec2 screenMax{
+          view.screenPos.x + view.displaySize.x,
+          view.screenPos.y + view.displaySize.y };
+        if (bgColor.w > 0.0f)
+        {
+          drawList->AddRectFilled(view.screenPos, screenMax,
+            ImGui::GetColorU32(bgColor));
+        }
+        DrawMosaic(drawList, view, mosaic, lookup, view.screenPos, screenMax,
+          tintColor);
+      });
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_MOSAIC_H
@@ -0,0 +1,890 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Overlays
+// ===============================
+// Interaction with large sets of overlay objects (annotations, detections)
+// drawn over a zoomable view.
+//
+// Objects are axis-aligned boxes in image pixels (points are boxes of zero
+// size), identified by their index. Objects drawn later are on top, so the
+// top-most object is the one with the largest index.
+//
+// `OverlayIndex` buckets the objects in a uniform grid sized from their
+// count and extent, stored as flat arrays (one offset per cell, the object
+// indices of each cell in decreasing order). Picking only visits the cells
+// under the cursor and stops at the first hit of each, so it takes
+// microseconds whatever the number of objects. Objects spanning many cells
+// are kept in a separate list instead of being copied into each of them.
+//
+// Selections (`SelectRect()` from `imgui_zoomable_analysis.h`, or a
+// freehand lasso from `SelectLasso()`) are resolved against the index:
+// `SelectOverlay()` gathers the candidates overlapping the bounding box of
+// the region, then tests their centers against it on all cores. Polygon
+// edges are bucketed in horizontal bands, so each test only looks at the
+// few edges crossing the height of the point. The result is a list of
+// indices in increasing order or a bitset. `DrawOverlayHighlight()` draws
+// a selection in a handful of draw commands.
+//
+// Usage
+// -----
+//    ImGuiImage::OverlayIndex index;
+//    index.Build(boxes.size(), [&](std::size_t i, ImVec2* min, ImVec2* max) {
+//      *min = boxes[i].min;
+//      *max = boxes[i].max;
+//    });
+//
+//    ...
+//
+//    ImGuiImage::ZoomableCustom(displaySize, &state,
+//      [&](ImDrawList* drawList, const ImGuiImage::ViewTransform& view) {
+//        DrawImageAndBoxes(drawList, view);
+//        hovered = ImGuiImage::HoverOverlay(drawList, view, index, 4.0f,
+//          IM_COL32(255, 255, 0, 255), [&](int i) {
+//            ImGui::Text("%s (%.2f)", boxes[i].label, boxes[i].score);
+//          });
+//      });
+//
+//    // relabel the detections inside a lasso
+//    ImGuiImage::LassoSelection lasso;
+//    std::vector<int> selected;
+//
+//    ...
+//
+//    // in the draw callback
+//    if (ImGuiImage::SelectLasso(drawList, view, &lasso) && !lasso.dragging)
+//    {
+//      ImGuiImage::SelectOverlay(index, lasso.points.data(),
+//        lasso.points.size(), &selected);
+//    }
+//    ImGuiImage::DrawOverlayHighlight(drawList, view, index, selected);
+//
+
+#ifndef IMGUI_ZOOMABLE_OVERLAY_H
+#define IMGUI_ZOOMABLE_OVERLAY_H
+
+#include "imgui_zoomable_analysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Spatial index of overlay objects for picking.
+  class OverlayIndex
+  {
+  public:
+    // Index `count` objects; `bounds(i, &min, &max)` gives the box of object
+    // `i` in image pixels. Replaces the previous contents.
+    template <typename BoundsFn>
+    void Build(std::size_t count, BoundsFn&& bounds);
+
+    // Index `count` points.
+    void Build(const ImVec2* points, std::size_t count);
+
+    void Clear();
+
+    std::size_t Size() const;
+    const ImVec2& Min(int object) const;
+    const ImVec2& Max(int object) const;
+
+    // Index of the top-most object within `tolerance` image pixels (along
+    // each axis) of `point`, or -1 if there is none. Objects containing the
+    // point are at distance 0.
+    int Pick(const ImVec2& point, const ImVec2& tolerance) const;
+
+    // Append to `out` the objects whose box overlaps [min, max], each once,
+    // in no particular order, and their boxes (min, max) to `boxes` if not
+    // null; reading them from there is faster than `Min()` and `Max()` in
+    // that order.
+    void Query(
+      const ImVec2& min,
+      const ImVec2& max,
+      std::vector<int>* out,
+      std::vector<ImVec4>* boxes = nullptr) const;
+
+  private:
+    // Cell column or row of a coordinate, and cell range covered by a box,
+    // clamped to the grid.
+    int Cell(float value, float origin, int cells) const;
+    void CellRange(const ImVec2& min, const ImVec2& max,
+      int* x0, int* y0, int* x1, int* y1) const;
+
+    static bool Hit(const ImVec4& box, const ImVec2& point, const ImVec2& tolerance);
+
+    std::vector<ImVec2> min_;
+    std::vector<ImVec2> max_;
+    ImVec2 origin_ = ImVec2(0.0f, 0.0f);
+    float cellSize_ = 1.0f;
+    int cols_ = 0;
+    int rows_ = 0;
+    std::vector<std::uint32_t> cellStart_; // cols_ * rows_ + 1 offsets
+    std::vector<int> cellObjects_;         // decreasing index in each cell
+    std::vector<ImVec4> cellBoxes_;        // box of each entry, for locality
+    std::vector<int> large_;               // decreasing index
+  };
+
+  // Pick the object under the mouse within `tolerance` screen pixels, so
+  // the reach follows the zoom level, and outline it with `color`. Call it
+  // from the draw callback of `ZoomableCustom()`, after the overlay. When an
+  // object is hovered, `tooltip(index)` is called inside a tooltip window.
+  // Returns the index of the hovered object, or -1.
+  IMGUI_API int HoverOverlay(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    const OverlayIndex& index,
+    float tolerance = 4.0f,
+    ImU32 color = IM_COL32(255, 255, 0, 255),
+    const std::function<void(int)>& tooltip = nullptr);
+
+  // Freehand region selected with `SelectLasso()`, in image pixels.
+  //
+  // Members:
+  // - points: Vertices of the polygon, closed implicitly.
+  // - valid: Whether there is a selection (at least three points).
+  // - dragging: Whether the lasso is being drawn.
+  struct LassoSelection
+  {
+    std::vector<ImVec2> points;
+    bool valid = false;
+    bool dragging = false;
+  };
+
+  // Edit and draw a lasso selection, as `SelectRect()` does for rectangles:
+  // dragging with `button` over the image draws the outline (a vertex every
+  // few screen pixels), clicking without dragging clears it. Returns true
+  // when the selection changed this frame, including when the drag ends.
+  IMGUI_API bool SelectLasso(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    LassoSelection* selection,
+    ImGuiMouseButton button = ImGuiMouseButton_Right,
+    ImU32 color = IM_COL32(255, 255, 0, 255));
+
+  // Objects of `index` whose center lies inside a polygon (`count`
+  // vertices, closed implicitly, even-odd rule) or the rectangle [min, max].
+  // `selected` receives their indices in increasing order; `bits` one bit
+  // per object of the index (bit i of word i / 64).
+  IMGUI_API void SelectOverlay(
+    const OverlayIndex& index,
+    const ImVec2* polygon,
+    std::size_t count,
+    std::vector<int>* selected);
+
+  IMGUI_API void SelectOverlay(
+    const OverlayIndex& index,
+    const ImVec2* polygon,
+    std::size_t count,
+    std::vector<std::uint64_t>* bits);
+
+  IMGUI_API void SelectOverlay(
+    const OverlayIndex& index,
+    const ImVec2& min,
+    const ImVec2& max,
+    std::vector<int>* selected);
+
+  IMGUI_API void SelectOverlay(
+    const OverlayIndex& index,
+    const ImVec2& min,
+    const ImVec2& max,
+    std::vector<std::uint64_t>* bits);
+
+  // Draw the objects listed in `selected` that are in view as boxes filled
+  // with `color`, batched in a few draw commands. Objects smaller than
+  // `pointSize` screen pixels (and points) are drawn as squares of that
+  // size. Call it from the draw callback of `ZoomableCustom()`.
+  IMGUI_API void DrawOverlayHighlight(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    const OverlayIndex& index,
+    const std::vector<int>& selected,
+    ImU32 color = IM_COL32(255, 255, 0, 96),
+    float pointSize = 5.0f);
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  template <typename BoundsFn>
+  inline void OverlayIndex::Build(std::size_t count, BoundsFn&& bounds)
+  {
+    // objects covering more cells than this go to the large list
+    constexpr int kMaxCellsPerObject{ 16 };
+
+    Clear();
+    min_.resize(count);
+    max_.resize(count);
+    if (count == 0)
+    {
+      return;
+    }
+    ImVec2 lo{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+    ImVec2 hi{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+    double extent{ 0.0 };
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      ImVec2& a{ min_[i] };
+      ImVec2& b{ max_[i] };
+      bounds(i, &a, &b);
+      if (b.x < a.x) { std::swap(a.x, b.x); }
+      if (b.y < a.y) { std::swap(a.y, b.y); }
+      lo.x = std::min(lo.x, a.x);
+      lo.y = std::min(lo.y, a.y);
+      hi.x = std::max(hi.x, b.x);
+      hi.y = std::max(hi.y, b.y);
+      extent += std::max(b.x - a.x, b.y - a.y);
+    }
+
+    // about two objects per cell when they are spread evenly, and cells at
+    // least as large as an average object so most of them touch few cells
+    const double width{ std::max(1.0f, hi.x - lo.x) };
+    const double height{ std::max(1.0f, hi.y - lo.y) };
+    double cell{ std::max(std::sqrt(width * height * 2.0 / static_cast<double>(count)),
+      extent / static_cast<double>(count)) };
+    origin_ = lo;
+    cellSize_ = static_cast<float>(cell);
+    cols_ = static_cast<int>(width / cell) + 1;
+    rows_ = static_cast<int>(height / cell) + 1;
+
+    // counting sort of the objects into cells
+    cellStart_.assign(static_cast<std::size_t>(cols_) * rows_ + 1, 0);
+    std::vector<unsigned char> isLarge(count, 0);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      int x0, y0, x1, y1;
+      CellRange(min_[i], max_[i], &x0, &y0, &x1, &y1);
+      if ((x1 - x0 + 1) * (y1 - y0 + 1) > kMaxCellsPerObject)
+      {
+        isLarge[i] = 1;
+        continue;
+      }
+      for (int y = y0; y <= y1; ++y)
+      {
+        for (int x = x0; x <= x1; ++x)
+        {
+          ++cellStart_[static_cast<std::size_t>(y) * cols_ + x + 1];
+        }
+      }
+    }
+    for (std::size_t c = 1; c < cellStart_.size(); ++c)
+    {
+      cellStart_[c] += cellStart_[c - 1];
+    }
+    cellObjects_.resize(cellStart_.back());
+    cellBoxes_.resize(cellStart_.back());
+    std::vector<std::uint32_t> fill(cellStart_.begin(), cellStart_.end() - 1);
+    for (std::size_t j = count; j-- > 0;)
+    { // decreasing order, so the top-most object of a cell comes first
+      const int i{ static_cast<int>(j) };
+      if (isLarge[j] != 0)
+      {
+        large_.push_back(i);
+        continue;
+      }
+      int x0, y0, x1, y1;
+      CellRange(min_[j], max_[j], &x0, &y0, &x1, &y1);
+      const ImVec4 box{ min_[j].x, min_[j].y, max_[j].x, max_[j].y };
+      for (int y = y0; y <= y1; ++y)
+      {
+        for (int x = x0; x <= x1; ++x)
+        {
+          const std::uint32_t k{ fill[static_cast<std::size_t>(y) * cols_ + x]++ };
+          cellObjects_[k] = i;
+          cellBoxes_[k] = box;
+        }
+      }
+    }
+  }
+
+  inline void OverlayIndex::Build(const ImVec2* points, std::size_t count)
+  {
+    Build(count, [points](std::size_t i, ImVec2* min, ImVec2* max) {
+      *min = points[i];
+      *max = points[i];
+    });
+  }
+
+  inline void OverlayIndex::Clear()
+  {
+    min_.clear();
+    max_.clear();
+    cols_ = 0;
+    rows_ = 0;
+    cellStart_.clear();
+    cellObjects_.clear();
+    cellBoxes_.clear();
+    large_.clear();
+  }
+
+  inline std::size_t OverlayIndex::Size() const
+  {
+    return min_.size();
+  }
+
+  inline const ImVec2& OverlayIndex::Min(int object) const
+  {
+    return min_[static_cast<std::size_t>(object)];
+  }
+
+  inline const ImVec2& OverlayIndex::Max(int object) const
+  {
+    return max_[static_cast<std::size_t>(object)];
+  }
+
+  inline int OverlayIndex::Cell(float value, float origin, int cells) const
+  {
+    const float c{ std::floor((value - origin) / cellSize_) };
+    return static_cast<int>(std::clamp(c, 0.0f, static_cast<float>(cells - 1)));
+  }
+
+  inline void OverlayIndex::CellRange(
+    const ImVec2& min,
+    const ImVec2& max,
+    int* x0,
+    int* y0,
+    int* x1,
+    int* y1) const
+  {
+    *x0 = Cell(min.x, origin_.x, cols_);
+    *y0 = Cell(min.y, origin_.y, rows_);
+    *x1 = Cell(max.x, origin_.x, cols_);
+    *y1 = Cell(max.y, origin_.y, rows_);
+  }
+
+  inline bool OverlayIndex::Hit(const ImVec4& box, const ImVec2& point, const ImVec2& tolerance)
+  {
+    // distance to the box along each axis, relative to the tolerance
+    const float dx{ std::max(0.0f, std::max(box.x - point.x, point.x - box.z)) };
+    const float dy{ std::max(0.0f, std::max(box.y - point.y, point.y - box.w)) };
+    if (dx == 0.0f && dy == 0.0f)
+    {
+      return true;
+    }
+    if (tolerance.x <= 0.0f || tolerance.y <= 0.0f)
+    {
+      return false;
+    }
+    const float nx{ dx / tolerance.x };
+    const float ny{ dy / tolerance.y };
+    return nx * nx + ny * ny <= 1.0f;
+  }
+
+  inline int OverlayIndex::Pick(const ImVec2& point, const ImVec2& tolerance) const
+  {
+    if (min_.empty() || std::isnan(point.x) || std::isnan(point.y))
+    {
+      return -1;
+    }
+    int best{ -1 };
+    int x0, y0, x1, y1;
+    CellRange(ImVec2(point.x - tolerance.x, point.y - tolerance.y),
+      ImVec2(point.x + tolerance.x, point.y + tolerance.y), &x0, &y0, &x1, &y1);
+    for (int y = y0; y <= y1; ++y)
+    {
+      for (int x = x0; x <= x1; ++x)
+      {
+        const std::size_t c{ static_cast<std::size_t>(y) * cols_ + x };
+        for (std::uint32_t k = cellStart_[c]; k < cellStart_[c + 1]; ++k)
+        {
+          const int object{ cellObjects_[k] };
+          if (object <= best)
+          { // the rest of the cell is below the best hit
+            break;
+          }
+          if (Hit(cellBoxes_[k], point, tolerance))
+          {
+            best = object;
+            break;
+          }
+        }
+      }
+    }
+    for (int object : large_)
+    {
+      if (object <= best)
+      {
+        break;
+      }
+      const ImVec2& a{ min_[static_cast<std::size_t>(object)] };
+      const ImVec2& b{ max_[static_cast<std::size_t>(object)] };
+      if (Hit(ImVec4(a.x, a.y, b.x, b.y), point, tolerance))
+      {
+        best = object;
+        break;
+      }
+    }
+    return best;
+  }
+
+  inline void OverlayIndex::Query(
+    const ImVec2& min,
+    const ImVec2& max,
+    std::vector<int>* out,
+    std::vector<ImVec4>* boxes) const
+  {
+    if (min_.empty())
+    {
+      return;
+    }
+    auto overlaps = [&](const ImVec4& box) {
+      return box.x <= max.x && box.z >= min.x && box.y <= max.y && box.w >= min.y;
+    };
+    int x0, y0, x1, y1;
+    CellRange(min, max, &x0, &y0, &x1, &y1);
+    for (int y = y0; y <= y1; ++y)
+    {
+      for (int x = x0; x <= x1; ++x)
+      {
+        const std::size_t c{ static_cast<std::size_t>(y) * cols_ + x };
+        for (std::uint32_t k = cellStart_[c]; k < cellStart_[c + 1]; ++k)
+        {
+          const ImVec4& box{ cellBoxes_[k] };
+          if (!overlaps(box))
+          {
+            continue;
+          }
+          // objects spanning several cells are reported by the cell holding
+          // the top-left corner of their overlap with the query
+          if ((x == x0 || Cell(std::max(box.x, min.x), origin_.x, cols_) == x) &&
+              (y == y0 || Cell(std::max(box.y, min.y), origin_.y, rows_) == y))
+          {
+            out->push_back(cellObjects_[k]);
+            if (boxes != nullptr)
+            {
+              boxes->push_back(box);
+            }
+          }
+        }
+      }
+    }
+    for (int object : large_)
+    {
+      const ImVec2& a{ min_[static_cast<std::size_t>(object)] };
+      const ImVec2& b{ max_[static_cast<std::size_t>(object)] };
+      const ImVec4 box{ a.x, a.y, b.x, b.y };
+      if (overlaps(box))
+      {
+        out->push_back(object);
+        if (boxes != nullptr)
+        {
+          boxes->push_back(box);
+        }
+      }
+    }
+  }
+
+  inline int HoverOverlay(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    const OverlayIndex& index,
+    float tolerance,
+    ImU32 color,
+    const std::function<void(int)>& tooltip)
+  {
+    const ImVec2 screenMax{
+      view.screenPos.x + view.displaySize.x,
+      view.screenPos.y + view.displaySize.y };
+    if (!ImGui::IsWindowHovered() || !ImGui::IsMouseHoveringRect(view.screenPos, screenMax))
+    {
+      return -1;
+    }
+
+    // the mouse position of `State` is only updated after the callback
+    const ImVec2 scale{ view.Scale() };
+    const ImVec2 point{ view.ScreenToImage(ImGui::GetIO().MousePos) };
+    const int object{ index.Pick(point, ImVec2(tolerance / scale.x, tolerance / scale.y)) };
+    if (object < 0)
+    {
+      return -1;
+    }
+
+    if (drawList != nullptr)
+    {
+      const ImVec2& a{ index.Min(object) };
+      const ImVec2& b{ index.Max(object) };
+      drawList->PushClipRect(view.screenPos, screenMax, true);
+      if (a.x == b.x && a.y == b.y)
+      {
+        drawList->AddCircle(view.ImageToScreen(a), tolerance, color, 0, 2.0f);
+      }
+      else
+      {
+        drawList->AddQuad(
+          view.ImageToScreen(a), view.ImageToScreen(ImVec2(b.x, a.y)),
+          view.ImageToScreen(b), view.ImageToScreen(ImVec2(a.x, b.y)),
+          color, 2.0f);
+      }
+      drawList->PopClipRect();
+    }
+    if (tooltip && ImGui::BeginTooltip())
+    {
+      tooltip(object);
+      ImGui::EndTooltip();
+    }
+    return object;
+  }
+
+  inline bool SelectLasso(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    LassoSelection* selection,
+    ImGuiMouseButton button,
+    ImU32 color)
+  {
+    constexpr float kMinSpacing{ 3.0f }; // screen pixels between vertices
+    const ImVec2 screenMax{
+      view.screenPos.x + view.displaySize.x,
+      view.screenPos.y + view.displaySize.y };
+    const ImVec2 mouse{ ImGui::GetIO().MousePos };
+    const bool hovered{ ImGui::IsWindowHovered() &&
+      ImGui::IsMouseHoveringRect(view.screenPos, screenMax) };
+    // vertices are clamped to the image
+    auto mouseInImage = [&]() {
+      const ImVec2 p{ view.ScreenToImage(mouse) };
+      return ImVec2(
+        std::clamp(p.x, 0.0f, view.textureSize.x),
+        std::clamp(p.y, 0.0f, view.textureSize.y));
+    };
+
+    bool changed{ false };
+    if (hovered && ImGui::IsMouseClicked(button))
+    {
+      changed = selection->valid;
+      selection->points.assign(1, mouseInImage());
+      selection->valid = false;
+      selection->dragging = true;
+    }
+    if (selection->dragging)
+    {
+      if (ImGui::IsMouseDown(button))
+      {
+        const ImVec2 last{ view.ImageToScreen(selection->points.back()) };
+        const float dx{ mouse.x - last.x };
+        const float dy{ mouse.y - last.y };
+        if (dx * dx + dy * dy >= kMinSpacing * kMinSpacing)
+        {
+          selection->points.push_back(mouseInImage());
+        }
+      }
+      else
+      { // the region is final when the button is released
+        selection->dragging = false;
+        selection->valid = selection->points.size() >= 3;
+        if (!selection->valid)
+        {
+          selection->points.clear();
+        }
+        changed = true;
+      }
+    }
+
+    const std::size_t count{ selection->points.size() };
+    if (drawList != nullptr && count >= 2)
+    {
+      std::vector<ImVec2> outline(count);
+      view.ImageToScreenTransform().Apply(selection->points.data(), count, outline.data());
+      drawList->PushClipRect(view.screenPos, screenMax, true);
+      drawList->AddPolyline(outline.data(), static_cast<int>(count), color,
+        selection->dragging ? ImDrawFlags_None : ImDrawFlags_Closed, 1.0f);
+      drawList->PopClipRect();
+    }
+    return changed;
+  }
+
+  namespace detail
+  {
+    // Polygon with its edges bucketed in horizontal bands for fast
+    // point-in-polygon tests.
+    class BandedPolygon
+    {
+    public:
+      BandedPolygon(const ImVec2* points, std::size_t count)
+        : count_(count)
+      {
+        min_ = max_ = count > 0 ? points[0] : ImVec2(0.0f, 0.0f);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          min_.x = std::min(min_.x, points[i].x);
+          min_.y = std::min(min_.y, points[i].y);
+          max_.x = std::max(max_.x, points[i].x);
+          max_.y = std::max(max_.y, points[i].y);
+        }
+        bands_ = static_cast<int>(std::clamp<std::size_t>(count, 1, 1024));
+        bandHeight_ = std::max(max_.y - min_.y, 1e-6f) / static_cast<float>(bands_);
+
+        // edges per band, as offsets into a flat list
+        start_.assign(static_cast<std::size_t>(bands_) + 1, 0);
+        for (int pass = 0; pass < 2; ++pass)
+        {
+          std::vector<std::uint32_t> fill(start_.begin(), start_.end() - 1);
+          for (std::size_t i = 0; i < count; ++i)
+          {
+            const ImVec2& a{ points[i] };
+            const ImVec2& b{ points[(i + 1) % count] };
+            const int b0{ Band(std::min(a.y, b.y)) };
+            const int b1{ a.y != b.y ? Band(std::max(a.y, b.y)) : b0 - 1 };
+            for (int band = b0; band <= b1; ++band)
+            {
+              if (pass == 0)
+              {
+                ++start_[static_cast<std::size_t>(band) + 1];
+              }
+              else if (a.y != b.y)
+              { // horizontal edges are never crossed
+                edges_[fill[static_cast<std::size_t>(band)]++] =
+                  Edge{ a.y, b.y, a.x, (b.x - a.x) / (b.y - a.y) };
+              }
+            }
+          }
+          if (pass == 0)
+          {
+            for (std::size_t band = 1; band < start_.size(); ++band)
+            {
+              start_[band] += start_[band - 1];
+            }
+            edges_.resize(start_.back());
+          }
+        }
+      }
+
+      const ImVec2& Min() const { return min_; }
+      const ImVec2& Max() const { return max_; }
+
+      // Even-odd rule: count the edges crossed by a ray towards +x.
+      bool Contains(const ImVec2& p) const
+      {
+        if (count_ < 3 || p.x < min_.x || p.x > max_.x || p.y < min_.y || p.y > max_.y)
+        {
+          return false;
+        }
+        const std::size_t band{ static_cast<std::size_t>(Band(p.y)) };
+        bool inside{ false };
+        for (std::uint32_t k = start_[band]; k < start_[band + 1]; ++k)
+        {
+          const Edge& e{ edges_[k] };
+          if ((e.ay > p.y) != (e.by > p.y) && p.x < e.ax + (p.y - e.ay) * e.slope)
+          {
+            inside = !inside;
+          }
+        }
+        return inside;
+      }
+
+    private:
+      // Edge from (ax, ay) to a point at height by, with its dx / dy.
+      struct Edge
+      {
+        float ay, by, ax, slope;
+      };
+
+      int Band(float y) const
+      {
+        const int band{ static_cast<int>((y - min_.y) / bandHeight_) };
+        return std::clamp(band, 0, bands_ - 1);
+      }
+
+      std::size_t count_;
+      ImVec2 min_;
+      ImVec2 max_;
+      int bands_ = 1;
+      float bandHeight_ = 1.0f;
+      std::vector<std::uint32_t> start_;
+      std::vector<Edge> edges_; // copied per band they cross
+    };
+
+    // Set the bits of the objects overlapping [min, max] whose center
+    // passes `inside`, testing the candidates in parallel.
+    template <typename InsideFn>
+    inline void SelectOverlayBits(
+      const OverlayIndex& index,
+      const ImVec2& min,
+      const ImVec2& max,
+      InsideFn&& inside,
+      std::vector<std::uint64_t>* bits)
+    {
+      constexpr int kBlock{ 4096 };
+      bits->assign((index.Size() + 63) / 64, 0);
+      std::vector<int> candidates;
+      std::vector<ImVec4> boxes;
+      index.Query(min, max, &candidates, &boxes);
+      const int count{ static_cast<int>(candidates.size()) };
+      std::vector<unsigned char> hit(candidates.size());
+      ParallelFor(0, (count + kBlock - 1) / kBlock, [&](int block) {
+        const int end{ std::min(count, (block + 1) * kBlock) };
+        for (int k = block * kBlock; k < end; ++k)
+        {
+          const ImVec4& box{ boxes[k] };
+          hit[k] = inside(ImVec2((box.x + box.z) * 0.5f, (box.y + box.w) * 0.5f)) ? 1 : 0;
+        }
+      });
+      // objects may share words, so the bits are set by this thread only
+      for (int k = 0; k < count; ++k)
+      {
+        if (hit[k] != 0)
+        {
+          const std::size_t object{ static_cast<std::size_t>(candidates[k]) };
+          (*bits)[object / 64] |= std::uint64_t{ 1 } << (object % 64);
+        }
+      }
+    }
+
+    inline void BitsToIndices(const std::vector<std::uint64_t>& bits, std::vector<int>* indices)
+    {
+      indices->clear();
+      for (std::size_t w = 0; w < bits.size(); ++w)
+      {
+        for (std::uint64_t word = bits[w]; word != 0; word &= word - 1)
+        {
+          int bit{ 0 };
+          while (((word >> bit) & 1) == 0)
+          {
+            ++bit;
+          }
+          indices->push_back(static_cast<int>(w * 64) + bit);
+        }
+      }
+    }
+  } // namespace detail
+
+  inline void SelectOverlay(
+    const OverlayIndex& index,
+    const ImVec2* polygon,
+    std::size_t count,
+    std::vector<std::uint64_t>* bits)
+  {
+    const detail::BandedPolygon region(polygon, count);
+    detail::SelectOverlayBits(index, region.Min(), region.Max(),
+      [&](const ImVec2& p) { return region.Contains(p); }, bits);
+  }
+
+  inline void SelectOverlay(
+    const OverlayIndex& index,
+    const ImVec2* polygon,
+    std::size_t count,
+    std::vector<int>* selected)
+  {
+    std::vector<std::uint64_t> bits;
+    SelectOverlay(index, polygon, count, &bits);
+    detail::BitsToIndices(bits, selected);
+  }
+
+  inline void SelectOverlay(
+    const OverlayIndex& index,
+    const ImVec2& min,
+    const ImVec2& max,
+    std::vector<std::uint64_t>* bits)
+  {
+    detail::SelectOverlayBits(index, min, max,
+      [&](const ImVec2& p) {
+        return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y;
+      }, bits);
+  }
+
+  inline void SelectOverlay(
+    const OverlayIndex& index,
+    const ImVec2& min,
+    const ImVec2& max,
+    std::vector<int>* selected)
+  {
+    std::vector<std::uint64_t> bits;
+    SelectOverlay(index, min, max, &bits);
+    detail::BitsToIndices(bits, selected);
+  }
+
+  inline void DrawOverlayHighlight(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    const OverlayIndex& index,
+    const std::vector<int>& selected,
+    ImU32 color,
+    float pointSize)
+  {
+    // quads per reservation, within the 16-bit vertex index range
+    constexpr int kBatch{ 8192 };
+    ImVec2 visibleMin, visibleMax;
+    view.VisibleImageRect(&visibleMin, &visibleMax);
+    const AffineTransform toScreen{ view.ImageToScreenTransform() };
+    const ImVec2 scale{ view.Scale() };
+    const float half{ pointSize * 0.5f };
+    const ImVec2 uv{ ImGui::GetFontTexUvWhitePixel() };
+
+    const ImVec2 screenMax{
+      view.screenPos.x + view.displaySize.x,
+      view.screenPos.y + view.displaySize.y };
+    drawList->PushClipRect(view.screenPos, screenMax, true);
+    std::size_t next{ 0 };
+    std::vector<int> batch;
+    batch.reserve(kBatch);
+    while (next < selected.size())
+    {
+      batch.clear();
+      for (; next < selected.size() && static_cast<int>(batch.size()) < kBatch; ++next)
+      {
+        const int object{ selected[next] };
+        const ImVec2& a{ index.Min(object) };
+        const ImVec2& b{ index.Max(object) };
+        if (a.x <= visibleMax.x && b.x >= visibleMin.x &&
+            a.y <= visibleMax.y && b.y >= visibleMin.y)
+        {
+          batch.push_back(object);
+        }
+      }
+      const int quads{ static_cast<int>(batch.size()) };
+      if (quads == 0)
+      {
+        continue;
+      }
+      drawList->PrimReserve(quads * 6, quads * 4);
+      for (int object : batch)
+      {
+        const ImVec2& a{ index.Min(object) };
+        const ImVec2& b{ index.Max(object) };
+        if ((b.x - a.x) * scale.x < pointSize && (b.y - a.y) * scale.y < pointSize)
+        { // too small to see: a square around the center
+          const ImVec2 c{ toScreen.Apply(ImVec2((a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f)) };
+          drawList->PrimQuadUV(
+            ImVec2(c.x - half, c.y - half), ImVec2(c.x + half, c.y - half),
+            ImVec2(c.x + half, c.y + half), ImVec2(c.x - half, c.y + half),
+            uv, uv, uv, uv, color);
+        }
+        else
+        {
+          drawList->PrimQuadUV(
+            toScreen.Apply(a), toScreen.Apply(ImVec2(b.x, a.y)),
+            toScreen.Apply(b), toScreen.Apply(ImVec2(a.x, b.y)),
+            uv, uv, uv, uv, color);
+        }
+      }
+    }
+    drawList->PopClipRect();
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_OVERLAY_H
@@ -0,0 +1,508 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Resampling
+// =================================
+// Separable resampling of RGBA images (`IM_COL32` layout) with a choice of
+// filters, used to export regions at a chosen scale and to prepare filtered
+// images for zoomed-out views.
+//
+// Rows are processed in strips: source rows are read in order through a
+// callback, filtered horizontally, combined vertically and handed to another
+// callback in order, so only a strip of rows is held in memory whatever the
+// image size. Both passes run in parallel on the shared `ThreadPool` and use
+// SSE2 when available (see `IMGUI_ZOOMABLE_IMAGE_SSE2`).
+//
+// Usage
+// -----
+//    // downscale the whole image to 25%
+//    ImGuiImage::ResampleImage(pixels, width, height, width,
+//      ImVec2(0, 0), ImVec2(width, height),
+//      small, width / 4, height / 4, width / 4,
+//      ImGuiImage::ResampleFilter::Lanczos3);
+//
+
+#ifndef IMGUI_ZOOMABLE_RESAMPLE_H
+#define IMGUI_ZOOMABLE_RESAMPLE_H
+
+#include "imgui_zoomable_tiles.h"
+
+#include <cstring>
+#include <vector>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Resampling filters.
+  //
+  // - Nearest: Nearest source pixel, no filtering.
+  // - Bilinear: Tent filter, widened when minifying.
+  // - Area: Average of the source pixels covered by each output pixel.
+  // - Lanczos3: Windowed sinc with 3 lobes, the sharpest, may ring slightly
+  //             at hard edges.
+  enum class ResampleFilter
+  {
+    Nearest,
+    Bilinear,
+    Area,
+    Lanczos3,
+  };
+
+  // Contributions of the source pixels to each output pixel along one axis.
+  //
+  // Output pixel `i` reads source pixels [first[i], first[i] + count[i])
+  // with the weights starting at `weights[i * taps]`.
+  struct ResampleWeights
+  {
+    int taps = 0;
+    std::vector<int> first;
+    std::vector<int> count;
+    std::vector<float> weights;
+
+    // Map `outputSize` pixels onto the source interval [srcMin, srcMax) of
+    // an axis of `srcSize` pixels. Pixels beyond the source edges repeat the
+    // edge pixels.
+    void Compute(
+      ResampleFilter filter,
+      float srcMin,
+      float srcMax,
+      int srcSize,
+      int outputSize);
+
+    int OutputSize() const;
+
+    // Source pixels [*begin, *end) read by the output pixels [o0, o1).
+    void SourceRange(int o0, int o1, int* begin, int* end) const;
+  };
+
+  // Resample the source rectangle [srcMin, srcMax) (in pixels, may be
+  // fractional) of a `srcWidth` x `srcHeight` image to `outWidth` x
+  // `outHeight` pixels, streaming rows.
+  //
+  // - `readRow(int y, int x0, int x1, ImU32* dst)` stores the source pixels
+  //   [x0, x1) of row `y` to `dst`. Rows are read in increasing order, each
+  //   once, always from the calling thread.
+  // - `writeRow(int y, const ImU32* row)` receives the output rows in order,
+  //   on the calling thread.
+  //
+  // Memory use is about `stripRows` output rows plus the source rows they
+  // need. With `parallel`, the filtering runs on the shared `ThreadPool`.
+  template <typename ReadRowFn, typename WriteRowFn>
+  void ResampleRows(
+    int srcWidth,
+    int srcHeight,
+    const ImVec2& srcMin,
+    const ImVec2& srcMax,
+    int outWidth,
+    int outHeight,
+    ResampleFilter filter,
+    ReadRowFn&& readRow,
+    WriteRowFn&& writeRow,
+    int stripRows = 64,
+    bool parallel = true);
+
+  // Resample between images in memory. Strides are in pixels.
+  IMGUI_API void ResampleImage(
+    const ImU32* src,
+    int srcWidth,
+    int srcHeight,
+    int srcStride,
+    const ImVec2& srcMin,
+    const ImVec2& srcMax,
+    ImU32* dst,
+    int outWidth,
+    int outHeight,
+    int dstStride,
+    ResampleFilter filter,
+    bool parallel = true);
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  namespace detail
+  {
+    inline float ResampleKernel(ResampleFilter filter, float x)
+    {
+      x = std::fabs(x);
+      switch (filter)
+      {
+      case ResampleFilter::Bilinear:
+        return x < 1.0f ? 1.0f - x : 0.0f;
+      case ResampleFilter::Lanczos3:
+      {
+        if (x < 1e-6f)
+        {
+          return 1.0f;
+        }
+        if (x >= 3.0f)
+        {
+          return 0.0f;
+        }
+        const float pi{ 3.14159265358979f };
+        const float a{ pi * x };
+        return 3.0f * std::sin(a) * std::sin(a / 3.0f) / (a * a);
+      }
+      default:
+        return 0.0f;
+      }
+    }
+
+    // Accumulate `weight` times a source pixel into `acc` (R, G, B, A).
+    inline void AccumulatePixel(float* acc, ImU32 pixel, float weight)
+    {
+      acc[0] += weight * static_cast<float>(pixel & 0xFF);
+      acc[1] += weight * static_cast<float>((pixel >> 8) & 0xFF);
+      acc[2] += weight * static_cast<float>((pixel >> 16) & 0xFF);
+      acc[3] += weight * static_cast<float>(pixel >> 24);
+    }
+
+    // Filter a source row (pixels from `x0`) to `weights.OutputSize()`
+    // pixels of 4 floats.
+    inline void ResampleRowHorizontal(
+      const ResampleWeights& weights,
+      const ImU32* src,
+      int x0,
+      float* dst)
+    {
+      const int outWidth{ weights.OutputSize() };
+      for (int i = 0; i < outWidth; ++i)
+      {
+        const ImU32* px{ src + (weights.first[i] - x0) };
+        const float* w{ &weights.weights[static_cast<std::size_t>(i) * weights.taps] };
+        const int count{ weights.count[i] };
+#if defined(IMGUI_ZOOMABLE_IMAGE_SSE2)
+        const __m128i zero{ _mm_setzero_si128() };
+        __m128 acc{ _mm_setzero_ps() };
+        for (int t = 0; t < count; ++t)
+        {
+          const __m128i p{ _mm_unpacklo_epi16(_mm_unpacklo_epi8(
+            _mm_cvtsi32_si128(static_cast<int>(px[t])), zero), zero) };
+          acc = _mm_add_ps(acc, _mm_mul_ps(_mm_cvtepi32_ps(p), _mm_set1_ps(w[t])));
+        }
+        _mm_storeu_ps(dst + 4 * i, acc);
+#else
+        float* acc{ dst + 4 * i };
+        acc[0] = acc[1] = acc[2] = acc[3] = 0.0f;
+        for (int t = 0; t < count; ++t)
+        {
+          AccumulatePixel(acc, px[t], w[t]);
+        }
+#endif
+      }
+    }
+
+    // Combine `count` filtered rows, `rowFloats` apart, into one output row.
+    inline void ResampleRowVertical(
+      const float* rows,
+      std::size_t rowFloats,
+      const float* w,
+      int count,
+      int width,
+      float* acc,
+      ImU32* dst)
+    {
+      const std::size_t n{ static_cast<std::size_t>(width) * 4 };
+      std::fill(acc, acc + n, 0.0f);
+      for (int t = 0; t < count; ++t)
+      {
+        const float* row{ rows + static_cast<std::size_t>(t) * rowFloats };
+        std::size_t i{ 0 };
+#if defined(IMGUI_ZOOMABLE_IMAGE_SSE2)
+        const __m128 weight{ _mm_set1_ps(w[t]) };
+        for (; i + 4 <= n; i += 4)
+        {
+          _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i),
+            _mm_mul_ps(_mm_loadu_ps(row + i), weight)));
+        }
+#endif
+        for (; i < n; ++i)
+        {
+          acc[i] += row[i] * w[t];
+        }
+      }
+
+      int x{ 0 };
+#if defined(IMGUI_ZOOMABLE_IMAGE_SSE2)
+      for (; x + 2 <= width; x += 2)
+      { // round, then saturate to [0, 255]
+        const __m128i lo{ _mm_cvtps_epi32(_mm_loadu_ps(acc + 4 * x)) };
+        const __m128i hi{ _mm_cvtps_epi32(_mm_loadu_ps(acc + 4 * x + 4)) };
+        const __m128i words{ _mm_packs_epi32(lo, hi) };
+        const __m128i bytes{ _mm_packus_epi16(words, words) };
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), bytes);
+      }
+#endif
+      for (; x < width; ++x)
+      {
+        ImU32 pixel{ 0 };
+        for (int c = 0; c < 4; ++c)
+        {
+          const float v{ std::clamp(acc[4 * x + c] + 0.5f, 0.0f, 255.0f) };
+          pixel |= static_cast<ImU32>(v) << (8 * c);
+        }
+        dst[x] = pixel;
+      }
+    }
+
+    template <typename Fn>
+    inline void ResampleFor(bool parallel, int begin, int end, int grain, Fn&& fn)
+    {
+      if (!parallel)
+      {
+        for (int i = begin; i < end; ++i)
+        {
+          fn(i);
+        }
+        return;
+      }
+      ParallelFor(begin, end, fn, grain);
+    }
+  }
+
+  inline void ResampleWeights::Compute(
+    ResampleFilter filter,
+    float srcMin,
+    float srcMax,
+    int srcSize,
+    int outputSize)
+  {
+    outputSize = std::max(0, outputSize);
+    first.assign(static_cast<std::size_t>(outputSize), 0);
+    count.assign(static_cast<std::size_t>(outputSize), 0);
+    if (outputSize == 0 || srcSize <= 0 || srcMax <= srcMin)
+    {
+      taps = 0;
+      weights.clear();
+      return;
+    }
+
+    const float step{ (srcMax - srcMin) / static_cast<float>(outputSize) };
+    // when minifying, widen the kernel to cover the output pixel footprint
+    const float stretch{ std::max(1.0f, step) };
+    float radius{ 0.5f };
+    switch (filter)
+    {
+    case ResampleFilter::Nearest:
+      radius = 0.0f;
+      break;
+    case ResampleFilter::Bilinear:
+      radius = stretch;
+      break;
+    case ResampleFilter::Area:
+      radius = 0.5f * stretch;
+      break;
+    case ResampleFilter::Lanczos3:
+      radius = 3.0f * stretch;
+      break;
+    }
+    taps = filter == ResampleFilter::Nearest ? 1 :
+      static_cast<int>(std::ceil(2.0f * radius)) + 1;
+    weights.assign(static_cast<std::size_t>(outputSize) * taps, 0.0f);
+
+    for (int i = 0; i < outputSize; ++i)
+    {
+      const float center{ srcMin + (static_cast<float>(i) + 0.5f) * step };
+      float* w{ &weights[static_cast<std::size_t>(i) * taps] };
+      if (filter == ResampleFilter::Nearest)
+      {
+        first[i] = std::clamp(static_cast<int>(std::floor(center)), 0, srcSize - 1);
+        count[i] = 1;
+        w[0] = 1.0f;
+        continue;
+      }
+
+      const int k0{ static_cast<int>(std::floor(center - radius)) };
+      first[i] = std::clamp(k0, 0, srcSize - 1);
+      float sum{ 0.0f };
+      for (int t = 0; t < taps; ++t)
+      {
+        const int k{ k0 + t };
+        float weight;
+        if (filter == ResampleFilter::Area)
+        { // overlap of source pixel [k, k + 1) with the footprint
+          weight = std::max(0.0f, std::min(static_cast<float>(k + 1), center + radius) -
+            std::max(static_cast<float>(k), center - radius));
+        }
+        else
+        {
+          weight = detail::ResampleKernel(filter,
+            (static_cast<float>(k) + 0.5f - center) / stretch);
+        }
+        if (weight == 0.0f)
+        {
+          continue;
+        }
+        // pixels beyond the edges repeat the edge pixels
+        const int index{ std::clamp(k, 0, srcSize - 1) - first[i] };
+        w[index] += weight;
+        count[i] = std::max(count[i], index + 1);
+        sum += weight;
+      }
+      if (count[i] == 0 || std::fabs(sum) < 1e-6f)
+      {
+        first[i] = std::clamp(static_cast<int>(std::floor(center)), 0, srcSize - 1);
+        count[i] = 1;
+        std::fill(w, w + taps, 0.0f);
+        w[0] = 1.0f;
+        continue;
+      }
+      for (int t = 0; t < count[i]; ++t)
+      {
+        w[t] /= sum;
+      }
+    }
+  }
+
+  inline int ResampleWeights::OutputSize() const
+  {
+    return static_cast<int>(first.size());
+  }
+
+  inline void ResampleWeights::SourceRange(int o0, int o1, int* begin, int* end) const
+  {
+    int b{ 0 }, e{ 0 };
+    for (int i = o0; i < o1; ++i)
+    {
+      b = i == o0 ? first[i] : std::min(b, first[i]);
+      e = std::max(e, first[i] + count[i]);
+    }
+    *begin = b;
+    *end = e;
+  }
+
+  template <typename ReadRowFn, typename WriteRowFn>
+  inline void ResampleRows(
+    int srcWidth,
+    int srcHeight,
+    const ImVec2& srcMin,
+    const ImVec2& srcMax,
+    int outWidth,
+    int outHeight,
+    ResampleFilter filter,
+    ReadRowFn&& readRow,
+    WriteRowFn&& writeRow,
+    int stripRows,
+    bool parallel)
+  {
+    ResampleWeights wx, wy;
+    wx.Compute(filter, srcMin.x, srcMax.x, srcWidth, outWidth);
+    wy.Compute(filter, srcMin.y, srcMax.y, srcHeight, outHeight);
+    if (wx.taps == 0 || wy.taps == 0)
+    {
+      return;
+    }
+    stripRows = std::max(1, stripRows);
+
+    int x0, x1;
+    wx.SourceRange(0, outWidth, &x0, &x1);
+    const std::size_t rawPixels{ static_cast<std::size_t>(x1 - x0) };
+    const std::size_t rowFloats{ static_cast<std::size_t>(outWidth) * 4 };
+
+    // largest number of source rows needed by a strip
+    int capacity{ 0 };
+    for (int j0 = 0; j0 < outHeight; j0 += stripRows)
+    {
+      int y0, y1;
+      wy.SourceRange(j0, std::min(outHeight, j0 + stripRows), &y0, &y1);
+      capacity = std::max(capacity, y1 - y0);
+    }
+
+    std::vector<ImU32> raw(static_cast<std::size_t>(capacity) * rawPixels);
+    std::vector<float> rows(static_cast<std::size_t>(capacity) * rowFloats);
+    std::vector<ImU32> out(static_cast<std::size_t>(stripRows) * outWidth);
+    int rowsFirst{ 0 };
+    int rowsCount{ 0 };
+
+    for (int j0 = 0; j0 < outHeight; j0 += stripRows)
+    {
+      const int j1{ std::min(outHeight, j0 + stripRows) };
+      int y0, y1;
+      wy.SourceRange(j0, j1, &y0, &y1);
+
+      // keep the filtered rows shared with the previous strip
+      const int keep{ std::clamp(rowsFirst + rowsCount - y0, 0, rowsCount) };
+      if (keep > 0 && y0 > rowsFirst)
+      {
+        std::memmove(rows.data(),
+          rows.data() + static_cast<std::size_t>(y0 - rowsFirst) * rowFloats,
+          static_cast<std::size_t>(keep) * rowFloats * sizeof(float));
+      }
+      const int readBegin{ y0 + keep };
+      for (int y = readBegin; y < y1; ++y)
+      {
+        readRow(y, x0, x1, raw.data() + static_cast<std::size_t>(y - readBegin) * rawPixels);
+      }
+      detail::ResampleFor(parallel, readBegin, y1, 4, [&](int y) {
+        detail::ResampleRowHorizontal(wx,
+          raw.data() + static_cast<std::size_t>(y - readBegin) * rawPixels, x0,
+          rows.data() + static_cast<std::size_t>(y - y0) * rowFloats);
+      });
+      rowsFirst = y0;
+      rowsCount = y1 - y0;
+
+      detail::ResampleFor(parallel, j0, j1, 4, [&](int j) {
+        thread_local std::vector<float> acc;
+        acc.resize(rowFloats);
+        detail::ResampleRowVertical(
+          rows.data() + static_cast<std::size_t>(wy.first[j] - y0) * rowFloats,
+          rowFloats, &wy.weights[static_cast<std::size_t>(j) * wy.taps],
+          wy.count[j], outWidth, acc.data(),
+          out.data() + static_cast<std::size_t>(j - j0) * outWidth);
+      });
+
+      for (int j = j0; j < j1; ++j)
+      {
+        writeRow(j, out.data() + static_cast<std::size_t>(j - j0) * outWidth);
+      }
+    }
+  }
+
+  inline void ResampleImage(
+    const ImU32* src,
+    int srcWidth,
+    int srcHeight,
+    int srcStride,
+    const ImVec2& srcMin,
+    const ImVec2& srcMax,
+    ImU32* dst,
+    int outWidth,
+    int outHeight,
+    int dstStride,
+    ResampleFilter filter,
+    bool parallel)
+  {
+    ResampleRows(srcWidth, srcHeight, srcMin, srcMax, outWidth, outHeight, filter,
+      [&](int y, int x0, int x1, ImU32* row) {
+        std::memcpy(row, src + static_cast<std::size_t>(y) * srcStride + x0,
+          static_cast<std::size_t>(x1 - x0) * sizeof(ImU32));
+      },
+      [&](int y, const ImU32* row) {
+        std::memcpy(dst + static_cast<std::size_t>(y) * dstStride, row,
+          static_cast<std::size_t>(outWidth) * sizeof(ImU32));
+      },
+      64, parallel);
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_RESAMPLE_H
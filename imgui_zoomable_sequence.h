@@ -0,0 +1,540 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Sequences
+// ================================
+// Playback of recorded frame sequences (time-lapses, image stacks) of any
+// length, decoded ahead of the playback clock on worker threads.
+//
+// A `FrameSequence` owns a ring of a fixed number of frame buffers. Each UI
+// frame, `Update()` advances a `PlaybackState` clock, shows the frame due if
+// it is decoded, and queues the decoding of the next frames in the playing
+// direction (forwards or backwards) into the buffers that are no longer
+// needed. Buffers are reused, so memory stays bounded by the ring size
+// whatever the length of the sequence, and decoding needs no allocation once
+// the buffers have grown to the frame size.
+//
+// When zoomed in, only the visible part of the frames needs decoding:
+// `SetRegion()` restricts decoding to the visible rectangle, rounded out to
+// a grid of `regionAlign` pixels (e.g. the tiles of the file) so small pans
+// do not discard the frames decoded ahead.
+//
+// When the frame due is not decoded in time, the previous frame stays on
+// screen and the clock waits for it instead of skipping frames; these
+// stalls are counted in `Stats`. The frame ids and due times passed to
+// `State` make `State::frameStats` report how late frames are drawn, and
+// frames skipped when the clock runs faster than the UI.
+//
+// The view is kept across frames: the widget state is not touched beyond
+// the frame id and timestamp, so zoom and pan stay put during playback.
+//
+// Usage
+// -----
+//    ImGuiImage::FrameSequence<Frame> sequence(frameCount, frameSize,
+//      [&](int index, const ImVec2& min, const ImVec2& max, Frame* frame) {
+//        return DecodeFrame(files[index], min, max, frame); // worker thread
+//      });
+//    ImGuiImage::PlaybackState playback;
+//    playback.fps = 30.0f;
+//    playback.playing = true;
+//
+//    ...
+//
+//    ImVec2 min, max;
+//    state.view.VisibleImageRect(&min, &max);
+//    sequence.SetRegion(min, max);
+//    const auto shown{ sequence.Update(&playback, &state) };
+//    if (shown.changed)
+//    {
+//      UploadTexture(texture, *shown.frame);
+//    }
+//    ImGuiImage::ZoomableCustom(displaySize, &state,
+//      [&](ImDrawList* drawList, const ImGuiImage::ViewTransform& view) {
+//        ImGuiImage::DrawImageRect(drawList, view, texture,
+//          shown.regionMin, shown.regionMax);
+//      });
+//
+
+#ifndef IMGUI_ZOOMABLE_SEQUENCE_H
+#define IMGUI_ZOOMABLE_SEQUENCE_H
+
+#include "imgui_zoomable_tiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Playback clock of a frame sequence, kept across frames.
+  //
+  // Members:
+  // - fps: Frames per second of the playback.
+  // - playing: Whether the clock runs.
+  // - reverse: Whether the sequence plays backwards.
+  // - loop: Whether playback wraps around at the ends; otherwise it stops.
+  // - position: Clock, in frames. Set it to seek.
+  // - frame: Index of the frame shown, set by `FrameSequence::Update()`
+  //          (-1 until the first frame is decoded).
+  struct PlaybackState
+  {
+    float fps = 30.0f;
+    bool playing = false;
+    bool reverse = false;
+    bool loop = true;
+    double position = 0.0;
+    int frame = -1;
+  };
+
+  // Frames of a sequence decoded ahead of playback into a ring of buffers.
+  //
+  // `Frame` is any default-constructible type holding decoded pixels, reused
+  // from one decode to the next. All methods are called from the UI thread.
+  template <typename Frame>
+  class FrameSequence
+  {
+  public:
+    // Decode the rectangle [min, max] (in frame pixels) of frame `index`
+    // into `frame`. Called on worker threads, one frame buffer per call.
+    using DecodeFn = std::function<bool(
+      int index, const ImVec2& min, const ImVec2& max, Frame* frame)>;
+
+    // Frame to display.
+    //
+    // Members:
+    // - frame: Decoded frame, valid until the next `Update()` (null until
+    //          the first frame is decoded).
+    // - index: Index of the frame.
+    // - regionMin, regionMax: Rectangle of the frame it holds.
+    // - changed: Whether it differs from the frame of the previous update.
+    struct Shown
+    {
+      const Frame* frame = nullptr;
+      int index = -1;
+      ImVec2 regionMin;
+      ImVec2 regionMax;
+      bool changed = false;
+    };
+
+    // Statistics
+    //
+    // - decoded: Frames decoded.
+    // - discarded: Queued decodes dropped because playback moved on.
+    // - failed: Decodes that returned false.
+    // - stalls: Times playback waited for a frame that was not decoded.
+    // - stalledSeconds: Total time spent waiting.
+    // - stalled: Whether playback is waiting now.
+    // - ready: Frames decoded ahead of the frame due.
+    struct Stats
+    {
+      std::uint64_t decoded = 0;
+      std::uint64_t discarded = 0;
+      std::uint64_t failed = 0;
+      std::uint64_t stalls = 0;
+      double stalledSeconds = 0.0;
+      bool stalled = false;
+      int ready = 0;
+    };
+
+    // `frameSize` is the size of the frames in pixels, and `ringSize` the
+    // number of frame buffers (at least 2: the frame shown and the next).
+    FrameSequence(
+      int frameCount,
+      const ImVec2& frameSize,
+      DecodeFn decode,
+      int ringSize = 8);
+    ~FrameSequence();
+
+    FrameSequence(const FrameSequence&) = delete;
+    FrameSequence& operator=(const FrameSequence&) = delete;
+
+    // Pixel grid the decoded regions are aligned to.
+    int regionAlign = 256;
+
+    // Decode only the rectangle [min, max] of the frames (rounded out to
+    // `regionAlign` and clamped to the frame) from now on. Frames already
+    // decoded are kept if they cover it.
+    void SetRegion(const ImVec2& min, const ImVec2& max);
+
+    // Decode whole frames (the default).
+    void ClearRegion();
+
+    // Advance the clock by the frame time, queue the frames ahead and
+    // return the frame to display. If `state` is not null, its frame id and
+    // timestamp are set when the frame changes, for `State::frameStats`.
+    Shown Update(PlaybackState* playback, State* state = nullptr);
+
+    // Discard all decoded frames, e.g. when the decoding settings changed.
+    // The frame shown stays until its replacement is decoded.
+    void Invalidate();
+
+    int FrameCount() const;
+    int RingSize() const;
+
+    Stats GetStats() const;
+
+  private:
+    struct Slot
+    {
+      Frame frame;
+      int index = -1;
+      ImVec2 regionMin;
+      ImVec2 regionMax;
+      std::uint64_t version = 0;
+      bool pending = false;
+      bool cancelled = false;
+    };
+
+    // State shared with the background tasks.
+    struct Shared : detail::BackgroundTasks
+    {
+      std::vector<Slot> slots;
+      std::uint64_t decoded = 0;
+      std::uint64_t discarded = 0;
+      std::uint64_t failed = 0;
+    };
+
+    // Whether the decoded `slot` holds frame `index` with the current
+    // settings. Called with the lock held.
+    bool Holds(const Slot& slot, int index) const;
+
+    void Schedule(int due, int direction, bool loop);
+
+    int frameCount_;
+    ImVec2 frameSize_;
+    DecodeFn decode_;
+    ImVec2 regionMin_;
+    ImVec2 regionMax_;
+    std::uint64_t version_ = 1;
+    int shownSlot_ = -1;
+    std::uint64_t frameId_ = 0;
+    std::uint64_t stalls_ = 0;
+    double stalledSeconds_ = 0.0;
+    bool stalled_ = false;
+    int ready_ = 0;
+    std::shared_ptr<Shared> shared_;
+  };
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  template <typename Frame>
+  inline FrameSequence<Frame>::FrameSequence(
+    int frameCount,
+    const ImVec2& frameSize,
+    DecodeFn decode,
+    int ringSize)
+    : frameCount_(std::max(0, frameCount))
+    , frameSize_(frameSize)
+    , decode_(std::move(decode))
+    , regionMin_(0.0f, 0.0f)
+    , regionMax_(frameSize)
+    , shared_(std::make_shared<Shared>())
+  {
+    shared_->slots.resize(static_cast<std::size_t>(std::max(2, ringSize)));
+  }
+
+  template <typename Frame>
+  inline FrameSequence<Frame>::~FrameSequence()
+  {
+    shared_->Close();
+  }
+
+  template <typename Frame>
+  inline void FrameSequence<Frame>::SetRegion(const ImVec2& min, const ImVec2& max)
+  {
+    const float align{ static_cast<float>(std::max(1, regionAlign)) };
+    regionMin_ = ImVec2(
+      std::max(0.0f, std::floor(min.x / align) * align),
+      std::max(0.0f, std::floor(min.y / align) * align));
+    regionMax_ = ImVec2(
+      std::min(frameSize_.x, std::ceil(max.x / align) * align),
+      std::min(frameSize_.y, std::ceil(max.y / align) * align));
+  }
+
+  template <typename Frame>
+  inline void FrameSequence<Frame>::ClearRegion()
+  {
+    regionMin_ = ImVec2(0.0f, 0.0f);
+    regionMax_ = frameSize_;
+  }
+
+  template <typename Frame>
+  inline bool FrameSequence<Frame>::Holds(const Slot& slot, int index) const
+  {
+    return slot.index == index && slot.version == version_ && !slot.cancelled &&
+      slot.regionMin.x <= regionMin_.x && slot.regionMin.y <= regionMin_.y &&
+      slot.regionMax.x >= regionMax_.x && slot.regionMax.y >= regionMax_.y;
+  }
+
+  template <typename Frame>
+  inline typename FrameSequence<Frame>::Shown FrameSequence<Frame>::Update(
+    PlaybackState* playback, State* state)
+  {
+    Shown shown;
+    if (frameCount_ == 0)
+    {
+      return shown;
+    }
+
+    // advance the clock
+    const double count{ static_cast<double>(frameCount_) };
+    const double dt{ static_cast<double>(ImGui::GetIO().DeltaTime) };
+    const int direction{ playback->reverse ? -1 : 1 };
+    if (playback->playing && playback->fps > 0.0f)
+    {
+      playback->position += dt * playback->fps * direction;
+    }
+    if (playback->loop)
+    {
+      playback->position = std::fmod(playback->position, count);
+      playback->position += playback->position < 0.0 ? count : 0.0;
+    }
+    else
+    { // stop at the end
+      if (direction > 0 ? playback->position >= count : playback->position < 0.0)
+      {
+        playback->playing = false;
+      }
+      playback->position = std::clamp(playback->position, 0.0, std::nextafter(count, 0.0));
+    }
+    const int due{ std::clamp(static_cast<int>(playback->position), 0, frameCount_ - 1) };
+
+    const int previousSlot{ shownSlot_ };
+    int previousIndex{ -1 };
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      std::vector<Slot>& slots{ shared_->slots };
+      previousIndex = previousSlot >= 0 ? slots[static_cast<std::size_t>(previousSlot)].index : -1;
+
+      int found{ -1 };
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+        if (!slots[i].pending && Holds(slots[i], due))
+        {
+          found = static_cast<int>(i);
+          break;
+        }
+      }
+      if (found >= 0)
+      {
+        shownSlot_ = found;
+        stalled_ = false;
+      }
+      else if (playback->playing)
+      { // keep the previous frame and hold the clock at the start of the
+        // frame due until it is decoded
+        stalls_ += stalled_ ? 0 : 1;
+        stalled_ = true;
+        stalledSeconds_ += dt;
+        playback->position = direction > 0 ? static_cast<double>(due) :
+          std::nextafter(static_cast<double>(due) + 1.0, static_cast<double>(due));
+      }
+
+      Schedule(due, direction, playback->loop);
+
+      if (shownSlot_ >= 0)
+      {
+        const Slot& slot{ slots[static_cast<std::size_t>(shownSlot_)] };
+        shown.frame = &slot.frame;
+        shown.index = slot.index;
+        shown.regionMin = slot.regionMin;
+        shown.regionMax = slot.regionMax;
+        shown.changed = shownSlot_ != previousSlot || slot.index != previousIndex;
+      }
+    }
+    playback->frame = shown.index;
+
+    if (shown.changed && state != nullptr)
+    { // frames the clock went past while playing show as dropped
+      int step{ 1 };
+      if (playback->playing && previousIndex >= 0)
+      {
+        step = (shown.index - previousIndex) * direction;
+        step += step <= 0 && playback->loop ? frameCount_ : 0;
+        step = std::max(1, step);
+      }
+      frameId_ += static_cast<std::uint64_t>(step);
+      const double late{ direction > 0 ?
+        playback->position - static_cast<double>(due) :
+        static_cast<double>(due) + 1.0 - playback->position };
+      state->frameId = frameId_;
+      state->frameTimestamp = Clock() -
+        (playback->fps > 0.0f ? late / playback->fps : 0.0);
+    }
+    return shown;
+  }
+
+  template <typename Frame>
+  inline void FrameSequence<Frame>::Schedule(int due, int direction, bool loop)
+  {
+    std::vector<Slot>& slots{ shared_->slots };
+
+    // frames wanted, nearest first; one buffer is kept for the frame shown
+    std::vector<int> wanted;
+    for (int k = 0; k + 1 < static_cast<int>(slots.size()) && k < frameCount_; ++k)
+    {
+      int index{ due + k * direction };
+      if (loop)
+      {
+        index = ((index % frameCount_) + frameCount_) % frameCount_;
+      }
+      else if (index < 0 || index >= frameCount_)
+      {
+        break;
+      }
+      wanted.push_back(index);
+    }
+    auto isWanted = [&](int index) {
+      return std::find(wanted.begin(), wanted.end(), index) != wanted.end();
+    };
+
+    // drop the queued decodes of frames no longer wanted, and find the
+    // buffers that can be reused
+    std::vector<std::size_t> free;
+    std::vector<bool> covered(wanted.size(), false);
+    ready_ = 0;
+    for (std::size_t i = 0; i < slots.size(); ++i)
+    {
+      Slot& slot{ slots[i] };
+      if (slot.pending)
+      { // also when decoding a stale version or region
+        slot.cancelled = !isWanted(slot.index) || !Holds(slot, slot.index);
+      }
+      bool keep{ slot.pending || static_cast<int>(i) == shownSlot_ };
+      for (std::size_t w = 0; w < wanted.size(); ++w)
+      {
+        if (!covered[w] && Holds(slot, wanted[w]))
+        {
+          covered[w] = true;
+          keep = true;
+          ready_ += slot.pending || w == 0 ? 0 : 1;
+          break;
+        }
+      }
+      if (!keep)
+      {
+        free.push_back(i);
+      }
+    }
+
+    for (std::size_t w = 0; w < wanted.size() && !free.empty(); ++w)
+    {
+      if (covered[w])
+      {
+        continue;
+      }
+      const std::size_t i{ free.back() };
+      free.pop_back();
+      Slot& slot{ slots[i] };
+      slot.index = wanted[w];
+      slot.regionMin = regionMin_;
+      slot.regionMax = regionMax_;
+      slot.version = version_;
+      slot.pending = true;
+      slot.cancelled = false;
+
+      // nearer frames first
+      ThreadPool::Default().Submit(-static_cast<int>(w),
+        [shared = shared_, decode = &decode_, i, index = wanted[w],
+         min = regionMin_, max = regionMax_] {
+          if (!shared->Begin([&] {
+            Slot& queued{ shared->slots[i] };
+            if (queued.cancelled)
+            { // superseded while queued
+              queued.index = -1;
+              queued.pending = false;
+              ++shared->discarded;
+            }
+            return queued.cancelled;
+          }))
+          {
+            return;
+          }
+
+          // the buffer is not touched by the UI while pending
+          const bool ok{ (*decode)(index, min, max, &shared->slots[i].frame) };
+
+          shared->End([&] {
+            Slot& decoded{ shared->slots[i] };
+            decoded.index = ok && !decoded.cancelled ? index : -1;
+            decoded.pending = false;
+            decoded.cancelled = false;
+            if (ok)
+            {
+              ++shared->decoded;
+            }
+            else
+            {
+              ++shared->failed;
+            }
+          });
+        });
+    }
+  }
+
+  template <typename Frame>
+  inline void FrameSequence<Frame>::Invalidate()
+  {
+    ++version_;
+  }
+
+  template <typename Frame>
+  inline int FrameSequence<Frame>::FrameCount() const
+  {
+    return frameCount_;
+  }
+
+  template <typename Frame>
+  inline int FrameSequence<Frame>::RingSize() const
+  {
+    return static_cast<int>(shared_->slots.size());
+  }
+
+  template <typename Frame>
+  inline typename FrameSequence<Frame>::Stats FrameSequence<Frame>::GetStats() const
+  {
+    Stats stats;
+    {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      stats.decoded = shared_->decoded;
+      stats.discarded = shared_->discarded;
+      stats.failed = shared_->failed;
+    }
+    stats.stalls = stalls_;
+    stats.stalledSeconds = stalledSeconds_;
+    stats.stalled = stalled_;
+    stats.ready = ready_;
+    return stats;
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_SEQUENCE_H
@@ -0,0 +1,333 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Live Streams
+// ===================================
+// Hand-off of frames from a producer (camera thread, network, ...) to the UI
+// thread without letting latency grow when the producer is faster than the
+// display or the texture uploads.
+//
+// A `LiveStream` holds at most one pending frame: pushing a new frame
+// replaces the pending one, so the UI never works through a backlog. On the
+// UI thread, `Acquire()` decides whether the pending frame is uploaded now,
+// following the selected `StreamPolicy`:
+//
+// - LatestWins: always take the newest frame.
+// - EveryNth: take one frame out of every N produced.
+// - ByteBudget: take frames while an `UploadBudget` allows it. The budget
+//   can be a fixed number of bytes per UI frame, or derived from a time
+//   budget and the upload cost measured on the fly, so it adapts to the
+//   machine. One budget can be shared by several streams.
+//
+// Acquired frames carry a sequence number and capture time that are copied
+// to the widget's `State`, so `State::frameStats` reports latency and the
+// frames that were skipped.
+//
+// Usage
+// -----
+//    ImGuiImage::UploadBudget budget;            // shared by all cameras
+//    ImGuiImage::LiveStream<Frame> stream;       // one per camera
+//    stream.policy = ImGuiImage::StreamPolicy::ByteBudget;
+//    stream.budget = &budget;
+//
+//    // producer thread
+//    stream.Push(std::move(frame), frame.bytes, captureTime);
+//
+//    // UI thread, once per frame
+//    budget.NewFrame();
+//    Frame frame;
+//    if (stream.Acquire(&frame, &state))
+//    {
+//      const double t0 = ImGuiImage::Clock();
+//      UploadTexture(texture, frame);
+//      budget.ReportUpload(frame.bytes, ImGuiImage::Clock() - t0);
+//    }
+//    ImGuiImage::Zoomable(texture, displaySize, &state);
+//
+
+#ifndef IMGUI_ZOOMABLE_STREAM_H
+#define IMGUI_ZOOMABLE_STREAM_H
+
+#include "imgui_zoomable_image.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Per UI frame allowance for texture uploads.
+  //
+  // Members:
+  // - bytesPerFrame: Fixed number of bytes that may be uploaded per UI frame
+  //                  (0 = adaptive, derived from `secondsPerFrame`).
+  // - secondsPerFrame: Time per UI frame that uploads may take when
+  //                  adaptive. The byte allowance is this time divided by the
+  //                  measured cost per byte.
+  // - smoothing: Weight of each new measurement in the running cost
+  //                  estimate, in (0, 1].
+  class UploadBudget
+  {
+  public:
+    std::size_t bytesPerFrame = 0;
+    float secondsPerFrame = 0.004f;
+    float smoothing = 0.1f;
+
+    // Start a new UI frame, resetting the bytes consumed.
+    void NewFrame();
+
+    // Consume `bytes` from the allowance of this frame. Returns false if the
+    // upload should be deferred. The first upload of a frame is always
+    // allowed, so items larger than the allowance are not starved. With
+    // `force`, the bytes are accounted for and the upload always allowed.
+    bool TryConsume(std::size_t bytes, bool force = false);
+
+    // Report the measured cost of an upload.
+    void ReportUpload(std::size_t bytes, double seconds);
+
+    // Current allowance and usage, in bytes.
+    std::size_t FrameAllowance() const;
+    std::size_t UsedThisFrame() const;
+
+    // Running estimate of the upload cost (0 until measured).
+    double SecondsPerByte() const;
+
+  private:
+    std::size_t used_ = 0;
+    int uploads_ = 0;
+    double secondsPerByte_ = 0.0;
+  };
+
+  // Frame selection policies for `LiveStream`.
+  enum class StreamPolicy
+  {
+    LatestWins,
+    EveryNth,
+    ByteBudget,
+  };
+
+  // Single-slot, thread-safe hand-off of frames from a producer to the UI.
+  //
+  // `Frame` is any movable type (a pixel buffer, a shared pointer, ...).
+  // `Push()` may be called from any thread; `Acquire()` from the UI thread.
+  template <typename Frame>
+  class LiveStream
+  {
+  public:
+    // Members:
+    // - policy: Frame selection policy.
+    // - everyNth: Interval for `StreamPolicy::EveryNth`.
+    // - budget: Upload budget for `StreamPolicy::ByteBudget`.
+    // - maxDeferredFrames: With a shared budget, a stream deferred this many
+    //                      UI frames in a row uploads anyway, so no stream
+    //                      of a multi-camera view falls behind.
+    StreamPolicy policy = StreamPolicy::LatestWins;
+    int everyNth = 2;
+    UploadBudget* budget = nullptr;
+    int maxDeferredFrames = 4;
+
+    // Statistics
+    //
+    // - pushed: Frames produced.
+    // - acquired: Frames handed to the UI for upload.
+    // - replaced: Frames overwritten by a newer frame before being acquired.
+    // - deferred: Acquire calls that held back a pending frame because of
+    //             the policy.
+    struct Stats
+    {
+      std::uint64_t pushed = 0;
+      std::uint64_t acquired = 0;
+      std::uint64_t replaced = 0;
+      std::uint64_t deferred = 0;
+    };
+
+    // Publish a frame of `bytes` bytes captured at `captureTime` (`Clock()`
+    // seconds), replacing any frame not acquired yet. Never blocks on the UI.
+    void Push(Frame frame, std::size_t bytes, double captureTime = Clock());
+
+    // If the pending frame should be uploaded now, move it to `out`, copy its
+    // sequence number and capture time to `state` (if not null) and return
+    // true.
+    bool Acquire(Frame* out, State* state = nullptr);
+
+    // Whether a frame is waiting to be acquired.
+    bool HasPending() const;
+
+    Stats GetStats() const;
+
+  private:
+    struct Pending
+    {
+      Frame frame;
+      std::size_t bytes;
+      double captureTime;
+      std::uint64_t id;
+    };
+
+    mutable std::mutex mutex_;
+    std::optional<Pending> pending_;
+    std::uint64_t nextId_ = 1;
+    std::uint64_t lastAcquiredId_ = 0;
+    int deferredInARow_ = 0;
+    Stats stats_;
+  };
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  inline void UploadBudget::NewFrame()
+  {
+    used_ = 0;
+    uploads_ = 0;
+  }
+
+  inline std::size_t UploadBudget::FrameAllowance() const
+  {
+    if (bytesPerFrame > 0)
+    {
+      return bytesPerFrame;
+    }
+    if (secondsPerByte_ <= 0.0)
+    { // nothing measured yet, do not limit
+      return std::numeric_limits<std::size_t>::max();
+    }
+    return static_cast<std::size_t>(secondsPerFrame / secondsPerByte_);
+  }
+
+  inline bool UploadBudget::TryConsume(std::size_t bytes, bool force)
+  {
+    const std::size_t allowance{ FrameAllowance() };
+    if (!force && uploads_ > 0 && (used_ >= allowance || bytes > allowance - used_))
+    {
+      return false;
+    }
+    used_ += bytes;
+    ++uploads_;
+    return true;
+  }
+
+  inline void UploadBudget::ReportUpload(std::size_t bytes, double seconds)
+  {
+    if (bytes == 0 || seconds < 0.0)
+    {
+      return;
+    }
+    const double cost{ seconds / static_cast<double>(bytes) };
+    secondsPerByte_ = secondsPerByte_ <= 0.0 ? cost :
+      secondsPerByte_ + (cost - secondsPerByte_) * static_cast<double>(smoothing);
+  }
+
+  inline std::size_t UploadBudget::UsedThisFrame() const
+  {
+    return used_;
+  }
+
+  inline double UploadBudget::SecondsPerByte() const
+  {
+    return secondsPerByte_;
+  }
+
+  template <typename Frame>
+  inline void LiveStream<Frame>::Push(
+    Frame frame, std::size_t bytes, double captureTime)
+  {
+    std::optional<Pending> previous;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.pushed;
+      if (pending_.has_value())
+      {
+        ++stats_.replaced;
+        previous = std::move(pending_);
+      }
+      pending_.emplace(Pending{ std::move(frame), bytes, captureTime, nextId_++ });
+    }
+    // `previous` is released here, outside the lock
+  }
+
+  template <typename Frame>
+  inline bool LiveStream<Frame>::Acquire(Frame* out, State* state)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!pending_.has_value())
+    {
+      return false;
+    }
+
+    bool take{ true };
+    switch (policy)
+    {
+    case StreamPolicy::LatestWins:
+      break;
+    case StreamPolicy::EveryNth:
+      take = lastAcquiredId_ == 0 ||
+        pending_->id >= lastAcquiredId_ + static_cast<std::uint64_t>(std::max(1, everyNth));
+      break;
+    case StreamPolicy::ByteBudget:
+      take = budget == nullptr || budget->TryConsume(
+        pending_->bytes, deferredInARow_ >= maxDeferredFrames);
+      break;
+    }
+    if (!take)
+    { // keep it; a newer frame may replace it before the next try
+      ++stats_.deferred;
+      ++deferredInARow_;
+      return false;
+    }
+    deferredInARow_ = 0;
+
+    Pending pending{ std::move(*pending_) };
+    pending_.reset();
+    lastAcquiredId_ = pending.id;
+    ++stats_.acquired;
+    lock.unlock();
+
+    *out = std::move(pending.frame);
+    if (state != nullptr)
+    {
+      state->frameId = pending.id;
+      state->frameTimestamp = pending.captureTime;
+    }
+    return true;
+  }
+
+  template <typename Frame>
+  inline bool LiveStream<Frame>::HasPending() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.has_value();
+  }
+
+  template <typename Frame>
+  inline typename LiveStream<Frame>::Stats LiveStream<Frame>::GetStats() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_STREAM_H
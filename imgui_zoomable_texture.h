@@ -0,0 +1,1337 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Textures
+// ===============================
+// Backend-agnostic texture creation and upload, with a pool that recycles
+// textures so tiled and streaming displays do not create and destroy GPU
+// textures all the time.
+//
+// Contents
+// --------
+// - `TextureProvider`: interface to create, update and destroy textures of a
+//   rendering backend.
+// - `TexturePool`: keeps released textures by format and size and hands them
+//   out again, so tile churn costs uploads but no allocations.
+// - `TileAtlas`: packs resident tiles into a few large pages, so the tiles
+//   of a page are drawn with a single draw command.
+// - `UploadScheduler`: uploads decoded tiles within a per-frame budget, the
+//   most visible and coarsest first.
+// - `OpenGLTextureProvider`: OpenGL implementation, available when the
+//   OpenGL headers (or loader) are included before this header.
+// - `CpuTextureProvider`: textures kept in memory, for headless tests.
+//
+// Usage
+// -----
+//    #include <GLFW/glfw3.h> // or any header declaring the GL functions
+//    #include "imgui_zoomable_texture.h"
+//
+//    ImGuiImage::OpenGLTextureProvider provider;
+//    ImGuiImage::TexturePool pool(&provider);
+//
+//    // when a tile becomes resident
+//    ImGuiImage::PooledTexture texture{ pool.Acquire(
+//      { tile.width, tile.height, ImGuiImage::TextureFormat::RGBA8 }) };
+//    pool.Upload(texture, tile.pixels.data());
+//
+//    // when it is evicted, the texture is kept for the next tile
+//    pool.Release(&texture);
+//
+// Textures must be created, updated and destroyed on the thread owning the
+// rendering context (usually the UI thread). Only the queue of
+// `UploadScheduler` may be fed from other threads.
+//
+
+#ifndef IMGUI_ZOOMABLE_TEXTURE_H
+#define IMGUI_ZOOMABLE_TEXTURE_H
+
+#include "imgui_zoomable_stream.h"
+#include "imgui_zoomable_tiles.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// OpenGL
+// ======
+// `OpenGLTextureProvider` is compiled when GL_TEXTURE_2D is defined, i.e. the
+// application included its OpenGL headers or loader first. It only uses
+// OpenGL 1.1 entry points, also available in OpenGL ES 2. Define
+// IMGUI_ZOOMABLE_IMAGE_DISABLE_OPENGL to leave it out.
+#if defined(GL_TEXTURE_2D) && !defined(IMGUI_ZOOMABLE_IMAGE_DISABLE_OPENGL)
+#define IMGUI_ZOOMABLE_IMAGE_OPENGL 1
+#endif
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Pixel formats of textures.
+  //
+  // - RGBA8: 4 bytes per pixel, in `IM_COL32` byte order (see `TileImage`).
+  // - R8: 1 byte per pixel, single channel.
+  enum class TextureFormat
+  {
+    RGBA8,
+    R8,
+  };
+
+  // Bytes per pixel of a texture format.
+  IMGUI_API int BytesPerPixel(TextureFormat format);
+
+  // Size and format of a texture.
+  struct TextureDesc
+  {
+    int width = 0;
+    int height = 0;
+    TextureFormat format = TextureFormat::RGBA8;
+
+    bool operator==(const TextureDesc& other) const = default;
+
+    // Bytes of a row without padding, and of the whole texture.
+    std::size_t RowBytes() const;
+    std::size_t ByteSize() const;
+  };
+
+  // Hash functor so `TextureDesc` can be used in unordered containers.
+  struct TextureDescHash
+  {
+    std::size_t operator()(const TextureDesc& desc) const;
+  };
+
+  // Creation, upload and destruction of textures on a rendering backend.
+  //
+  // Implementations return texture identifiers usable with `Zoomable()` and
+  // `ImDrawList::AddImage()` for the backend in use.
+  class TextureProvider
+  {
+  public:
+    virtual ~TextureProvider() = default;
+
+    // Create a texture with undefined content. Returns `ImTextureID_Invalid`
+    // on failure.
+    virtual ImTextureID Create(const TextureDesc& desc) = 0;
+
+    // Replace the rectangle [x, x + width) x [y, y + height) of a texture
+    // with `pixels`, whose rows are `stride` bytes apart.
+    virtual void Update(
+      ImTextureID id,
+      const TextureDesc& desc,
+      int x,
+      int y,
+      int width,
+      int height,
+      const void* pixels,
+      std::size_t stride) = 0;
+
+    // Destroy a texture created by this provider.
+    virtual void Destroy(ImTextureID id) = 0;
+  };
+
+  // Texture handed out by a `TexturePool`.
+  struct PooledTexture
+  {
+    ImTextureID id = ImTextureID_Invalid;
+    TextureDesc desc;
+
+    bool Valid() const;
+    ImTextureRef Ref() const;
+
+    // The whole texture as a tile for the lookup callback of
+    // `ZoomableTiles()`.
+    TileTexture Tile() const;
+  };
+
+  // Recycles textures by format and size.
+  //
+  // Released textures are kept, up to `maxIdle` of them, and returned by the
+  // next `Acquire()` with the same description instead of creating a new
+  // one. Textures acquired and not released are owned by the caller; only
+  // idle textures are destroyed with the pool.
+  class TexturePool
+  {
+  public:
+    // Statistics
+    //
+    // - created, destroyed: Calls made to the provider.
+    // - reused: Acquisitions served from the idle textures.
+    // - live: Textures acquired and not released.
+    // - idle: Textures kept for reuse.
+    struct Stats
+    {
+      std::uint64_t created = 0;
+      std::uint64_t destroyed = 0;
+      std::uint64_t reused = 0;
+      std::size_t live = 0;
+      std::size_t idle = 0;
+    };
+
+    explicit TexturePool(TextureProvider* provider, std::size_t maxIdle = 256);
+    ~TexturePool();
+
+    TexturePool(const TexturePool&) = delete;
+    TexturePool& operator=(const TexturePool&) = delete;
+
+    // Return a texture matching `desc`, reusing an idle one if possible. The
+    // content of a reused texture is the one it had when released. The
+    // result is invalid if the provider fails to create a texture.
+    PooledTexture Acquire(const TextureDesc& desc);
+
+    // Give a texture back to the pool and reset `texture`.
+    void Release(PooledTexture* texture);
+
+    // Upload the whole texture from `pixels` (`stride` = 0 for tightly
+    // packed rows).
+    void Upload(
+      const PooledTexture& texture,
+      const void* pixels,
+      std::size_t stride = 0);
+
+    // Maximum number of idle textures; shrinking destroys the excess.
+    void SetMaxIdle(std::size_t maxIdle);
+    std::size_t MaxIdle() const;
+
+    // Destroy all idle textures.
+    void Clear();
+
+    Stats GetStats() const;
+    TextureProvider* Provider() const;
+
+  private:
+    void Trim();
+
+    TextureProvider* provider_;
+    std::size_t maxIdle_;
+    std::unordered_map<TextureDesc, std::vector<ImTextureID>,
+      TextureDescHash> idle_;
+    std::vector<TextureDesc> idleOrder_; // release order, oldest first
+    Stats stats_;
+  };
+
+  // Resident tiles packed into a few large textures (pages).
+  //
+  // Every tile takes a `tileSize` x `tileSize` slot of a page and is drawn
+  // as a sub-rectangle of it, so `ZoomableTiles()` draws all the visible
+  // tiles of a page with a single draw command instead of one per tile.
+  // Pages come from a `TexturePool`, and slots are recycled as tiles come
+  // and go: when all pages are full, the least recently used tile not drawn
+  // in the current frame gives its slot to the new one.
+  //
+  // New tiles go to the fullest page with a free slot, so pages that lose
+  // their tiles drain. When the fill ratio drops below
+  // `defragmentThreshold`, `Defragment()` moves the tiles of the emptiest
+  // page to the others and gives the page back to the pool.
+  //
+  // Tiles are drawn with the exact UV rectangle of their slot; use nearest
+  // filtering so neighbouring slots do not bleed into each other.
+  //
+  // Members:
+  // - maxPages: Maximum number of pages.
+  // - defragmentThreshold: Fill ratio (used / total slots) below which
+  //                        `NeedsDefragment()` returns true.
+  // - fadeDuration: Seconds over which new tiles fade in over their coarser
+  //                 fallback in `ZoomableTiles()` (0 = no fading).
+  class TileAtlas
+  {
+  public:
+    int maxPages = 8;
+    float defragmentThreshold = 0.5f;
+    float fadeDuration = 0.0f;
+
+    // Create an atlas of `pageSize` x `pageSize` pages holding tiles up to
+    // `tileSize` pixels, allocated from `pool`.
+    TileAtlas(
+      TexturePool* pool,
+      int tileSize,
+      int pageSize = 2048,
+      TextureFormat format = TextureFormat::RGBA8);
+    ~TileAtlas();
+
+    TileAtlas(const TileAtlas&) = delete;
+    TileAtlas& operator=(const TileAtlas&) = delete;
+
+    // Start a new UI frame. Tiles looked up during a frame are not evicted
+    // until the next one.
+    void NewFrame();
+
+    // Upload a tile of `width` x `height` pixels (at most `tileSize`) with
+    // rows `stride` bytes apart (0 = tightly packed). A tile already in the
+    // atlas is updated in place. Returns false if no slot could be freed.
+    bool Insert(
+      const TileKey& key,
+      const void* pixels,
+      int width,
+      int height,
+      std::size_t stride = 0);
+    bool Insert(const TileKey& key, const TileImage& image);
+
+    // Page texture and UV rectangle of a tile, for the lookup callback of
+    // `ZoomableTiles()`. Invalid if the tile is not in the atlas.
+    TileTexture Lookup(const TileKey& key);
+
+    bool Contains(const TileKey& key) const;
+
+    // Free the slot of a tile, or of all tiles matching `predicate`.
+    void Erase(const TileKey& key);
+    template <typename Predicate>
+    void EraseIf(Predicate&& predicate);
+
+    // Free all slots and give the pages back to the pool.
+    void Clear();
+
+    // Whether the pages are sparse enough for `Defragment()` to release one.
+    bool NeedsDefragment() const;
+
+    // Move the tiles of the emptiest page to free slots of the other pages
+    // and release it. `reload(const TileKey&) -> const TileImage*` returns
+    // the pixels of a tile to re-upload, or nullptr to drop the tile.
+    // Returns the number of tiles moved.
+    template <typename ReloadFn>
+    int Defragment(ReloadFn&& reload);
+
+    // Number of tiles, of pages in use, and used slots / total slots.
+    std::size_t Size() const;
+    int PageCount() const;
+    float FillRatio() const;
+
+  private:
+    struct Page
+    {
+      PooledTexture texture;
+      std::vector<int> freeSlots;
+      int used = 0;
+    };
+
+    struct Slot
+    {
+      int page;
+      int index;
+      int width;
+      int height;
+      std::uint64_t lastUsed;
+      double insertTime;
+    };
+
+    // Allocate a slot, on a new page or by evicting if needed. Returns false
+    // if none is available. With `excludePage` >= 0 (defragmentation), only
+    // free slots of the other pages are used.
+    bool Allocate(Slot* slot, int excludePage = -1);
+    void FreeSlot(const Slot& slot);
+    void ReleasePage(int page);
+    void Upload(const Slot& slot, const void* pixels, std::size_t stride);
+    int SlotsPerPage() const;
+
+    TexturePool* pool_;
+    int tileSize_;
+    int pageSize_;
+    int slotsPerSide_;
+    TextureFormat format_;
+    std::vector<Page> pages_; // released pages have an invalid texture
+    std::unordered_map<TileKey, Slot, TileKeyHash> slots_;
+    std::uint64_t frame_ = 1;
+  };
+
+  // Queue of decoded tiles waiting to be uploaded, drained within a per
+  // frame budget.
+  //
+  // Decoder threads `Enqueue()` tiles as they become ready; once per UI
+  // frame, `Process()` uploads the most useful ones while `budget` allows
+  // and defers the rest, so a burst of decoded tiles (e.g. zooming out
+  // quickly) is spread over several frames instead of stalling one. Tiles
+  // are uploaded in this order:
+  //
+  // 1. Tiles overlapping the visible rectangle before the others.
+  // 2. Coarser levels first, since one coarse tile covers the area of many
+  //    fine ones.
+  // 3. Tiles closer to the center of the view first.
+  //
+  // The budget is a fixed number of bytes (`budget.bytesPerFrame`) or a time
+  // per frame (`budget.secondsPerFrame`), converted to bytes with the upload
+  // cost measured around each upload call.
+  class UploadScheduler
+  {
+  public:
+    UploadBudget budget;
+
+    // Statistics
+    //
+    // - uploaded: Tiles uploaded since creation.
+    // - uploadedBytes: Bytes uploaded since creation.
+    // - lastFrameUploads, lastFrameBytes: Uploads of the last `Process()`.
+    // - pending: Tiles waiting for upload.
+    struct Stats
+    {
+      std::uint64_t uploaded = 0;
+      std::uint64_t uploadedBytes = 0;
+      int lastFrameUploads = 0;
+      std::size_t lastFrameBytes = 0;
+      std::size_t pending = 0;
+    };
+
+    // Queue a tile for upload, replacing a pending one with the same key.
+    // Thread-safe.
+    void Enqueue(const TileKey& key, std::shared_ptr<const TileImage> image);
+
+    // Upload pending tiles of `grid` within the budget of this frame, given
+    // the view described by `state` (see `GetVisibleRect()`).
+    // `upload(const TileKey&, const TileImage&)` does the actual upload, for
+    // instance `TileAtlas::Insert()`. Call once per UI frame, from the thread
+    // owning the rendering context. Returns the number of tiles uploaded.
+    template <typename UploadFn>
+    int Process(const TileGrid& grid, const State& state, UploadFn&& upload);
+
+    // Drop pending tiles matching `predicate(const TileKey&)`, e.g. tiles of
+    // a slice that is not displayed anymore. Thread-safe.
+    template <typename Predicate>
+    void EraseIf(Predicate&& predicate);
+
+    void Clear();
+
+    bool IsPending(const TileKey& key) const;
+
+    Stats GetStats() const;
+
+  private:
+    mutable std::mutex mutex_;
+    std::unordered_map<TileKey, std::shared_ptr<const TileImage>,
+      TileKeyHash> pending_;
+    Stats stats_;
+  };
+
+  // Textures kept in memory, for headless tests and tools.
+  //
+  // Records every call so tests can check how the widget uses the backend.
+  class CpuTextureProvider : public TextureProvider
+  {
+  public:
+    struct Texture
+    {
+      TextureDesc desc;
+      std::vector<std::uint8_t> pixels; // rows without padding
+    };
+
+    // Statistics
+    //
+    // - creates, updates, destroys: Calls received.
+    // - bytesUploaded: Bytes received by `Update()`.
+    struct Stats
+    {
+      std::uint64_t creates = 0;
+      std::uint64_t updates = 0;
+      std::uint64_t destroys = 0;
+      std::uint64_t bytesUploaded = 0;
+    };
+
+    ImTextureID Create(const TextureDesc& desc) override;
+    void Update(
+      ImTextureID id,
+      const TextureDesc& desc,
+      int x,
+      int y,
+      int width,
+      int height,
+      const void* pixels,
+      std::size_t stride) override;
+    void Destroy(ImTextureID id) override;
+
+    // Texture content, or nullptr if `id` is not a live texture.
+    const Texture* Find(ImTextureID id) const;
+
+    // Number of live textures.
+    std::size_t Size() const;
+
+    Stats GetStats() const;
+
+  private:
+    std::unordered_map<std::uintptr_t, Texture> textures_;
+    std::uintptr_t nextId_ = 1;
+    Stats stats_;
+  };
+
+#if defined(IMGUI_ZOOMABLE_IMAGE_OPENGL)
+  // OpenGL textures, as used by the imgui OpenGL backends (the texture
+  // identifier is the GL texture name).
+  //
+  // Members:
+  // - linearFilter: Use linear instead of nearest-neighbor filtering. Tiles
+  //                 drawn side by side with linear filtering can show seams
+  //                 at their borders.
+  class OpenGLTextureProvider : public TextureProvider
+  {
+  public:
+    bool linearFilter = false;
+
+    ImTextureID Create(const TextureDesc& desc) override;
+    void Update(
+      ImTextureID id,
+      const TextureDesc& desc,
+      int x,
+      int y,
+      int width,
+      int height,
+      const void* pixels,
+      std::size_t stride) override;
+    void Destroy(ImTextureID id) override;
+  };
+#endif
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  namespace detail
+  {
+    // `ImTextureID` may be an integer or a pointer type depending on the
+    // imgui configuration, so conversions go through a C-style cast.
+    inline std::uintptr_t TextureIdToInt(ImTextureID id)
+    {
+      return (std::uintptr_t)id;
+    }
+
+    inline ImTextureID IntToTextureId(std::uintptr_t value)
+    {
+      return (ImTextureID)value;
+    }
+  }
+
+  inline int BytesPerPixel(TextureFormat format)
+  {
+    switch (format)
+    {
+    case TextureFormat::RGBA8:
+      return 4;
+    case TextureFormat::R8:
+      return 1;
+    }
+    return 4;
+  }
+
+  inline std::size_t TextureDesc::RowBytes() const
+  {
+    return static_cast<std::size_t>(width) * BytesPerPixel(format);
+  }
+
+  inline std::size_t TextureDesc::ByteSize() const
+  {
+    return RowBytes() * static_cast<std::size_t>(height);
+  }
+
+  inline std::size_t TextureDescHash::operator()(const TextureDesc& desc) const
+  {
+    std::uint64_t h{ static_cast<std::uint32_t>(desc.width) };
+    h = h * 0x9E3779B97F4A7C15ull + static_cast<std::uint32_t>(desc.height);
+    h = h * 0x9E3779B97F4A7C15ull + static_cast<std::uint32_t>(desc.format);
+    return static_cast<std::size_t>(h ^ (h >> 32));
+  }
+
+  inline bool PooledTexture::Valid() const
+  {
+    return id != ImTextureID_Invalid;
+  }
+
+  inline ImTextureRef PooledTexture::Ref() const
+  {
+    return ImTextureRef(id);
+  }
+
+  inline TileTexture PooledTexture::Tile() const
+  {
+    TileTexture tile;
+    tile.texRef = Ref();
+    tile.valid = Valid();
+    return tile;
+  }
+
+  inline TexturePool::TexturePool(TextureProvider* provider, std::size_t maxIdle)
+    : provider_(provider)
+    , maxIdle_(maxIdle)
+  {
+  }
+
+  inline TexturePool::~TexturePool()
+  {
+    Clear();
+  }
+
+  inline PooledTexture TexturePool::Acquire(const TextureDesc& desc)
+  {
+    PooledTexture texture;
+    texture.desc = desc;
+
+    auto it = idle_.find(desc);
+    if (it != idle_.end() && !it->second.empty())
+    {
+      texture.id = it->second.back();
+      it->second.pop_back();
+      // the order list only needs one entry per idle texture, any will do
+      for (std::size_t i = idleOrder_.size(); i-- > 0;)
+      {
+        if (idleOrder_[i] == desc)
+        {
+          idleOrder_.erase(idleOrder_.begin() + static_cast<std::ptrdiff_t>(i));
+          break;
+        }
+      }
+      ++stats_.reused;
+      --stats_.idle;
+    }
+    else
+    {
+      texture.id = provider_ != nullptr ?
+        provider_->Create(desc) : ImTextureID_Invalid;
+      if (!texture.Valid())
+      {
+        return texture;
+      }
+      ++stats_.created;
+    }
+    ++stats_.live;
+    return texture;
+  }
+
+  inline void TexturePool::Release(PooledTexture* texture)
+  {
+    if (texture == nullptr || !texture->Valid())
+    {
+      return;
+    }
+    idle_[texture->desc].push_back(texture->id);
+    idleOrder_.push_back(texture->desc);
+    --stats_.live;
+    ++stats_.idle;
+    *texture = PooledTexture();
+    Trim();
+  }
+
+  inline void TexturePool::Upload(
+    const PooledTexture& texture,
+    const void* pixels,
+    std::size_t stride)
+  {
+    if (provider_ == nullptr || !texture.Valid() || pixels == nullptr)
+    {
+      return;
+    }
+    provider_->Update(texture.id, texture.desc, 0, 0,
+      texture.desc.width, texture.desc.height, pixels,
+      stride > 0 ? stride : texture.desc.RowBytes());
+  }
+
+  inline void TexturePool::SetMaxIdle(std::size_t maxIdle)
+  {
+    maxIdle_ = maxIdle;
+    Trim();
+  }
+
+  inline std::size_t TexturePool::MaxIdle() const
+  {
+    return maxIdle_;
+  }
+
+  inline void TexturePool::Clear()
+  {
+    for (auto& [desc, ids] : idle_)
+    {
+      for (ImTextureID id : ids)
+      {
+        if (provider_ != nullptr)
+        {
+          provider_->Destroy(id);
+        }
+        ++stats_.destroyed;
+      }
+    }
+    idle_.clear();
+    idleOrder_.clear();
+    stats_.idle = 0;
+  }
+
+  inline TexturePool::Stats TexturePool::GetStats() const
+  {
+    return stats_;
+  }
+
+  inline TextureProvider* TexturePool::Provider() const
+  {
+    return provider_;
+  }
+
+  inline void TexturePool::Trim()
+  {
+    // destroy textures of the formats and sizes released longest ago first
+    std::size_t evict{ idleOrder_.size() > maxIdle_ ?
+      idleOrder_.size() - maxIdle_ : 0 };
+    if (evict == 0)
+    {
+      return;
+    }
+    for (std::size_t i = 0; i < evict; ++i)
+    {
+      std::vector<ImTextureID>& ids{ idle_[idleOrder_[i]] };
+      if (provider_ != nullptr)
+      {
+        provider_->Destroy(ids.front());
+      }
+      ids.erase(ids.begin());
+      ++stats_.destroyed;
+      --stats_.idle;
+    }
+    idleOrder_.erase(idleOrder_.begin(),
+      idleOrder_.begin() + static_cast<std::ptrdiff_t>(evict));
+  }
+
+  inline TileAtlas::TileAtlas(
+    TexturePool* pool,
+    int tileSize,
+    int pageSize,
+    TextureFormat format)
+    : pool_(pool)
+    , tileSize_(std::max(1, tileSize))
+    , pageSize_(std::max(pageSize, tileSize_))
+    , slotsPerSide_(pageSize_ / tileSize_)
+    , format_(format)
+  {
+  }
+
+  inline TileAtlas::~TileAtlas()
+  {
+    Clear();
+  }
+
+  inline void TileAtlas::NewFrame()
+  {
+    ++frame_;
+  }
+
+  inline int TileAtlas::SlotsPerPage() const
+  {
+    return slotsPerSide_ * slotsPerSide_;
+  }
+
+  inline bool TileAtlas::Allocate(Slot* slot, int excludePage)
+  {
+    // fullest page with a free slot, so sparse pages drain
+    int best{ -1 };
+    for (int i = 0; i < static_cast<int>(pages_.size()); ++i)
+    {
+      const Page& page{ pages_[i] };
+      if (i != excludePage && page.texture.Valid() && !page.freeSlots.empty() &&
+          (best < 0 || page.used > pages_[best].used))
+      {
+        best = i;
+      }
+    }
+
+    int activePages{ 0 };
+    for (const Page& page : pages_)
+    {
+      activePages += page.texture.Valid() ? 1 : 0;
+    }
+    if (best < 0 && excludePage < 0 && activePages < maxPages && pool_ != nullptr)
+    { // open a new page, reusing a released entry if any
+      PooledTexture texture{ pool_->Acquire({ pageSize_, pageSize_, format_ }) };
+      if (texture.Valid())
+      {
+        best = 0;
+        while (best < static_cast<int>(pages_.size()) && pages_[best].texture.Valid())
+        {
+          ++best;
+        }
+        if (best == static_cast<int>(pages_.size()))
+        {
+          pages_.emplace_back();
+        }
+        Page& page{ pages_[best] };
+        page.texture = texture;
+        page.used = 0;
+        page.freeSlots.clear();
+        for (int i = SlotsPerPage(); i-- > 0;)
+        {
+          page.freeSlots.push_back(i);
+        }
+      }
+    }
+
+    if (best < 0 && excludePage < 0)
+    { // recycle the least recently used slot not drawn this frame
+      auto victim = slots_.end();
+      for (auto it = slots_.begin(); it != slots_.end(); ++it)
+      {
+        if (it->second.lastUsed < frame_ &&
+            (victim == slots_.end() || it->second.lastUsed < victim->second.lastUsed))
+        {
+          victim = it;
+        }
+      }
+      if (victim == slots_.end())
+      {
+        return false;
+      }
+      best = victim->second.page;
+      FreeSlot(victim->second);
+      slots_.erase(victim);
+    }
+    if (best < 0)
+    {
+      return false;
+    }
+
+    Page& page{ pages_[best] };
+    slot->page = best;
+    slot->index = page.freeSlots.back();
+    slot->lastUsed = frame_;
+    page.freeSlots.pop_back();
+    ++page.used;
+    return true;
+  }
+
+  inline void TileAtlas::FreeSlot(const Slot& slot)
+  {
+    Page& page{ pages_[slot.page] };
+    page.freeSlots.push_back(slot.index);
+    --page.used;
+  }
+
+  inline void TileAtlas::ReleasePage(int page)
+  {
+    if (pool_ != nullptr)
+    {
+      pool_->Release(&pages_[page].texture);
+    }
+    pages_[page] = Page();
+  }
+
+  inline void TileAtlas::Upload(
+    const Slot& slot, const void* pixels, std::size_t stride)
+  {
+    TextureProvider* provider{ pool_ != nullptr ? pool_->Provider() : nullptr };
+    if (provider == nullptr || pixels == nullptr)
+    {
+      return;
+    }
+    const PooledTexture& texture{ pages_[slot.page].texture };
+    provider->Update(texture.id, texture.desc,
+      (slot.index % slotsPerSide_) * tileSize_,
+      (slot.index / slotsPerSide_) * tileSize_,
+      slot.width, slot.height, pixels, stride);
+  }
+
+  inline bool TileAtlas::Insert(
+    const TileKey& key,
+    const void* pixels,
+    int width,
+    int height,
+    std::size_t stride)
+  {
+    if (width <= 0 || height <= 0 || width > tileSize_ || height > tileSize_)
+    {
+      return false;
+    }
+    if (stride == 0)
+    {
+      stride = static_cast<std::size_t>(width) * BytesPerPixel(format_);
+    }
+
+    auto it = slots_.find(key);
+    if (it == slots_.end())
+    {
+      Slot slot;
+      if (!Allocate(&slot))
+      {
+        return false;
+      }
+      slot.insertTime = Clock();
+      it = slots_.emplace(key, slot).first;
+    }
+    it->second.width = width;
+    it->second.height = height;
+    it->second.lastUsed = frame_;
+    Upload(it->second, pixels, stride);
+    return true;
+  }
+
+  inline bool TileAtlas::Insert(const TileKey& key, const TileImage& image)
+  {
+    return Insert(key, image.pixels.data(), image.width, image.height);
+  }
+
+  inline TileTexture TileAtlas::Lookup(const TileKey& key)
+  {
+    TileTexture tile;
+    auto it = slots_.find(key);
+    if (it == slots_.end())
+    {
+      return tile;
+    }
+    Slot& slot{ it->second };
+    slot.lastUsed = frame_;
+
+    const float pageSize{ static_cast<float>(pageSize_) };
+    const float x{ static_cast<float>((slot.index % slotsPerSide_) * tileSize_) };
+    const float y{ static_cast<float>((slot.index / slotsPerSide_) * tileSize_) };
+    tile.texRef = pages_[slot.page].texture.Ref();
+    tile.uv0 = ImVec2(x / pageSize, y / pageSize);
+    tile.uv1 = ImVec2((x + static_cast<float>(slot.width)) / pageSize,
+      (y + static_cast<float>(slot.height)) / pageSize);
+    tile.valid = true;
+    if (fadeDuration > 0.0f)
+    {
+      tile.alpha = std::min(1.0f,
+        static_cast<float>(Clock() - slot.insertTime) / fadeDuration);
+    }
+    return tile;
+  }
+
+  inline bool TileAtlas::Contains(const TileKey& key) const
+  {
+    return slots_.find(key) != slots_.end();
+  }
+
+  inline void TileAtlas::Erase(const TileKey& key)
+  {
+    auto it = slots_.find(key);
+    if (it != slots_.end())
+    {
+      FreeSlot(it->second);
+      slots_.erase(it);
+    }
+  }
+
+  template <typename Predicate>
+  inline void TileAtlas::EraseIf(Predicate&& predicate)
+  {
+    for (auto it = slots_.begin(); it != slots_.end();)
+    {
+      if (predicate(it->first))
+      {
+        FreeSlot(it->second);
+        it = slots_.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  inline void TileAtlas::Clear()
+  {
+    slots_.clear();
+    for (int i = 0; i < static_cast<int>(pages_.size()); ++i)
+    {
+      ReleasePage(i);
+    }
+    pages_.clear();
+  }
+
+  inline std::size_t TileAtlas::Size() const
+  {
+    return slots_.size();
+  }
+
+  inline int TileAtlas::PageCount() const
+  {
+    int count{ 0 };
+    for (const Page& page : pages_)
+    {
+      count += page.texture.Valid() ? 1 : 0;
+    }
+    return count;
+  }
+
+  inline float TileAtlas::FillRatio() const
+  {
+    const int pages{ PageCount() };
+    return pages > 0 ? static_cast<float>(slots_.size()) /
+      static_cast<float>(pages * SlotsPerPage()) : 1.0f;
+  }
+
+  inline bool TileAtlas::NeedsDefragment() const
+  {
+    // the tiles of the emptiest page must fit in the free slots of the others
+    const int pages{ PageCount() };
+    return pages > 1 && FillRatio() < defragmentThreshold &&
+      static_cast<int>(slots_.size()) <= (pages - 1) * SlotsPerPage();
+  }
+
+  template <typename ReloadFn>
+  inline int TileAtlas::Defragment(ReloadFn&& reload)
+  {
+    if (!NeedsDefragment())
+    {
+      return 0;
+    }
+    int emptiest{ -1 };
+    for (int i = 0; i < static_cast<int>(pages_.size()); ++i)
+    {
+      if (pages_[i].texture.Valid() &&
+          (emptiest < 0 || pages_[i].used < pages_[emptiest].used))
+      {
+        emptiest = i;
+      }
+    }
+
+    int moved{ 0 };
+    for (auto it = slots_.begin(); it != slots_.end();)
+    {
+      if (it->second.page != emptiest)
+      {
+        ++it;
+        continue;
+      }
+      const TileImage* image{ reload(it->first) };
+      Slot slot{ it->second };
+      if (image != nullptr && image->width == slot.width &&
+          image->height == slot.height && Allocate(&slot, emptiest))
+      {
+        FreeSlot(it->second);
+        it->second = slot;
+        Upload(slot, image->pixels.data(),
+          static_cast<std::size_t>(slot.width) * BytesPerPixel(format_));
+        ++moved;
+        ++it;
+      }
+      else
+      { // not available anymore, the tile will be inserted again if needed
+        FreeSlot(it->second);
+        it = slots_.erase(it);
+      }
+    }
+    ReleasePage(emptiest);
+    return moved;
+  }
+
+  inline void UploadScheduler::Enqueue(
+    const TileKey& key, std::shared_ptr<const TileImage> image)
+  {
+    if (image == nullptr)
+    {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_[key] = std::move(image);
+  }
+
+  template <typename UploadFn>
+  inline int UploadScheduler::Process(
+    const TileGrid& grid, const State& state, UploadFn&& upload)
+  {
+    struct Item
+    {
+      TileKey key;
+      std::shared_ptr<const TileImage> image;
+      bool visible;
+      float distance;
+    };
+
+    std::vector<Item> items;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      items.reserve(pending_.size());
+      for (auto& [key, image] : pending_)
+      {
+        items.push_back({ key, std::move(image), false, 0.0f });
+      }
+      pending_.clear();
+    }
+
+    ImVec2 visibleMin, visibleMax;
+    GetVisibleRect(state, state.view, &visibleMin, &visibleMax);
+    const ImVec2 center{
+      (visibleMin.x + visibleMax.x) * 0.5f, (visibleMin.y + visibleMax.y) * 0.5f };
+    for (Item& item : items)
+    {
+      ImVec2 tileMin, tileMax;
+      grid.TileBounds(item.key, &tileMin, &tileMax);
+      item.visible = tileMin.x < visibleMax.x && tileMax.x > visibleMin.x &&
+        tileMin.y < visibleMax.y && tileMax.y > visibleMin.y;
+      const float dx{ (tileMin.x + tileMax.x) * 0.5f - center.x };
+      const float dy{ (tileMin.y + tileMax.y) * 0.5f - center.y };
+      item.distance = dx * dx + dy * dy;
+    }
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+      if (a.visible != b.visible)
+      {
+        return a.visible;
+      }
+      if (a.key.level != b.key.level)
+      {
+        return a.key.level > b.key.level;
+      }
+      return a.distance < b.distance;
+    });
+
+    budget.NewFrame();
+    int uploads{ 0 };
+    std::size_t bytes{ 0 };
+    std::size_t next{ 0 };
+    for (; next < items.size(); ++next)
+    {
+      const TileImage& image{ *items[next].image };
+      const std::size_t size{ image.pixels.size() * sizeof(ImU32) };
+      if (!budget.TryConsume(size))
+      {
+        break;
+      }
+      const double start{ Clock() };
+      upload(items[next].key, image);
+      budget.ReportUpload(size, Clock() - start);
+      ++uploads;
+      bytes += size;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (; next < items.size(); ++next)
+    { // deferred, unless a newer version was queued meanwhile
+      pending_.try_emplace(items[next].key, std::move(items[next].image));
+    }
+    stats_.uploaded += static_cast<std::uint64_t>(uploads);
+    stats_.uploadedBytes += bytes;
+    stats_.lastFrameUploads = uploads;
+    stats_.lastFrameBytes = bytes;
+    return uploads;
+  }
+
+  template <typename Predicate>
+  inline void UploadScheduler::EraseIf(Predicate&& predicate)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = pending_.begin(); it != pending_.end();)
+    {
+      it = predicate(it->first) ? pending_.erase(it) : std::next(it);
+    }
+  }
+
+  inline void UploadScheduler::Clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+  }
+
+  inline bool UploadScheduler::IsPending(const TileKey& key) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.find(key) != pending_.end();
+  }
+
+  inline UploadScheduler::Stats UploadScheduler::GetStats() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats{ stats_ };
+    stats.pending = pending_.size();
+    return stats;
+  }
+
+  inline ImTextureID CpuTextureProvider::Create(const TextureDesc& desc)
+  {
+    if (desc.width <= 0 || desc.height <= 0)
+    {
+      return ImTextureID_Invalid;
+    }
+    const std::uintptr_t id{ nextId_++ };
+    Texture& texture{ textures_[id] };
+    texture.desc = desc;
+    texture.pixels.assign(desc.ByteSize(), 0);
+    ++stats_.creates;
+    return detail::IntToTextureId(id);
+  }
+
+  inline void CpuTextureProvider::Update(
+    ImTextureID id,
+    const TextureDesc& desc,
+    int x,
+    int y,
+    int width,
+    int height,
+    const void* pixels,
+    std::size_t stride)
+  {
+    auto it = textures_.find(detail::TextureIdToInt(id));
+    if (it == textures_.end() || !(it->second.desc == desc) ||
+        x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        x + width > desc.width || y + height > desc.height)
+    {
+      return;
+    }
+    const std::size_t pixelBytes{ static_cast<std::size_t>(BytesPerPixel(desc.format)) };
+    const std::size_t rowBytes{ static_cast<std::size_t>(width) * pixelBytes };
+    const auto* src = static_cast<const std::uint8_t*>(pixels);
+    for (int row = 0; row < height; ++row)
+    {
+      std::uint8_t* dst{ it->second.pixels.data() +
+        static_cast<std::size_t>(y + row) * desc.RowBytes() +
+        static_cast<std::size_t>(x) * pixelBytes };
+      std::memcpy(dst, src + static_cast<std::size_t>(row) * stride, rowBytes);
+    }
+    ++stats_.updates;
+    stats_.bytesUploaded += rowBytes * static_cast<std::size_t>(height);
+  }
+
+  inline void CpuTextureProvider::Destroy(ImTextureID id)
+  {
+    if (textures_.erase(detail::TextureIdToInt(id)) > 0)
+    {
+      ++stats_.destroys;
+    }
+  }
+
+  inline const CpuTextureProvider::Texture* CpuTextureProvider::Find(
+    ImTextureID id) const
+  {
+    auto it = textures_.find(detail::TextureIdToInt(id));
+    return it != textures_.end() ? &it->second : nullptr;
+  }
+
+  inline std::size_t CpuTextureProvider::Size() const
+  {
+    return textures_.size();
+  }
+
+  inline CpuTextureProvider::Stats CpuTextureProvider::GetStats() const
+  {
+    return stats_;
+  }
+
+#if defined(IMGUI_ZOOMABLE_IMAGE_OPENGL)
+  namespace detail
+  {
+    inline void GLTextureFormat(TextureFormat format,
+      GLint* internalFormat, GLenum* pixelFormat)
+    {
+      switch (format)
+      {
+      case TextureFormat::R8:
+#if defined(GL_R8)
+        *internalFormat = GL_R8;
+        *pixelFormat = GL_RED;
+#else
+        *internalFormat = GL_LUMINANCE;
+        *pixelFormat = GL_LUMINANCE;
+#endif
+        return;
+      case TextureFormat::RGBA8:
+        break;
+      }
+      *internalFormat = GL_RGBA;
+      *pixelFormat = GL_RGBA;
+    }
+  }
+
+  inline ImTextureID OpenGLTextureProvider::Create(const TextureDesc& desc)
+  {
+    if (desc.width <= 0 || desc.height <= 0)
+    {
+      return ImTextureID_Invalid;
+    }
+    GLuint texture{ 0 };
+    glGenTextures(1, &texture);
+    if (texture == 0)
+    {
+      return ImTextureID_Invalid;
+    }
+    GLint internalFormat;
+    GLenum pixelFormat;
+    detail::GLTextureFormat(desc.format, &internalFormat, &pixelFormat);
+
+    const GLint filter{ linearFilter ? GL_LINEAR : GL_NEAREST };
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+#if defined(GL_CLAMP_TO_EDGE)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+#endif
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat,
+      static_cast<GLsizei>(desc.width), static_cast<GLsizei>(desc.height), 0,
+      pixelFormat, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return detail::IntToTextureId(texture);
+  }
+
+  inline void OpenGLTextureProvider::Update(
+    ImTextureID id,
+    const TextureDesc& desc,
+    int x,
+    int y,
+    int width,
+    int height,
+    const void* pixels,
+    std::size_t stride)
+  {
+    if (width <= 0 || height <= 0 || pixels == nullptr)
+    {
+      return;
+    }
+    GLint internalFormat;
+    GLenum pixelFormat;
+    detail::GLTextureFormat(desc.format, &internalFormat, &pixelFormat);
+    const std::size_t pixelBytes{ static_cast<std::size_t>(BytesPerPixel(desc.format)) };
+
+    // the unpack state is restored afterwards, the caller may rely on it
+    GLint alignment{ 4 };
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(detail::TextureIdToInt(id)));
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+#if defined(GL_UNPACK_ROW_LENGTH)
+    GLint rowLength{ 0 };
+    glGetIntegerv(GL_UNPACK_ROW_LENGTH, &rowLength);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(stride / pixelBytes));
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height,
+      pixelFormat, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+#else
+    if (stride == static_cast<std::size_t>(width) * pixelBytes)
+    {
+      glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height,
+        pixelFormat, GL_UNSIGNED_BYTE, pixels);
+    }
+    else
+    { // no row length support (OpenGL ES 2), upload row by row
+      const auto* src = static_cast<const std::uint8_t*>(pixels);
+      for (int row = 0; row < height; ++row)
+      {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y + row, width, 1,
+          pixelFormat, GL_UNSIGNED_BYTE,
+          src + static_cast<std::size_t>(row) * stride);
+      }
+    }
+#endif
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+
+  inline void OpenGLTextureProvider::Destroy(ImTextureID id)
+  {
+    const GLuint texture{ static_cast<GLuint>(detail::TextureIdToInt(id)) };
+    glDeleteTextures(1, &texture);
+  }
+#endif
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_TEXTURE_H
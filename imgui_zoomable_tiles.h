@@ -0,0 +1,1328 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Tiles
+// ============================
+// Building blocks for displaying images that are too large, or change too
+// often, to live in a single texture. The image is split into a pyramid of
+// fixed-size tiles and only the tiles visible at the current zoom level are
+// drawn.
+//
+// Contents
+// --------
+// - `TileKey`, `TileGrid`: tile addressing and pyramid geometry.
+// - `ThreadPool`, `ParallelFor()`: background and data-parallel execution.
+// - `TileCache`, `TileImage`: thread-safe LRU cache of decoded tile data.
+// - `ViewPredictor`: prefetching of the tiles ahead of panning and zooming.
+// - `ZoomableTiles()`: a `Zoomable()` variant that draws tile textures.
+//
+// Usage
+// -----
+//    ImGuiImage::TileGrid grid(width, height);
+//    ImGuiImage::State state;
+//    state.textureSize = ImVec2(width, height);
+//
+//    ...
+//
+//    ImGuiImage::ZoomableTiles(grid, 0, displaySize, &state,
+//      [&](const ImGuiImage::TileKey& key) {
+//        // return the texture holding `key`, or an invalid `TileTexture`
+//        // if the tile is not resident yet
+//        return LookupTileTexture(key);
+//      });
+//
+
+#ifndef IMGUI_ZOOMABLE_TILES_H
+#define IMGUI_ZOOMABLE_TILES_H
+
+#include "imgui_zoomable_image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// SIMD
+// ====
+// SSE2 code paths are used when the target supports them (always the case on
+// x86-64). Define IMGUI_ZOOMABLE_IMAGE_DISABLE_SIMD to force the scalar code.
+#if !defined(IMGUI_ZOOMABLE_IMAGE_DISABLE_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define IMGUI_ZOOMABLE_IMAGE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Address of a tile in a tiled image pyramid.
+  //
+  // Members:
+  // - layer: Index of the image the tile belongs to, for sources holding more
+  //          than one image (slices of a volume, frames of a sequence, ...).
+  // - level: Pyramid level, 0 is full resolution and each level halves the
+  //          size of the previous one.
+  // - x, y: Column and row of the tile within the level.
+  struct TileKey
+  {
+    int layer = 0;
+    int level = 0;
+    int x = 0;
+    int y = 0;
+
+    bool operator==(const TileKey& other) const = default;
+  };
+
+  // Hash functor so `TileKey` can be used in unordered containers.
+  struct TileKeyHash
+  {
+    std::size_t operator()(const TileKey& key) const;
+  };
+
+  // Geometry of a tiled image pyramid.
+  //
+  // Level 0 has the full image size, level N is the image downsampled by
+  // 2^N (rounding up). Levels are added until the whole image fits in a
+  // single tile. All tile rectangles are reported in level 0 pixels so they
+  // can be compared against `ViewTransform::VisibleImageRect()` directly.
+  struct TileGrid
+  {
+    int width = 0;
+    int height = 0;
+    int tileSize = 256;
+    int levelCount = 1;
+
+    TileGrid() = default;
+    TileGrid(int imageWidth, int imageHeight, int tileSizePixels = 256);
+
+    // Size of a pyramid level in pixels.
+    int LevelWidth(int level) const;
+    int LevelHeight(int level) const;
+
+    // Number of tile columns and rows of a pyramid level.
+    int TilesX(int level) const;
+    int TilesY(int level) const;
+
+    // Size in pixels of the tile data for `key`. Border tiles are smaller
+    // than `tileSize` when the level size is not a multiple of it.
+    int TileWidth(const TileKey& key) const;
+    int TileHeight(const TileKey& key) const;
+
+    // Area covered by a tile, in level 0 pixels.
+    void TileBounds(const TileKey& key, ImVec2* min, ImVec2* max) const;
+
+    // Coarsest level whose pixels are not magnified beyond `scale` screen
+    // pixels per level 0 pixel, i.e. the cheapest level that still shows
+    // full detail at that scale.
+    int LevelForScale(float scale) const;
+
+    // Append to `out` the tiles of `level` overlapping the rectangle
+    // [min, max] (in level 0 pixels), ordered from the center of the
+    // rectangle outwards so the most relevant tiles come first.
+    void VisibleTiles(
+      const ImVec2& min,
+      const ImVec2& max,
+      int level,
+      int layer,
+      std::vector<TileKey>* out) const;
+  };
+
+  // Fixed-size pool of worker threads executing prioritized tasks.
+  //
+  // Tasks with a higher priority run first; tasks with the same priority
+  // run in submission order. Tasks are plain callables and should check by
+  // themselves whether their result is still wanted when they start, since
+  // queued work may become stale while it waits (e.g. a tile that scrolled
+  // out of view).
+  class ThreadPool
+  {
+  public:
+    // Create a pool with `threadCount` workers (0 = hardware concurrency
+    // minus one, at least one).
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task for execution.
+    void Submit(int priority, std::function<void()> task);
+
+    // Drop all queued tasks that have not started yet.
+    void Clear();
+
+    // Number of tasks waiting to run.
+    std::size_t Pending() const;
+
+    // Number of worker threads.
+    unsigned ThreadCount() const;
+
+    // Process-wide pool shared by the data sources of this library.
+    static ThreadPool& Default();
+
+    // Priority used by `ParallelFor()`, above any background work.
+    static constexpr int kUrgentPriority = 1 << 30;
+
+  private:
+    struct Task
+    {
+      int priority;
+      std::uint64_t sequence;
+      std::function<void()> function;
+
+      bool operator<(const Task& other) const;
+    };
+
+    void WorkerLoop();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    std::priority_queue<Task> tasks_;
+    std::vector<std::thread> workers_;
+    std::uint64_t sequence_ = 0;
+    bool stopping_ = false;
+  };
+
+  namespace detail
+  {
+    // Bookkeeping of the tasks a data source submits to a `ThreadPool`.
+    //
+    // The source and its tasks share a state derived from this one, held by
+    // `std::shared_ptr` on both sides and guarded by `mutex`. Tasks are
+    // counted while they run, so the source can wait for them before the
+    // callbacks and buffers they use go away.
+    struct BackgroundTasks
+    {
+      std::mutex mutex;
+      std::condition_variable idle;
+      int running = 0;
+      bool closed = false;
+
+      // Start a task, unless the source is closed or `superseded()`, called
+      // with the lock held, returns true. Returns whether the task runs.
+      template <typename SupersededFn>
+      bool Begin(SupersededFn&& superseded);
+      bool Begin();
+
+      // Finish a started task. `finish()` is called with the lock held and
+      // returns whether to pass the result on; `deliver()` then runs without
+      // the lock, unless the source was closed meanwhile. A task started
+      // later may have finished first, so `finish()` must check that its
+      // result is still the newest.
+      template <typename FinishFn, typename DeliverFn>
+      void End(FinishFn&& finish, DeliverFn&& deliver);
+      template <typename FinishFn>
+      void End(FinishFn&& finish);
+
+      // Wait until no task runs; `lock` holds `mutex`.
+      void WaitIdle(std::unique_lock<std::mutex>& lock);
+
+      // Skip the queued tasks and wait for the running ones.
+      void Close();
+    };
+  } // namespace detail
+
+  // Run `fn(i)` for every `i` in [begin, end), splitting the range in chunks
+  // of `grain` indices executed by the calling thread and the workers of
+  // `pool`. Returns when all indices have been processed. The calling thread
+  // always takes part, so it makes progress even if the pool is busy.
+  template <typename Fn>
+  void ParallelFor(
+    int begin,
+    int end,
+    Fn&& fn,
+    int grain = 1,
+    ThreadPool& pool = ThreadPool::Default());
+
+  // Thread-safe least-recently-used cache of tile data.
+  //
+  // Values are held by `std::shared_ptr` so readers can keep using a tile
+  // after it has been evicted by another thread.
+  template <typename T>
+  class TileCache
+  {
+  public:
+    explicit TileCache(std::size_t capacity = 256);
+
+    // Maximum number of tiles kept; shrinking evicts immediately.
+    void SetCapacity(std::size_t capacity);
+    std::size_t Capacity() const;
+    std::size_t Size() const;
+
+    // Return the tile for `key` and mark it as recently used, or nullptr.
+    std::shared_ptr<const T> Find(const TileKey& key);
+
+    // Return whether `key` is cached without touching its recency.
+    bool Contains(const TileKey& key) const;
+
+    // Insert or replace the tile for `key`.
+    void Insert(const TileKey& key, std::shared_ptr<const T> value);
+
+    // Remove a single tile, or all tiles matching `predicate`.
+    void Erase(const TileKey& key);
+    template <typename Predicate>
+    void EraseIf(Predicate&& predicate);
+
+    void Clear();
+
+  private:
+    using Entry = std::pair<TileKey, std::shared_ptr<const T>>;
+
+    void Trim();
+
+    mutable std::mutex mutex_;
+    std::size_t capacity_;
+    std::list<Entry> entries_; // most recently used first
+    std::unordered_map<TileKey, typename std::list<Entry>::iterator,
+      TileKeyHash> index_;
+  };
+
+  // CPU-side RGBA image of a tile, in `IM_COL32` byte order (R, G, B, A in
+  // memory), row-major without padding. This is the layout expected by
+  // `GL_RGBA`/`GL_UNSIGNED_BYTE` and `DXGI_FORMAT_R8G8B8A8_UNORM` uploads.
+  struct TileImage
+  {
+    int width = 0;
+    int height = 0;
+    std::vector<ImU32> pixels;
+  };
+
+  // Texture and UV rectangle holding a tile, as returned by the lookup
+  // callback of `ZoomableTiles()`. Set `valid` to false for tiles that are
+  // not resident. An `alpha` below 1 blends the tile over its fallback, to
+  // fade tiles in as they arrive.
+  struct TileTexture
+  {
+    ImTextureRef texRef;
+    ImVec2 uv0 = ImVec2(0.0f, 0.0f);
+    ImVec2 uv1 = ImVec2(1.0f, 1.0f);
+    float alpha = 1.0f;
+    bool valid = false;
+  };
+
+  // Predicts which tiles are about to become visible from the recent pan
+  // and zoom velocity of a view, so they can be requested before they are
+  // needed.
+  //
+  // Call `Observe()` for every tile the view looks up (e.g. from the lookup
+  // callback of `ZoomableTiles()`), then `Update()` once per frame. The view
+  // rectangle is extrapolated `lookahead` seconds ahead, and the tiles of
+  // the extrapolated rectangle that are not visible yet are returned for
+  // prefetching at a low priority. While zooming in, the tiles of the next
+  // finer level are included as well.
+  //
+  // Usage
+  // -----
+  //    ImGuiImage::ZoomableTiles(grid, slice, displaySize, &state,
+  //      [&](const ImGuiImage::TileKey& key) {
+  //        predictor.Observe(key);
+  //        return LookupTileTexture(key);
+  //      });
+  //    for (const ImGuiImage::TileKey& key : predictor.Update(grid, state))
+  //    {
+  //      volume.PrefetchTile(key);
+  //    }
+  //
+  // Members:
+  // - lookahead: How far ahead, in seconds, the view is extrapolated.
+  // - smoothing: Weight of each frame in the velocity estimate, in (0, 1].
+  // - maxTiles: Maximum number of tiles returned by one `Update()`.
+  class ViewPredictor
+  {
+  public:
+    float lookahead = 0.3f;
+    float smoothing = 0.3f;
+    std::size_t maxTiles = 64;
+
+    // Statistics
+    //
+    // - predicted: Tiles returned for prefetching.
+    // - hits: Predicted tiles that became visible within twice `lookahead`.
+    // - expired: Predicted tiles that did not.
+    // - appeared: Tiles of the displayed level that became visible,
+    //             predicted or not.
+    struct Stats
+    {
+      std::uint64_t predicted = 0;
+      std::uint64_t hits = 0;
+      std::uint64_t expired = 0;
+      std::uint64_t appeared = 0;
+
+      // Fraction of the settled predictions that were right.
+      float HitRate() const;
+
+      // Fraction of the tiles that became visible and had been predicted.
+      float Coverage() const;
+    };
+
+    // Record a tile visible in the current frame. The finest level observed
+    // is the displayed one; coarser tiles are the fallbacks looked up by
+    // `ZoomableTiles()` and are not counted in the statistics.
+    void Observe(const TileKey& key);
+
+    // Update the velocity estimate with the view of `state` at time `now`
+    // (`Clock()` seconds) and return the tiles to prefetch, most relevant
+    // first. The result is valid until the next call.
+    const std::vector<TileKey>& Update(
+      const TileGrid& grid,
+      const State& state,
+      double now = Clock());
+
+    // Visible rectangle (in image pixels) extrapolated `seconds` ahead.
+    void Predict(float seconds, ImVec2* min, ImVec2* max) const;
+
+    // Current velocity estimates: pan in image pixels per second, zoom as
+    // the rate of change of the logarithm of the visible width (negative
+    // while zooming in).
+    ImVec2 PanVelocity() const;
+    float ZoomVelocity() const;
+
+    Stats GetStats() const;
+
+    // Forget the history, e.g. after the view jumps.
+    void Reset();
+
+  private:
+    std::unordered_set<TileKey, TileKeyHash> visible_;
+    std::unordered_set<TileKey, TileKeyHash> previousVisible_;
+    std::unordered_map<TileKey, double, TileKeyHash> predicted_;
+    std::vector<TileKey> prefetch_;
+    ImVec2 imageSize_;
+    ImVec2 center_;
+    ImVec2 halfSize_;
+    ImVec2 velocity_;
+    float zoomVelocity_ = 0.0f;
+    double lastTime_ = -1.0;
+    int level_ = -1;
+    int layer_ = 0;
+    Stats stats_;
+  };
+
+  // Draw a texture covering the image rectangle [imageMin, imageMax] (in
+  // image pixels) through `view`, following its rotation and flips.
+  IMGUI_API void DrawImageRect(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    ImTextureRef texRef,
+    const ImVec2& imageMin,
+    const ImVec2& imageMax,
+    const ImVec2& uv0 = kDefaultUV0,
+    const ImVec2& uv1 = kDefaultUV1,
+    ImU32 tintColor = IM_COL32_WHITE);
+
+  // Draw the tiles of `grid` visible in the screen rectangle [clipMin,
+  // clipMax] of `view`, clipped to it, as `ZoomableTiles()` does for the
+  // whole display area (see below). Only the tiles under the rectangle are
+  // looked up, so views split in several parts cost no more than one.
+  template <typename LookupFn>
+  void DrawTileLayer(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    const TileGrid& grid,
+    int layer,
+    LookupFn&& lookup,
+    const ImVec2& clipMin,
+    const ImVec2& clipMax,
+    const ImVec4& tintColor = kDefaultTintColor);
+
+  // Zoomable display of a tiled image
+  // =================================
+  // Same interaction as `Zoomable()`, but the image is drawn from the tiles of
+  // `grid` visible in the current view, at the pyramid level matching the
+  // zoom. `lookup(const TileKey&) -> TileTexture` is called once per visible
+  // tile; it must not block. `state->textureSize` is set from the grid.
+  // Tiles are drawn grouped by texture, so tiles sharing a texture (e.g. a
+  // `TileAtlas` page) are merged into a single draw command.
+  //
+  // Tiles that are not resident yet are replaced by the matching part of
+  // their nearest resident ancestor (looked up through `lookup` as well), so
+  // the view shows a coarser version instead of a hole and refines as the
+  // tiles arrive. The coarsest tile is looked up every frame.
+  //
+  // Parameters:
+  // ----------
+  // - grid: Pyramid geometry of the image.
+  // - layer: Layer passed in the keys given to `lookup`.
+  // - displaySize: The size to display the image within the ImGui window.
+  // - state: Zoom and pan state, as for `Zoomable()`.
+  // - lookup: Callback returning the texture of a tile.
+  // - bgColor: Background color behind the image.
+  // - tintColor: Tint color to apply to the tiles.
+  template <typename LookupFn>
+  void ZoomableTiles(
+    const TileGrid& grid,
+    int layer,
+    const ImVec2& displaySize,
+    State* state,
+    LookupFn&& lookup,
+    const ImVec4& bgColor = kDefaultBackgroundColor,
+    const ImVec4& tintColor = kDefaultTintColor);
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  inline std::size_t TileKeyHash::operator()(const TileKey& key) const
+  {
+    std::uint64_t h{ static_cast<std::uint32_t>(key.layer) };
+    h = h * 0x9E3779B97F4A7C15ull + static_cast<std::uint32_t>(key.level);
+    h = h * 0x9E3779B97F4A7C15ull + static_cast<std::uint32_t>(key.x);
+    h = h * 0x9E3779B97F4A7C15ull + static_cast<std::uint32_t>(key.y);
+    return static_cast<std::size_t>(h ^ (h >> 32));
+  }
+
+  inline TileGrid::TileGrid(int imageWidth, int imageHeight, int tileSizePixels)
+    : width(imageWidth), height(imageHeight), tileSize(std::max(1, tileSizePixels))
+  {
+    levelCount = 1;
+    while (LevelWidth(levelCount - 1) > tileSize ||
+           LevelHeight(levelCount - 1) > tileSize)
+    {
+      ++levelCount;
+    }
+  }
+
+  inline int TileGrid::LevelWidth(int level) const
+  {
+    return std::max(1, (width + (1 << level) - 1) >> level);
+  }
+
+  inline int TileGrid::LevelHeight(int level) const
+  {
+    return std::max(1, (height + (1 << level) - 1) >> level);
+  }
+
+  inline int TileGrid::TilesX(int level) const
+  {
+    return (LevelWidth(level) + tileSize - 1) / tileSize;
+  }
+
+  inline int TileGrid::TilesY(int level) const
+  {
+    return (LevelHeight(level) + tileSize - 1) / tileSize;
+  }
+
+  inline int TileGrid::TileWidth(const TileKey& key) const
+  {
+    return std::min(tileSize, LevelWidth(key.level) - key.x * tileSize);
+  }
+
+  inline int TileGrid::TileHeight(const TileKey& key) const
+  {
+    return std::min(tileSize, LevelHeight(key.level) - key.y * tileSize);
+  }
+
+  inline void TileGrid::TileBounds(
+    const TileKey& key, ImVec2* min, ImVec2* max) const
+  {
+    const float f{ static_cast<float>(1 << key.level) };
+    const float x0{ static_cast<float>(key.x * tileSize) * f };
+    const float y0{ static_cast<float>(key.y * tileSize) * f };
+    if (min != nullptr)
+    {
+      *min = ImVec2(x0, y0);
+    }
+    if (max != nullptr)
+    {
+      *max = ImVec2(
+        std::min(x0 + static_cast<float>(tileSize) * f, static_cast<float>(width)),
+        std::min(y0 + static_cast<float>(tileSize) * f, static_cast<float>(height)));
+    }
+  }
+
+  inline int TileGrid::LevelForScale(float scale) const
+  {
+    if (!(scale > 0.0f))
+    {
+      return levelCount - 1;
+    }
+    // level N shows 2^N level 0 pixels per level N pixel, pick the largest
+    // N with 2^N <= 1/scale
+    const int level{ static_cast<int>(std::floor(std::log2(1.0f / scale))) };
+    return std::clamp(level, 0, levelCount - 1);
+  }
+
+  inline void TileGrid::VisibleTiles(
+    const ImVec2& min,
+    const ImVec2& max,
+    int level,
+    int layer,
+    std::vector<TileKey>* out) const
+  {
+    if (out == nullptr || max.x <= min.x || max.y <= min.y)
+    {
+      return;
+    }
+    const float span{ static_cast<float>(tileSize << level) };
+    const int x0{ std::max(0, static_cast<int>(std::floor(min.x / span))) };
+    const int y0{ std::max(0, static_cast<int>(std::floor(min.y / span))) };
+    const int x1{ std::min(TilesX(level), static_cast<int>(std::ceil(max.x / span))) };
+    const int y1{ std::min(TilesY(level), static_cast<int>(std::ceil(max.y / span))) };
+
+    const std::size_t first{ out->size() };
+    for (int y = y0; y < y1; ++y)
+    {
+      for (int x = x0; x < x1; ++x)
+      {
+        out->push_back(TileKey{ layer, level, x, y });
+      }
+    }
+
+    // order by distance to the center of the rectangle
+    const float cx{ (min.x + max.x) * 0.5f / span - 0.5f };
+    const float cy{ (min.y + max.y) * 0.5f / span - 0.5f };
+    std::sort(out->begin() + static_cast<std::ptrdiff_t>(first), out->end(),
+      [cx, cy](const TileKey& a, const TileKey& b) {
+        const float da{ (a.x - cx) * (a.x - cx) + (a.y - cy) * (a.y - cy) };
+        const float db{ (b.x - cx) * (b.x - cx) + (b.y - cy) * (b.y - cy) };
+        return da < db;
+      });
+  }
+
+  inline bool ThreadPool::Task::operator<(const Task& other) const
+  { // std::priority_queue pops the largest element first
+    if (priority != other.priority)
+    {
+      return priority < other.priority;
+    }
+    return sequence > other.sequence;
+  }
+
+  inline ThreadPool::ThreadPool(unsigned threadCount)
+  {
+    if (threadCount == 0)
+    {
+      const unsigned hw{ std::thread::hardware_concurrency() };
+      threadCount = hw > 1 ? hw - 1 : 1;
+    }
+    workers_.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+      workers_.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+
+  inline ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      tasks_ = {};
+    }
+    wakeUp_.notify_all();
+    for (auto& worker : workers_)
+    {
+      worker.join();
+    }
+  }
+
+  inline void ThreadPool::Submit(int priority, std::function<void()> task)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push(Task{ priority, sequence_++, std::move(task) });
+    }
+    wakeUp_.notify_one();
+  }
+
+  inline void ThreadPool::Clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_ = {};
+  }
+
+  inline std::size_t ThreadPool::Pending() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+  }
+
+  inline unsigned ThreadPool::ThreadCount() const
+  {
+    return static_cast<unsigned>(workers_.size());
+  }
+
+  inline ThreadPool& ThreadPool::Default()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  inline void ThreadPool::WorkerLoop()
+  {
+    for (;;)
+    {
+      std::function<void()> function;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wakeUp_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+        if (stopping_)
+        {
+          return;
+        }
+        function = std::move(const_cast<Task&>(tasks_.top()).function);
+        tasks_.pop();
+      }
+      function();
+    }
+  }
+
+  template <typename Fn>
+  inline void ParallelFor(int begin, int end, Fn&& fn, int grain, ThreadPool& pool)
+  {
+    if (end <= begin)
+    {
+      return;
+    }
+    grain = std::max(1, grain);
+    const int chunkCount{ (end - begin + grain - 1) / grain };
+    const int helperCount{
+      std::min(chunkCount - 1, static_cast<int>(pool.ThreadCount())) };
+    if (helperCount <= 0)
+    { // not worth dispatching
+      for (int i = begin; i < end; ++i)
+      {
+        fn(i);
+      }
+      return;
+    }
+
+    // Shared with the helpers, which may start after this call returned if
+    // the pool was busy; by then there are no chunks left and they exit.
+    struct Shared
+    {
+      std::function<void(int)> body;
+      int begin, end, grain, chunkCount;
+      std::atomic<int> nextChunk{ 0 };
+      std::atomic<int> doneChunks{ 0 };
+      std::mutex mutex;
+      std::condition_variable finished;
+
+      void Run()
+      {
+        int processed{ 0 };
+        for (int c = nextChunk.fetch_add(1); c < chunkCount; c = nextChunk.fetch_add(1))
+        {
+          const int i1{ std::min(end, begin + (c + 1) * grain) };
+          for (int i = begin + c * grain; i < i1; ++i)
+          {
+            body(i);
+          }
+          ++processed;
+        }
+        if (processed > 0 &&
+            doneChunks.fetch_add(processed) + processed == chunkCount)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          finished.notify_all();
+        }
+      }
+    };
+
+    auto shared{ std::make_shared<Shared>() };
+    shared->body = [&fn](int i) { fn(i); };
+    shared->begin = begin;
+    shared->end = end;
+    shared->grain = grain;
+    shared->chunkCount = chunkCount;
+    for (int h = 0; h < helperCount; ++h)
+    {
+      pool.Submit(ThreadPool::kUrgentPriority, [shared] { shared->Run(); });
+    }
+    shared->Run();
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->finished.wait(lock,
+      [&] { return shared->doneChunks.load() == chunkCount; });
+  }
+
+  namespace detail
+  {
+    template <typename SupersededFn>
+    inline bool BackgroundTasks::Begin(SupersededFn&& superseded)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (closed || superseded())
+      {
+        return false;
+      }
+      ++running;
+      return true;
+    }
+
+    inline bool BackgroundTasks::Begin()
+    {
+      return Begin([] { return false; });
+    }
+
+    template <typename FinishFn, typename DeliverFn>
+    inline void BackgroundTasks::End(FinishFn&& finish, DeliverFn&& deliver)
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (finish() && !closed)
+      { // the source waits for this task before its callbacks go away
+        lock.unlock();
+        deliver();
+        lock.lock();
+      }
+      --running;
+      idle.notify_all();
+    }
+
+    template <typename FinishFn>
+    inline void BackgroundTasks::End(FinishFn&& finish)
+    {
+      End([&] { finish(); return false; }, [] {});
+    }
+
+    inline void BackgroundTasks::WaitIdle(std::unique_lock<std::mutex>& lock)
+    {
+      idle.wait(lock, [this] { return running == 0; });
+    }
+
+    inline void BackgroundTasks::Close()
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      closed = true;
+      WaitIdle(lock);
+    }
+  } // namespace detail
+
+  template <typename T>
+  inline TileCache<T>::TileCache(std::size_t capacity)
+    : capacity_(capacity)
+  {
+  }
+
+  template <typename T>
+  inline void TileCache<T>::SetCapacity(std::size_t capacity)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    Trim();
+  }
+
+  template <typename T>
+  inline std::size_t TileCache<T>::Capacity() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+  }
+
+  template <typename T>
+  inline std::size_t TileCache<T>::Size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  template <typename T>
+  inline std::shared_ptr<const T> TileCache<T>::Find(const TileKey& key)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it{ index_.find(key) };
+    if (it == index_.end())
+    {
+      return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+  }
+
+  template <typename T>
+  inline bool TileCache<T>::Contains(const TileKey& key) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.find(key) != index_.end();
+  }
+
+  template <typename T>
+  inline void TileCache<T>::Insert(
+    const TileKey& key, std::shared_ptr<const T> value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it{ index_.find(key) };
+    if (it != index_.end())
+    {
+      it->second->second = std::move(value);
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return;
+    }
+    entries_.emplace_front(key, std::move(value));
+    index_.emplace(key, entries_.begin());
+    Trim();
+  }
+
+  template <typename T>
+  inline void TileCache<T>::Erase(const TileKey& key)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it{ index_.find(key) };
+    if (it != index_.end())
+    {
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+  }
+
+  template <typename T>
+  template <typename Predicate>
+  inline void TileCache<T>::EraseIf(Predicate&& predicate)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();)
+    {
+      if (predicate(it->first))
+      {
+        index_.erase(it->first);
+        it = entries_.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  template <typename T>
+  inline void TileCache<T>::Clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+  }
+
+  template <typename T>
+  inline void TileCache<T>::Trim()
+  {
+    while (entries_.size() > capacity_)
+    {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+  inline float ViewPredictor::Stats::HitRate() const
+  {
+    const std::uint64_t settled{ hits + expired };
+    return settled > 0 ?
+      static_cast<float>(hits) / static_cast<float>(settled) : 0.0f;
+  }
+
+  inline float ViewPredictor::Stats::Coverage() const
+  {
+    return appeared > 0 ?
+      static_cast<float>(hits) / static_cast<float>(appeared) : 0.0f;
+  }
+
+  inline void ViewPredictor::Observe(const TileKey& key)
+  {
+    if (visible_.insert(key).second)
+    {
+      level_ = visible_.size() == 1 ? key.level : std::min(level_, key.level);
+      layer_ = key.layer;
+    }
+  }
+
+  inline const std::vector<TileKey>& ViewPredictor::Update(
+    const TileGrid& grid,
+    const State& state,
+    double now)
+  {
+    ImVec2 visibleMin, visibleMax;
+    GetVisibleRect(state, state.view, &visibleMin, &visibleMax);
+    const ImVec2 center{
+      (visibleMin.x + visibleMax.x) * 0.5f, (visibleMin.y + visibleMax.y) * 0.5f };
+    const ImVec2 halfSize{
+      (visibleMax.x - visibleMin.x) * 0.5f, (visibleMax.y - visibleMin.y) * 0.5f };
+
+    const double dt{ now - lastTime_ };
+    if (lastTime_ >= 0.0 && dt > 0.0 && halfSize.x > 0.0f && halfSize_.x > 0.0f)
+    {
+      const float invDt{ static_cast<float>(1.0 / dt) };
+      const ImVec2 pan{
+        (center.x - center_.x) * invDt, (center.y - center_.y) * invDt };
+      const float zoom{ std::log(halfSize.x / halfSize_.x) * invDt };
+      velocity_.x += (pan.x - velocity_.x) * smoothing;
+      velocity_.y += (pan.y - velocity_.y) * smoothing;
+      zoomVelocity_ += (zoom - zoomVelocity_) * smoothing;
+    }
+    imageSize_ = state.textureSize;
+    center_ = center;
+    halfSize_ = halfSize;
+    lastTime_ = now;
+
+    // the displayed level is known once the frame is observed
+    std::erase_if(visible_, [this](const TileKey& key) { return key.level != level_; });
+    for (const TileKey& key : visible_)
+    {
+      if (previousVisible_.count(key) == 0)
+      {
+        ++stats_.appeared;
+        if (predicted_.erase(key) > 0)
+        {
+          ++stats_.hits;
+        }
+      }
+    }
+
+    // predictions not confirmed in time count as misses
+    const double expiry{ now - 2.0 * static_cast<double>(lookahead) };
+    for (auto it = predicted_.begin(); it != predicted_.end();)
+    {
+      if (it->second < expiry)
+      {
+        ++stats_.expired;
+        it = predicted_.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    previousVisible_.swap(visible_);
+    visible_.clear();
+    prefetch_.clear();
+    if (level_ < 0 || level_ >= grid.levelCount)
+    { // nothing observed yet
+      return prefetch_;
+    }
+
+    ImVec2 predictedMin, predictedMax;
+    Predict(lookahead, &predictedMin, &predictedMax);
+    std::vector<TileKey> candidates;
+    grid.VisibleTiles(predictedMin, predictedMax, level_, layer_, &candidates);
+    if (level_ > 0 && zoomVelocity_ * lookahead < -0.01f)
+    { // zooming in, the next finer level will be needed soon
+      grid.VisibleTiles(predictedMin, predictedMax, level_ - 1, layer_, &candidates);
+    }
+
+    for (const TileKey& key : candidates)
+    {
+      if (prefetch_.size() >= maxTiles)
+      {
+        break;
+      }
+      if (previousVisible_.count(key) != 0)
+      {
+        continue;
+      }
+      prefetch_.push_back(key);
+      if (predicted_.try_emplace(key, now).second)
+      {
+        ++stats_.predicted;
+      }
+    }
+    return prefetch_;
+  }
+
+  inline void ViewPredictor::Predict(float seconds, ImVec2* min, ImVec2* max) const
+  {
+    const float scale{ std::exp(zoomVelocity_ * seconds) };
+    const ImVec2 center{
+      center_.x + velocity_.x * seconds, center_.y + velocity_.y * seconds };
+    const ImVec2 halfSize{ halfSize_.x * scale, halfSize_.y * scale };
+    if (min != nullptr)
+    {
+      min->x = std::clamp(center.x - halfSize.x, 0.0f, imageSize_.x);
+      min->y = std::clamp(center.y - halfSize.y, 0.0f, imageSize_.y);
+    }
+    if (max != nullptr)
+    {
+      max->x = std::clamp(center.x + halfSize.x, 0.0f, imageSize_.x);
+      max->y = std::clamp(center.y + halfSize.y, 0.0f, imageSize_.y);
+    }
+  }
+
+  inline ImVec2 ViewPredictor::PanVelocity() const
+  {
+    return velocity_;
+  }
+
+  inline float ViewPredictor::ZoomVelocity() const
+  {
+    return zoomVelocity_;
+  }
+
+  inline ViewPredictor::Stats ViewPredictor::GetStats() const
+  {
+    return stats_;
+  }
+
+  inline void ViewPredictor::Reset()
+  {
+    visible_.clear();
+    previousVisible_.clear();
+    predicted_.clear();
+    prefetch_.clear();
+    velocity_ = ImVec2(0.0f, 0.0f);
+    zoomVelocity_ = 0.0f;
+    lastTime_ = -1.0;
+    level_ = -1;
+  }
+
+  inline void DrawImageRect(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    ImTextureRef texRef,
+    const ImVec2& imageMin,
+    const ImVec2& imageMax,
+    const ImVec2& uv0,
+    const ImVec2& uv1,
+    ImU32 tintColor)
+  {
+    if (view.IsIdentityOrientation())
+    {
+      drawList->AddImage(texRef,
+        view.ImageToScreen(imageMin), view.ImageToScreen(imageMax),
+        uv0, uv1, tintColor);
+      return;
+    }
+    // rotated or flipped views map the rectangle to an arbitrary quad
+    drawList->AddImageQuad(texRef,
+      view.ImageToScreen(imageMin),
+      view.ImageToScreen(ImVec2(imageMax.x, imageMin.y)),
+      view.ImageToScreen(imageMax),
+      view.ImageToScreen(ImVec2(imageMin.x, imageMax.y)),
+      uv0, ImVec2(uv1.x, uv0.y), uv1, ImVec2(uv0.x, uv1.y), tintColor);
+  }
+
+  namespace detail
+  {
+    // Tile rectangle (in image pixels) to draw with a texture.
+    struct TileDraw
+    {
+      ImTextureRef texRef;
+      ImVec2 min;
+      ImVec2 max;
+      ImVec2 uv0;
+      ImVec2 uv1;
+      ImU32 tint;
+    };
+
+    inline void DrawTiles(
+      ImDrawList* drawList,
+      const ViewTransform& view,
+      std::vector<TileDraw>* tiles)
+    {
+      // consecutive draws of the same texture merge into one draw command,
+      // so tiles sharing a texture (atlas page) are drawn together
+      std::stable_sort(tiles->begin(), tiles->end(),
+        [](const TileDraw& a, const TileDraw& b) {
+          return a.texRef.GetTexID() < b.texRef.GetTexID();
+        });
+      for (const TileDraw& tile : *tiles)
+      {
+        DrawImageRect(drawList, view, tile.texRef, tile.min, tile.max,
+          tile.uv0, tile.uv1, tile.tint);
+      }
+    }
+
+    // Image area under the screen rectangle [clipMin, clipMax] of `view`,
+    // bounded by its corners and clamped to the image.
+    inline void ClipImageRect(
+      const ViewTransform& view,
+      const ImVec2& clipMin,
+      const ImVec2& clipMax,
+      ImVec2* min,
+      ImVec2* max)
+    {
+      const ImVec2 corners[4]{
+        view.ScreenToImage(clipMin),
+        view.ScreenToImage(ImVec2(clipMax.x, clipMin.y)),
+        view.ScreenToImage(clipMax),
+        view.ScreenToImage(ImVec2(clipMin.x, clipMax.y)),
+      };
+      *min = corners[0];
+      *max = corners[0];
+      for (const ImVec2& corner : corners)
+      {
+        min->x = std::max(0.0f, std::min(min->x, corner.x));
+        min->y = std::max(0.0f, std::min(min->y, corner.y));
+        max->x = std::min(view.textureSize.x, std::max(max->x, corner.x));
+        max->y = std::min(view.textureSize.y, std::max(max->y, corner.y));
+      }
+    }
+
+    // Look up the tiles `keys` of `grid` and append the draws showing them
+    // to `tiles`, and the parts of their nearest resident ancestors showing
+    // in place of missing or fading tiles to `fallbacks`. Tile bounds are
+    // mapped to `offset + bounds * scale` in the image drawn.
+    template <typename LookupFn>
+    inline void CollectTileDraws(
+      const TileGrid& grid,
+      int layer,
+      const std::vector<TileKey>& keys,
+      LookupFn&& lookup,
+      const ImVec4& tintColor,
+      const ImVec2& offset,
+      const ImVec2& scale,
+      std::vector<TileDraw>* fallbacks,
+      std::vector<TileDraw>* tiles)
+    {
+      // the coarsest tile is looked up every frame so it is requested
+      // early and stays resident as the last fallback
+      std::unordered_map<TileKey, TileTexture, TileKeyHash> ancestors;
+      auto lookupAncestor = [&](const TileKey& key) -> const TileTexture& {
+        auto it = ancestors.find(key);
+        if (it == ancestors.end())
+        {
+          it = ancestors.emplace(key, lookup(key)).first;
+        }
+        return it->second;
+      };
+      lookupAncestor(TileKey{ layer, grid.levelCount - 1, 0, 0 });
+
+      const ImU32 tint{ ImGui::GetColorU32(tintColor) };
+      auto place = [&](const ImVec2& p) {
+        return ImVec2(offset.x + p.x * scale.x, offset.y + p.y * scale.y);
+      };
+      tiles->reserve(tiles->size() + keys.size());
+      for (const TileKey& key : keys)
+      {
+        const TileTexture tile{ lookup(key) };
+        ImVec2 tileMin, tileMax;
+        grid.TileBounds(key, &tileMin, &tileMax);
+        if (tile.valid)
+        {
+          tiles->push_back({ tile.texRef, place(tileMin), place(tileMax),
+            tile.uv0, tile.uv1, tile.alpha < 1.0f ? ImGui::GetColorU32(ImVec4(
+              tintColor.x, tintColor.y, tintColor.z, tintColor.w * tile.alpha)) : tint });
+          if (tile.alpha >= 1.0f)
+          {
+            continue;
+          }
+        }
+
+        // missing or fading in: show the part of the nearest resident
+        // ancestor covering the tile
+        for (TileKey parent{ key }; parent.level + 1 < grid.levelCount;)
+        {
+          ++parent.level;
+          parent.x >>= 1;
+          parent.y >>= 1;
+          const TileTexture& ancestor{ lookupAncestor(parent) };
+          if (!ancestor.valid)
+          {
+            continue;
+          }
+          ImVec2 parentMin, parentMax;
+          grid.TileBounds(parent, &parentMin, &parentMax);
+          auto crop = [&](float value, float min, float max, float uv0, float uv1) {
+            return uv0 + (value - min) / (max - min) * (uv1 - uv0);
+          };
+          fallbacks->push_back({ ancestor.texRef, place(tileMin), place(tileMax),
+            ImVec2(
+              crop(tileMin.x, parentMin.x, parentMax.x, ancestor.uv0.x, ancestor.uv1.x),
+              crop(tileMin.y, parentMin.y, parentMax.y, ancestor.uv0.y, ancestor.uv1.y)),
+            ImVec2(
+              crop(tileMax.x, parentMin.x, parentMax.x, ancestor.uv0.x, ancestor.uv1.x),
+              crop(tileMax.y, parentMin.y, parentMax.y, ancestor.uv0.y, ancestor.uv1.y)),
+            tint });
+          break;
+        }
+      }
+    }
+  }
+
+  template <typename LookupFn>
+  inline void DrawTileLayer(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    const TileGrid& grid,
+    int layer,
+    LookupFn&& lookup,
+    const ImVec2& clipMin,
+    const ImVec2& clipMax,
+    const ImVec4& tintColor)
+  {
+    if (clipMax.x <= clipMin.x || clipMax.y <= clipMin.y)
+    {
+      return;
+    }
+
+    ImVec2 visibleMin, visibleMax;
+    detail::ClipImageRect(view, clipMin, clipMax, &visibleMin, &visibleMax);
+    const ImVec2 scale{ view.Scale() };
+    const int level{ grid.LevelForScale(std::max(scale.x, scale.y)) };
+
+    std::vector<TileKey> keys;
+    grid.VisibleTiles(visibleMin, visibleMax, level, layer, &keys);
+
+    std::vector<detail::TileDraw> fallbacks;
+    std::vector<detail::TileDraw> tiles;
+    detail::CollectTileDraws(grid, layer, keys, lookup, tintColor,
+      ImVec2(0.0f, 0.0f), ImVec2(1.0f, 1.0f), &fallbacks, &tiles);
+
+    drawList->PushClipRect(clipMin, clipMax, true);
+    detail::DrawTiles(drawList, view, &fallbacks);
+    detail::DrawTiles(drawList, view, &tiles);
+    drawList->PopClipRect();
+  }
+
+  template <typename LookupFn>
+  inline void ZoomableTiles(
+    const TileGrid& grid,
+    int layer,
+    const ImVec2& displaySize,
+    State* state,
+    LookupFn&& lookup,
+    const ImVec4& bgColor,
+    const ImVec4& tintColor)
+  {
+    if (state != nullptr)
+    {
+      state->textureSize = ImVec2(
+        static_cast<float>(grid.width), static_cast<float>(grid.height));
+    }
+
+    ZoomableCustom(displaySize, state,
+      [&](ImDrawList* drawList, const ViewTransform& view) {
+        const ImVec2 screenMax{
+          view.screenPos.x + view.displaySize.x,
+          view.screenPos.y + view.displaySize.y };
+        if (bgColor.w > 0.0f)
+        {
+          drawList->AddRectFilled(view.screenPos, screenMax,
+            ImGui::GetColorU32(bgColor));
+        }
+        DrawTileLayer(drawList, view, grid, layer, lookup,
+          view.screenPos, screenMax, tintColor);
+      });
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_TILES_H
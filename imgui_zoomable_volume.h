@@ -0,0 +1,1136 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2025 Daniel Moreno
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+//
+// ImGui Zoomable Image - Volumes
+// ==============================
+// Slice-by-slice display of 3D image stacks (confocal, CT, ...) stored as raw
+// voxel files. The file is memory-mapped, so opening a stack of thousands of
+// slices is instantaneous and only the voxels actually displayed are read.
+//
+// Slices are decoded tile by tile on the shared `ThreadPool`. Whenever a tile
+// of the current slice is requested, the same tile of the next slices in the
+// scrub direction (and a few behind) is decoded in the background, so moving
+// the slice slider shows already decoded tiles. Only tiles that are visible
+// are ever requested, so the cache holds the visible region of the nearby
+// slices rather than whole slices.
+//
+// The zoom and pan state lives in `ImGuiImage::State` and is independent of
+// the slice index, so the view is kept while scrubbing.
+//
+// `VolumeReslicer` computes the orthogonal XZ and YZ planes through a
+// crosshair for multi-planar views.
+//
+// Usage
+// -----
+//    #include "imgui_zoomable_volume.h"
+//
+//    ImGuiImage::VolumeDesc desc;
+//    desc.width = 2048; desc.height = 2048; desc.depth = 2000;
+//    desc.voxelType = ImGuiImage::VoxelType::UInt16;
+//    ImGuiImage::VolumeSource volume;
+//    volume.Open("stack.raw", desc);
+//    volume.SetWindow(0.0f, 4095.0f);
+//
+//    ...
+//
+//    ImGui::SliderInt("Slice", &slice, 0, desc.depth - 1);
+//    volume.SetSlice(slice);
+//    ImGuiImage::ZoomableTiles(volume.Grid(), slice, displaySize, &state,
+//      [&](const ImGuiImage::TileKey& key) {
+//        ImGuiImage::TileTexture tile;
+//        if (auto pixels = volume.RequestTile(key))
+//        { // upload `pixels` to a texture (once) and return it
+//          tile.texRef = UploadTile(key, *pixels);
+//          tile.valid = true;
+//        }
+//        return tile;
+//      });
+//
+
+#ifndef IMGUI_ZOOMABLE_VOLUME_H
+#define IMGUI_ZOOMABLE_VOLUME_H
+
+#include "imgui_zoomable_tiles.h"
+
+#include <cstring>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ----------------------------------- Interface ------------------------------
+namespace ImGuiImage
+{
+  // Read-only memory mapping of a whole file.
+  class MappedFile
+  {
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map `path`. Returns false if the file cannot be opened or mapped.
+    bool Open(const char* path);
+    void Close();
+
+    bool IsOpen() const;
+    const std::uint8_t* Data() const;
+    std::size_t Size() const;
+
+    // Hint the OS to start reading [offset, offset + size) into memory.
+    void Prefetch(std::size_t offset, std::size_t size) const;
+
+  private:
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+  };
+
+  // Voxel data types supported by `VolumeSource`. Multi-byte types are read
+  // in native byte order.
+  enum class VoxelType
+  {
+    UInt8,
+    UInt16,
+    Float32,
+  };
+
+  // Layout of a raw volume file.
+  //
+  // Members:
+  // - width, height, depth: Size of the volume in voxels.
+  // - voxelType: Type of each voxel.
+  // - headerSize: Number of bytes before the first voxel.
+  // - sliceStride: Number of bytes from one slice to the next (0 = slices are
+  //                packed, i.e. `width * height * sizeof(voxel)`).
+  struct VolumeDesc
+  {
+    int width = 0;
+    int height = 0;
+    int depth = 0;
+    VoxelType voxelType = VoxelType::UInt8;
+    std::size_t headerSize = 0;
+    std::size_t sliceStride = 0;
+
+    std::size_t VoxelSize() const;
+    std::size_t SliceSize() const;
+  };
+
+  // Tiled, prefetching slice source for a memory-mapped volume.
+  //
+  // Tiles are keyed by `TileKey` with `layer` being the slice index. Voxels
+  // are mapped to gray levels through the display window set with
+  // `SetWindow()`.
+  class VolumeSource
+  {
+  public:
+    VolumeSource();
+    ~VolumeSource();
+
+    VolumeSource(const VolumeSource&) = delete;
+    VolumeSource& operator=(const VolumeSource&) = delete;
+
+    // Map a raw volume file. Returns false if the file cannot be mapped or
+    // is too small for `desc`.
+    bool Open(const char* path, const VolumeDesc& desc, int tileSize = 256);
+
+    // Use voxels already in memory. `data` must outlive the source.
+    bool Open(const void* data, std::size_t size, const VolumeDesc& desc,
+      int tileSize = 256);
+
+    void Close();
+
+    bool IsOpen() const;
+    const VolumeDesc& Desc() const;
+    const TileGrid& Grid() const;
+
+    // Pointer to the first voxel of a slice, or nullptr if out of range.
+    const std::uint8_t* SliceData(int slice) const;
+
+    // Voxel values mapped to black and white. Decoded tiles are discarded.
+    void SetWindow(float minValue, float maxValue);
+
+    // Number of slices decoded ahead of the current one in the scrub
+    // direction, and behind it.
+    void SetPrefetch(int ahead, int behind);
+
+    // Maximum number of decoded tiles kept in memory.
+    void SetCacheCapacity(std::size_t tiles);
+
+    // Set the slice being displayed. The difference to the previous slice
+    // gives the scrub direction used for prefetching.
+    void SetSlice(int slice);
+    int Slice() const;
+
+    // Return the decoded tile for `key`, or nullptr if it is not ready yet.
+    // Missing tiles are queued for decoding; the same tile of the nearby
+    // slices is queued at a lower priority. Never blocks.
+    std::shared_ptr<const TileImage> RequestTile(const TileKey& key);
+
+    // Queue a tile expected to be needed soon (see `ViewPredictor`) below
+    // the tiles requested for display. Not counted in the hit statistics.
+    void PrefetchTile(const TileKey& key, int priority = -1);
+
+    // Decode a tile on the calling thread.
+    void DecodeTile(const TileKey& key, TileImage* out) const;
+
+    // Statistics
+    struct Stats
+    {
+      std::size_t cachedTiles = 0;
+      std::size_t queuedTiles = 0;
+      std::uint64_t hits = 0;
+      std::uint64_t misses = 0;
+      int direction = 1;
+    };
+    Stats GetStats() const;
+
+  private:
+    // Display window, immutable once published so tasks can keep using the
+    // one they were queued with.
+    struct Window
+    {
+      float minValue = 0.0f;
+      float maxValue = 255.0f;
+      std::vector<std::uint8_t> lut; // integer voxel types only
+    };
+
+    // State shared with the decoding tasks. Queued tasks may outlive a
+    // `Close()`, which waits for the running ones.
+    struct Shared : detail::BackgroundTasks
+    {
+      MappedFile file;
+      const std::uint8_t* data = nullptr;
+      VolumeDesc desc;
+      TileGrid grid;
+      // the window, and the generation and cache contents that go with it
+      mutable std::mutex windowMutex;
+      std::shared_ptr<const Window> window;
+      TileCache<TileImage> cache{ 1024 };
+      std::mutex queuedMutex;
+      std::unordered_set<TileKey, TileKeyHash> queued;
+      std::atomic<int> slice{ 0 };
+      std::atomic<int> direction{ 1 };
+      std::atomic<int> ahead{ 8 };
+      std::atomic<int> behind{ 2 };
+      std::atomic<std::uint64_t> generation{ 0 };
+      std::atomic<std::uint64_t> hits{ 0 };
+      std::atomic<std::uint64_t> misses{ 0 };
+
+      void Decode(const TileKey& key, const Window& display, TileImage* out) const;
+      std::shared_ptr<const Window> CurrentWindow() const;
+
+      // Call `fn(read)` with `read(const std::uint8_t*) -> int` mapping one
+      // voxel of `desc` to a gray level through `display`.
+      template <typename Fn>
+      static void WithVoxelReader(
+        const VolumeDesc& desc, const Window& display, Fn&& fn);
+      bool IsWanted(const TileKey& key) const;
+    };
+
+    bool Attach(std::shared_ptr<Shared> shared, std::size_t size,
+      const VolumeDesc& desc, int tileSize);
+    void Enqueue(const TileKey& key, int priority);
+
+    std::shared_ptr<Shared> shared_;
+
+    friend class VolumeReslicer;
+  };
+
+  // Orthogonal planes of a volume. XY planes are the slices of the stack,
+  // XZ planes have `x` horizontally and `z` vertically, YZ planes have `y`
+  // horizontally and `z` vertically.
+  enum class SlicePlane
+  {
+    XY,
+    XZ,
+    YZ,
+  };
+
+  // Multi-planar reslicing of a `VolumeSource`.
+  //
+  // Keeps a crosshair position and computes, for each of the three
+  // orthogonal planes through it, only the region visible in that plane's
+  // view at the pyramid level matching its zoom. The work is split into
+  // blocks processed in parallel, so moving the crosshair updates the other
+  // two views within the same frame.
+  //
+  // Usage (one view per plane, each with its own `State`):
+  //
+  //    ImGuiImage::VolumeReslicer reslicer(&volume);
+  //
+  //    ...
+  //
+  //    state.textureSize = reslicer.PlaneSize(plane);
+  //    ImGuiImage::ZoomableCustom(displaySize, &state,
+  //      [&](ImDrawList* drawList, const ImGuiImage::ViewTransform& view) {
+  //        if (reslicer.Update(plane, view))
+  //        { // re-upload the plane image to its texture
+  //          UploadTexture(texture, reslicer.Image(plane).image);
+  //        }
+  //        const auto& planeImage = reslicer.Image(plane);
+  //        ImGuiImage::DrawImageRect(drawList, view, texture,
+  //          planeImage.min, planeImage.max);
+  //        reslicer.DrawCrosshair(drawList, view, plane);
+  //      });
+  //    if (ImGui::IsMouseDown(ImGuiMouseButton_Right))
+  //    {
+  //      reslicer.SetCrosshairFromView(plane, state.mousePosition);
+  //    }
+  class VolumeReslicer
+  {
+  public:
+    // Image computed for one plane.
+    //
+    // Members:
+    // - image: RGBA pixels of the computed region at `level`.
+    // - min, max: Region covered by `image`, in full resolution plane pixels.
+    // - index: Position of the plane along its normal axis.
+    // - level: Pyramid level (each level halves the resolution).
+    struct PlaneImage
+    {
+      TileImage image;
+      ImVec2 min = ImVec2(0.0f, 0.0f);
+      ImVec2 max = ImVec2(0.0f, 0.0f);
+      int index = -1;
+      int level = 0;
+      std::uint64_t generation = 0;
+      bool valid = false;
+    };
+
+    // Fraction of the visible size computed around the visible region, so
+    // small pans do not require a new computation.
+    float margin = 0.25f;
+
+    explicit VolumeReslicer(const VolumeSource* volume);
+
+    // Size of the images of a plane in pixels.
+    ImVec2 PlaneSize(SlicePlane plane) const;
+
+    // Crosshair position in voxels, clamped to the volume.
+    void SetCrosshair(int x, int y, int z);
+    void Crosshair(int* x, int* y, int* z) const;
+
+    // Move the crosshair to a point of a plane view, e.g. the
+    // `State::mousePosition` of that view. NaN points are ignored.
+    void SetCrosshairFromView(SlicePlane plane, const ImVec2& imagePoint);
+
+    // Recompute the image of `plane` if the crosshair, the display window or
+    // the region visible in `view` changed. Returns true if `Image(plane)`
+    // was updated and must be uploaded again.
+    bool Update(SlicePlane plane, const ViewTransform& view);
+
+    const PlaneImage& Image(SlicePlane plane) const;
+
+    // Compute the region [min, max] (full resolution plane pixels) of the
+    // plane at position `index` into `out`, or reset `out` to an empty
+    // image if the volume is not open.
+    void Compute(
+      SlicePlane plane,
+      int index,
+      int level,
+      const ImVec2& min,
+      const ImVec2& max,
+      PlaneImage* out) const;
+
+    // Draw the crosshair lines of the other two planes in a plane view.
+    void DrawCrosshair(
+      ImDrawList* drawList,
+      const ViewTransform& view,
+      SlicePlane plane,
+      ImU32 color = IM_COL32(255, 255, 0, 255)) const;
+
+  private:
+    int PlaneIndex(SlicePlane plane) const;
+
+    const VolumeSource* volume_;
+    int crosshair_[3] = { 0, 0, 0 };
+    PlaneImage images_[3];
+  };
+}
+
+// ----------------------------------- Implementation -------------------------
+namespace ImGuiImage
+{
+  inline MappedFile::~MappedFile()
+  {
+    Close();
+  }
+
+  inline bool MappedFile::Open(const char* path)
+  {
+    Close();
+#if defined(_WIN32)
+    file_ = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+      return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0)
+    {
+      Close();
+      return false;
+    }
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr)
+    {
+      Close();
+      return false;
+    }
+    data_ = static_cast<const std::uint8_t*>(
+      MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr)
+    {
+      Close();
+      return false;
+    }
+    size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+    const int fd{ ::open(path, O_RDONLY) };
+    if (fd < 0)
+    {
+      return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+      ::close(fd);
+      return false;
+    }
+    void* data{ ::mmap(nullptr, static_cast<std::size_t>(info.st_size),
+      PROT_READ, MAP_SHARED, fd, 0) };
+    ::close(fd); // the mapping keeps the file referenced
+    if (data == MAP_FAILED)
+    {
+      return false;
+    }
+    data_ = static_cast<const std::uint8_t*>(data);
+    size_ = static_cast<std::size_t>(info.st_size);
+#endif
+    return true;
+  }
+
+  inline void MappedFile::Close()
+  {
+#if defined(_WIN32)
+    if (data_ != nullptr)
+    {
+      UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr)
+    {
+      CloseHandle(mapping_);
+      mapping_ = nullptr;
+    }
+    if (file_ != INVALID_HANDLE_VALUE)
+    {
+      CloseHandle(file_);
+      file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (data_ != nullptr)
+    {
+      ::munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  inline bool MappedFile::IsOpen() const
+  {
+    return data_ != nullptr;
+  }
+
+  inline const std::uint8_t* MappedFile::Data() const
+  {
+    return data_;
+  }
+
+  inline std::size_t MappedFile::Size() const
+  {
+    return size_;
+  }
+
+  inline void MappedFile::Prefetch(std::size_t offset, std::size_t size) const
+  {
+    if (data_ == nullptr || offset >= size_)
+    {
+      return;
+    }
+    size = std::min(size, size_ - offset);
+#if defined(_WIN32)
+    (void)size;
+#else
+    // madvise needs a page-aligned address
+    const std::size_t page{ static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)) };
+    const std::size_t aligned{ offset - offset % page };
+    ::madvise(const_cast<std::uint8_t*>(data_) + aligned,
+      size + (offset - aligned), MADV_WILLNEED);
+#endif
+  }
+
+  inline std::size_t VolumeDesc::VoxelSize() const
+  {
+    switch (voxelType)
+    {
+    case VoxelType::UInt8: return 1;
+    case VoxelType::UInt16: return 2;
+    case VoxelType::Float32: return 4;
+    }
+    return 1;
+  }
+
+  inline std::size_t VolumeDesc::SliceSize() const
+  {
+    return static_cast<std::size_t>(width) * static_cast<std::size_t>(height) *
+      VoxelSize();
+  }
+
+  inline VolumeSource::VolumeSource() = default;
+
+  inline VolumeSource::~VolumeSource()
+  {
+    Close();
+  }
+
+  inline bool VolumeSource::Open(
+    const char* path, const VolumeDesc& desc, int tileSize)
+  {
+    Close();
+    auto shared{ std::make_shared<Shared>() };
+    if (!shared->file.Open(path))
+    {
+      return false;
+    }
+    shared->data = shared->file.Data();
+    const auto size{ shared->file.Size() };
+    return Attach(std::move(shared), size, desc, tileSize);
+  }
+
+  inline bool VolumeSource::Open(
+    const void* data, std::size_t size, const VolumeDesc& desc, int tileSize)
+  {
+    Close();
+    auto shared{ std::make_shared<Shared>() };
+    shared->data = static_cast<const std::uint8_t*>(data);
+    return Attach(std::move(shared), size, desc, tileSize);
+  }
+
+  inline bool VolumeSource::Attach(std::shared_ptr<Shared> shared,
+    std::size_t size, const VolumeDesc& desc, int tileSize)
+  {
+    if (shared->data == nullptr ||
+        desc.width <= 0 || desc.height <= 0 || desc.depth <= 0)
+    {
+      return false;
+    }
+    VolumeDesc d{ desc };
+    if (d.sliceStride == 0)
+    {
+      d.sliceStride = d.SliceSize();
+    }
+    const std::size_t required{ d.headerSize +
+      d.sliceStride * static_cast<std::size_t>(d.depth - 1) + d.SliceSize() };
+    if (size < required)
+    {
+      return false;
+    }
+    shared->desc = d;
+    shared->grid = TileGrid(d.width, d.height, tileSize);
+    shared_ = std::move(shared);
+    SetWindow(0.0f, d.voxelType == VoxelType::UInt8 ? 255.0f :
+      d.voxelType == VoxelType::UInt16 ? 65535.0f : 1.0f);
+    return true;
+  }
+
+  inline void VolumeSource::Close()
+  {
+    if (shared_ != nullptr)
+    { // queued tasks still hold the shared state and exit when they start
+      shared_->Close();
+      shared_.reset();
+    }
+  }
+
+  inline bool VolumeSource::IsOpen() const
+  {
+    return shared_ != nullptr;
+  }
+
+  inline const VolumeDesc& VolumeSource::Desc() const
+  {
+    static const VolumeDesc empty;
+    return shared_ != nullptr ? shared_->desc : empty;
+  }
+
+  inline const TileGrid& VolumeSource::Grid() const
+  {
+    static const TileGrid empty;
+    return shared_ != nullptr ? shared_->grid : empty;
+  }
+
+  inline const std::uint8_t* VolumeSource::SliceData(int slice) const
+  {
+    if (shared_ == nullptr || slice < 0 || slice >= shared_->desc.depth)
+    {
+      return nullptr;
+    }
+    return shared_->data + shared_->desc.headerSize +
+      shared_->desc.sliceStride * static_cast<std::size_t>(slice);
+  }
+
+  inline void VolumeSource::SetWindow(float minValue, float maxValue)
+  {
+    if (shared_ == nullptr)
+    {
+      return;
+    }
+    Shared& s{ *shared_ };
+    auto window{ std::make_shared<Window>() };
+    window->minValue = minValue;
+    window->maxValue = maxValue;
+
+    // integer voxels go through a lookup table
+    const float range{ maxValue > minValue ? maxValue - minValue : 1.0f };
+    const int lutSize{ s.desc.voxelType == VoxelType::UInt8 ? 256 :
+      s.desc.voxelType == VoxelType::UInt16 ? 65536 : 0 };
+    window->lut.resize(static_cast<std::size_t>(lutSize));
+    for (int v = 0; v < lutSize; ++v)
+    {
+      window->lut[v] = static_cast<std::uint8_t>(std::clamp(
+        (static_cast<float>(v) - minValue) * 255.0f / range + 0.5f, 0.0f, 255.0f));
+    }
+    // tiles decoded with the previous window are stale; a task finishing
+    // one now is rejected as it inserts under the same lock
+    std::lock_guard<std::mutex> lock(s.windowMutex);
+    s.window = std::move(window);
+    ++s.generation;
+    s.cache.Clear();
+  }
+
+  inline void VolumeSource::SetPrefetch(int ahead, int behind)
+  {
+    if (shared_ != nullptr)
+    {
+      shared_->ahead = std::max(0, ahead);
+      shared_->behind = std::max(0, behind);
+    }
+  }
+
+  inline void VolumeSource::SetCacheCapacity(std::size_t tiles)
+  {
+    if (shared_ != nullptr)
+    {
+      shared_->cache.SetCapacity(tiles);
+    }
+  }
+
+  inline void VolumeSource::SetSlice(int slice)
+  {
+    if (shared_ == nullptr)
+    {
+      return;
+    }
+    slice = std::clamp(slice, 0, shared_->desc.depth - 1);
+    const int previous{ shared_->slice.exchange(slice) };
+    if (slice != previous)
+    { // keep the last direction while the slider is idle
+      shared_->direction = slice > previous ? 1 : -1;
+    }
+  }
+
+  inline int VolumeSource::Slice() const
+  {
+    return shared_ != nullptr ? shared_->slice.load() : 0;
+  }
+
+  inline std::shared_ptr<const TileImage> VolumeSource::RequestTile(
+    const TileKey& key)
+  {
+    if (shared_ == nullptr || key.layer < 0 || key.layer >= shared_->desc.depth)
+    {
+      return nullptr;
+    }
+    Shared& s{ *shared_ };
+
+    auto tile{ s.cache.Find(key) };
+    if (tile != nullptr)
+    {
+      ++s.hits;
+    }
+    else
+    {
+      ++s.misses;
+      Enqueue(key, 0);
+    }
+
+    // prefetch the same tile in the nearby slices, closest first
+    const int direction{ s.direction.load() };
+    const int ahead{ s.ahead.load() };
+    const int behind{ s.behind.load() };
+    for (int i = 1; i <= std::max(ahead, behind); ++i)
+    {
+      if (i <= ahead)
+      {
+        TileKey next{ key };
+        next.layer += direction * i;
+        Enqueue(next, -i);
+      }
+      if (i <= behind)
+      {
+        TileKey previous{ key };
+        previous.layer -= direction * i;
+        Enqueue(previous, -i - ahead);
+      }
+    }
+    return tile;
+  }
+
+  inline void VolumeSource::PrefetchTile(const TileKey& key, int priority)
+  {
+    if (shared_ != nullptr)
+    {
+      Enqueue(key, std::min(priority, -1));
+    }
+  }
+
+  inline void VolumeSource::Enqueue(const TileKey& key, int priority)
+  {
+    Shared& s{ *shared_ };
+    if (key.layer < 0 || key.layer >= s.desc.depth || s.cache.Contains(key))
+    {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(s.queuedMutex);
+      if (!s.queued.insert(key).second)
+      { // already queued
+        return;
+      }
+    }
+
+    // ask the OS to read the slice rows covered by the tile
+    const int rows{ s.grid.tileSize << key.level };
+    const std::size_t rowBytes{ static_cast<std::size_t>(s.desc.width) *
+      s.desc.VoxelSize() };
+    s.file.Prefetch(
+      s.desc.headerSize + s.desc.sliceStride * static_cast<std::size_t>(key.layer) +
+        rowBytes * static_cast<std::size_t>(key.y * rows),
+      rowBytes * static_cast<std::size_t>(rows));
+
+    const std::uint64_t generation{ s.generation.load() };
+    ThreadPool::Default().Submit(priority,
+      [shared = shared_, window = s.CurrentWindow(), key, generation] {
+        if (shared->Begin([&] {
+              return shared->generation != generation || !shared->IsWanted(key);
+            }))
+        {
+          auto tile{ std::make_shared<TileImage>() };
+          shared->Decode(key, *window, tile.get());
+          shared->End([&] {
+            std::lock_guard<std::mutex> lock(shared->windowMutex);
+            if (shared->generation == generation)
+            {
+              shared->cache.Insert(key, std::move(tile));
+            }
+          });
+        }
+        std::lock_guard<std::mutex> lock(shared->queuedMutex);
+        shared->queued.erase(key);
+      });
+  }
+
+  inline void VolumeSource::DecodeTile(const TileKey& key, TileImage* out) const
+  {
+    if (shared_ != nullptr && out != nullptr)
+    {
+      shared_->Decode(key, *shared_->CurrentWindow(), out);
+    }
+  }
+
+  inline VolumeSource::Stats VolumeSource::GetStats() const
+  {
+    Stats stats;
+    if (shared_ != nullptr)
+    {
+      stats.cachedTiles = shared_->cache.Size();
+      {
+        std::lock_guard<std::mutex> lock(shared_->queuedMutex);
+        stats.queuedTiles = shared_->queued.size();
+      }
+      stats.hits = shared_->hits;
+      stats.misses = shared_->misses;
+      stats.direction = shared_->direction;
+    }
+    return stats;
+  }
+
+  inline std::shared_ptr<const VolumeSource::Window>
+  VolumeSource::Shared::CurrentWindow() const
+  {
+    std::lock_guard<std::mutex> lock(windowMutex);
+    return window;
+  }
+
+  inline bool VolumeSource::Shared::IsWanted(const TileKey& key) const
+  { // skip tiles that fell out of the prefetch window while queued
+    const int offset{ (key.layer - slice.load()) * direction.load() };
+    return offset <= ahead.load() && -offset <= behind.load();
+  }
+
+  inline void VolumeSource::Shared::Decode(
+    const TileKey& key, const Window& display, TileImage* out) const
+  {
+    const int tw{ grid.TileWidth(key) };
+    const int th{ grid.TileHeight(key) };
+    out->width = tw;
+    out->height = th;
+    out->pixels.resize(static_cast<std::size_t>(tw) * static_cast<std::size_t>(th));
+
+    const std::uint8_t* sliceData{ data + desc.headerSize +
+      desc.sliceStride * static_cast<std::size_t>(key.layer) };
+    const std::size_t voxelSize{ desc.VoxelSize() };
+    const std::size_t rowBytes{ static_cast<std::size_t>(desc.width) * voxelSize };
+
+    // Levels above 0 average a 2x2 footprint at the center of each block of
+    // 2^level x 2^level voxels, so coarse tiles read a bounded number of
+    // voxels regardless of the level.
+    const int step{ 1 << key.level };
+    const int center{ step > 1 ? step / 2 - 1 : 0 };
+    const int x0{ key.x * grid.tileSize };
+    const int y0{ key.y * grid.tileSize };
+
+    // `read(const std::uint8_t*) -> int` maps one voxel to a gray level
+    auto decode = [&](auto read) {
+      for (int y = 0; y < th; ++y)
+      {
+        ImU32* row{ out->pixels.data() + static_cast<std::size_t>(y) * tw };
+        const int sy0{ std::min((y0 + y) * step + center, desc.height - 1) };
+        const std::uint8_t* src0{ sliceData + rowBytes * static_cast<std::size_t>(sy0) };
+        if (step == 1)
+        {
+          for (int x = 0; x < tw; ++x)
+          {
+            const int g{ read(src0 + voxelSize * static_cast<std::size_t>(x0 + x)) };
+            row[x] = IM_COL32(g, g, g, 255);
+          }
+          continue;
+        }
+        const int sy1{ std::min(sy0 + 1, desc.height - 1) };
+        const std::uint8_t* src1{ sliceData + rowBytes * static_cast<std::size_t>(sy1) };
+        for (int x = 0; x < tw; ++x)
+        {
+          const std::size_t sx0{ static_cast<std::size_t>(
+            std::min((x0 + x) * step + center, desc.width - 1)) };
+          const std::size_t sx1{ std::min(sx0 + 1, static_cast<std::size_t>(desc.width - 1)) };
+          const int g{ (read(src0 + voxelSize * sx0) + read(src0 + voxelSize * sx1) +
+                        read(src1 + voxelSize * sx0) + read(src1 + voxelSize * sx1) + 2) / 4 };
+          row[x] = IM_COL32(g, g, g, 255);
+        }
+      }
+    };
+
+    WithVoxelReader(desc, display, decode);
+  }
+
+  template <typename Fn>
+  inline void VolumeSource::Shared::WithVoxelReader(
+    const VolumeDesc& desc, const Window& display, Fn&& fn)
+  {
+    const std::uint8_t* lut{ display.lut.data() };
+    switch (desc.voxelType)
+    {
+    case VoxelType::UInt8:
+      fn([lut](const std::uint8_t* p) { return static_cast<int>(lut[*p]); });
+      break;
+    case VoxelType::UInt16:
+      fn([lut](const std::uint8_t* p) {
+        std::uint16_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return static_cast<int>(lut[v]);
+      });
+      break;
+    case VoxelType::Float32:
+    {
+      const float minValue{ display.minValue };
+      const float factor{ 255.0f / (display.maxValue > display.minValue ?
+        display.maxValue - display.minValue : 1.0f) };
+      fn([minValue, factor](const std::uint8_t* p) {
+        float v;
+        std::memcpy(&v, p, sizeof(v));
+        return static_cast<int>(
+          std::clamp((v - minValue) * factor + 0.5f, 0.0f, 255.0f));
+      });
+      break;
+    }
+    }
+  }
+
+  inline VolumeReslicer::VolumeReslicer(const VolumeSource* volume)
+    : volume_(volume)
+  {
+  }
+
+  inline ImVec2 VolumeReslicer::PlaneSize(SlicePlane plane) const
+  {
+    const VolumeDesc& d{ volume_->Desc() };
+    switch (plane)
+    {
+    case SlicePlane::XY: return ImVec2(static_cast<float>(d.width), static_cast<float>(d.height));
+    case SlicePlane::XZ: return ImVec2(static_cast<float>(d.width), static_cast<float>(d.depth));
+    case SlicePlane::YZ: return ImVec2(static_cast<float>(d.height), static_cast<float>(d.depth));
+    }
+    return ImVec2(0.0f, 0.0f);
+  }
+
+  inline int VolumeReslicer::PlaneIndex(SlicePlane plane) const
+  {
+    switch (plane)
+    {
+    case SlicePlane::XY: return crosshair_[2];
+    case SlicePlane::XZ: return crosshair_[1];
+    case SlicePlane::YZ: return crosshair_[0];
+    }
+    return 0;
+  }
+
+  inline void VolumeReslicer::SetCrosshair(int x, int y, int z)
+  {
+    const VolumeDesc& d{ volume_->Desc() };
+    crosshair_[0] = std::clamp(x, 0, std::max(0, d.width - 1));
+    crosshair_[1] = std::clamp(y, 0, std::max(0, d.height - 1));
+    crosshair_[2] = std::clamp(z, 0, std::max(0, d.depth - 1));
+  }
+
+  inline void VolumeReslicer::SetCrosshairFromView(
+    SlicePlane plane, const ImVec2& imagePoint)
+  {
+    if (std::isnan(imagePoint.x) || std::isnan(imagePoint.y))
+    {
+      return;
+    }
+    const int u{ static_cast<int>(imagePoint.x) };
+    const int v{ static_cast<int>(imagePoint.y) };
+    switch (plane)
+    {
+    case SlicePlane::XY: SetCrosshair(u, v, crosshair_[2]); break;
+    case SlicePlane::XZ: SetCrosshair(u, crosshair_[1], v); break;
+    case SlicePlane::YZ: SetCrosshair(crosshair_[0], u, v); break;
+    }
+  }
+
+  inline void VolumeReslicer::Crosshair(int* x, int* y, int* z) const
+  {
+    if (x != nullptr) { *x = crosshair_[0]; }
+    if (y != nullptr) { *y = crosshair_[1]; }
+    if (z != nullptr) { *z = crosshair_[2]; }
+  }
+
+  inline bool VolumeReslicer::Update(SlicePlane plane, const ViewTransform& view)
+  {
+    if (!volume_->IsOpen())
+    {
+      return false;
+    }
+    PlaneImage& image{ images_[static_cast<int>(plane)] };
+    const ImVec2 size{ PlaneSize(plane) };
+    const TileGrid grid(static_cast<int>(size.x), static_cast<int>(size.y));
+
+    ImVec2 visibleMin, visibleMax;
+    view.VisibleImageRect(&visibleMin, &visibleMax);
+    const ImVec2 scale{ view.Scale() };
+    const int level{ grid.LevelForScale(std::max(scale.x, scale.y)) };
+    const int index{ PlaneIndex(plane) };
+    const std::uint64_t generation{ volume_->shared_->generation.load() };
+
+    if (image.valid && image.level == level && image.index == index &&
+        image.generation == generation &&
+        visibleMin.x >= image.min.x && visibleMin.y >= image.min.y &&
+        visibleMax.x <= image.max.x && visibleMax.y <= image.max.y)
+    { // the visible region was already computed
+      return false;
+    }
+
+    // compute a margin around the visible region so small pans do not
+    // trigger a new computation every frame
+    const float marginX{ (visibleMax.x - visibleMin.x) * margin };
+    const float marginY{ (visibleMax.y - visibleMin.y) * margin };
+    const ImVec2 regionMin{
+      std::max(0.0f, visibleMin.x - marginX), std::max(0.0f, visibleMin.y - marginY) };
+    const ImVec2 regionMax{
+      std::min(size.x, visibleMax.x + marginX), std::min(size.y, visibleMax.y + marginY) };
+
+    Compute(plane, index, level, regionMin, regionMax, &image);
+    image.generation = generation;
+    return true;
+  }
+
+  inline const VolumeReslicer::PlaneImage& VolumeReslicer::Image(
+    SlicePlane plane) const
+  {
+    return images_[static_cast<int>(plane)];
+  }
+
+  inline void VolumeReslicer::Compute(
+    SlicePlane plane,
+    int index,
+    int level,
+    const ImVec2& min,
+    const ImVec2& max,
+    PlaneImage* out) const
+  {
+    if (!volume_->IsOpen())
+    {
+      *out = PlaneImage();
+      return;
+    }
+    const VolumeSource::Shared& shared{ *volume_->shared_ };
+    const VolumeDesc& d{ shared.desc };
+    const ImVec2 size{ PlaneSize(plane) };
+    const int step{ 1 << level };
+    const int center{ step > 1 ? step / 2 - 1 : 0 };
+
+    // region in level pixels, aligned outwards
+    const int u0{ static_cast<int>(std::floor(min.x)) / step };
+    const int v0{ static_cast<int>(std::floor(min.y)) / step };
+    const int u1{ (static_cast<int>(std::ceil(max.x)) + step - 1) / step };
+    const int v1{ (static_cast<int>(std::ceil(max.y)) + step - 1) / step };
+    const int width{ std::max(0, u1 - u0) };
+    const int height{ std::max(0, v1 - v0) };
+
+    out->index = index;
+    out->level = level;
+    out->min = ImVec2(static_cast<float>(u0 * step), static_cast<float>(v0 * step));
+    out->max = ImVec2(
+      std::min(size.x, static_cast<float>(u1 * step)),
+      std::min(size.y, static_cast<float>(v1 * step)));
+    out->image.width = width;
+    out->image.height = height;
+    out->image.pixels.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+    out->valid = true;
+
+    // byte strides of the plane axes (u horizontal, v vertical) and offset
+    // of the plane `index` in the volume
+    const std::size_t voxelStride{ d.VoxelSize() };
+    const std::size_t rowStride{ static_cast<std::size_t>(d.width) * voxelStride };
+    const std::size_t sliceStride{ d.sliceStride };
+    std::size_t strideU{ voxelStride };
+    std::size_t strideV{ rowStride };
+    std::size_t offset{ d.headerSize };
+    int lastU{ d.width - 1 };
+    int lastV{ d.height - 1 };
+    switch (plane)
+    {
+    case SlicePlane::XY:
+      offset += sliceStride * static_cast<std::size_t>(index);
+      break;
+    case SlicePlane::XZ:
+      strideV = sliceStride;
+      offset += rowStride * static_cast<std::size_t>(index);
+      lastV = d.depth - 1;
+      break;
+    case SlicePlane::YZ:
+      strideU = rowStride;
+      strideV = sliceStride;
+      offset += voxelStride * static_cast<std::size_t>(index);
+      lastU = d.height - 1;
+      lastV = d.depth - 1;
+      break;
+    }
+    const std::uint8_t* base{ shared.data + offset };
+
+    // Split the output in blocks of a few rows by a few hundred columns and
+    // spread the blocks across threads. Within a block, rows are walked along
+    // the smallest input stride, and each block only touches a bounded set of
+    // slices and rows, which keeps the working set (and page faults of the
+    // mapping) local even for the strided YZ gathers.
+    constexpr int kBlockRows{ 16 };
+    constexpr int kBlockCols{ 256 };
+    const int blocksX{ (width + kBlockCols - 1) / kBlockCols };
+    const int blocksY{ (height + kBlockRows - 1) / kBlockRows };
+    ImU32* pixels{ out->image.pixels.data() };
+
+    VolumeSource::Shared::WithVoxelReader(d, *shared.CurrentWindow(), [&](auto read) {
+      ParallelFor(0, blocksX * blocksY, [&](int block) {
+        const int bx{ block % blocksX };
+        const int by{ block / blocksX };
+        const int c0{ bx * kBlockCols };
+        const int c1{ std::min(width, c0 + kBlockCols) };
+        const int r1{ std::min(height, (by + 1) * kBlockRows) };
+        for (int r = by * kBlockRows; r < r1; ++r)
+        {
+          const int v{ std::min((v0 + r) * step + center, lastV) };
+          const std::uint8_t* src{ base + strideV * static_cast<std::size_t>(v) };
+          ImU32* dst{ pixels + static_cast<std::size_t>(r) * width };
+          for (int c = c0; c < c1; ++c)
+          {
+            const int u{ std::min((u0 + c) * step + center, lastU) };
+            const int g{ read(src + strideU * static_cast<std::size_t>(u)) };
+            dst[c] = IM_COL32(g, g, g, 255);
+          }
+        }
+      });
+    });
+  }
+
+  inline void VolumeReslicer::DrawCrosshair(
+    ImDrawList* drawList,
+    const ViewTransform& view,
+    SlicePlane plane,
+    ImU32 color) const
+  {
+    int u{ 0 }, v{ 0 };
+    switch (plane)
+    {
+    case SlicePlane::XY: u = crosshair_[0]; v = crosshair_[1]; break;
+    case SlicePlane::XZ: u = crosshair_[0]; v = crosshair_[2]; break;
+    case SlicePlane::YZ: u = crosshair_[1]; v = crosshair_[2]; break;
+    }
+    const ImVec2 size{ PlaneSize(plane) };
+    const float x{ static_cast<float>(u) + 0.5f };
+    const float y{ static_cast<float>(v) + 0.5f };
+    drawList->AddLine(view.ImageToScreen(ImVec2(x, 0.0f)),
+      view.ImageToScreen(ImVec2(x, size.y)), color);
+    drawList->AddLine(view.ImageToScreen(ImVec2(0.0f, y)),
+      view.ImageToScreen(ImVec2(size.x, y)), color);
+  }
+} // namespace ImGuiImage
+
+#endif // IMGUI_ZOOMABLE_VOLUME_H
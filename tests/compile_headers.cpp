@@ -0,0 +1,115 @@
+// Compiles every header of the library and instantiates its templates, so
+// errors in code the examples do not use are caught by the build.
+
+#include "../imgui_zoomable_image.h"
+#include "../imgui_zoomable_stream.h"
+#include "../imgui_zoomable_tiles.h"
+#include "../imgui_zoomable_texture.h"
+#include "../imgui_zoomable_minify.h"
+#include "../imgui_zoomable_resample.h"
+#include "../imgui_zoomable_export.h"
+#include "../imgui_zoomable_ingest.h"
+#include "../imgui_zoomable_volume.h"
+#include "../imgui_zoomable_analysis.h"
+#include "../imgui_zoomable_colormap.h"
+#include "../imgui_zoomable_composite.h"
+#include "../imgui_zoomable_compare.h"
+#include "../imgui_zoomable_minimap.h"
+#include "../imgui_zoomable_overlay.h"
+#include "../imgui_zoomable_mosaic.h"
+#include "../imgui_zoomable_sequence.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ImGuiImage
+{
+  template class TileCache<TileImage>;
+  template class LiveStream<std::vector<ImU32>>;
+  template class ScalarPyramid<std::uint8_t>;
+  template class ScalarPyramid<std::uint16_t>;
+  template class ScalarPyramid<float>;
+  template class ColormapSource<std::uint8_t>;
+  template class ColormapSource<std::uint16_t>;
+  template class ColormapSource<float>;
+  template class DifferenceSource<std::uint8_t>;
+  template class DifferenceSource<std::uint16_t>;
+  template class DifferenceSource<float>;
+  template class ChannelCompositor<std::uint8_t>;
+  template class ChannelCompositor<std::uint16_t>;
+  template class FrameSequence<std::vector<ImU32>>;
+}
+
+using namespace ImGuiImage;
+
+// Never called: instantiates the function templates with callbacks.
+void InstantiateFunctionTemplates(ImDrawList* drawList, State* state)
+{
+  const ViewTransform& view{ state->view };
+  const ImVec2 size{ 256.0f, 256.0f };
+  const TileGrid grid(1024, 1024);
+  auto lookup = [](const TileKey&) { return TileTexture(); };
+
+  ZoomableCustom(size, state, [](ImDrawList*, const ViewTransform&) {});
+  ZoomableTiles(grid, 0, size, state, lookup);
+  DrawTileLayer(drawList, view, grid, 0, lookup, view.screenPos, size);
+  ParallelFor(0, 16, [](int) {});
+
+  CompareState compare;
+  ZoomableTilesCompare(grid, 0, size, state, &compare, lookup, lookup);
+  MinimapState minimap;
+  DrawMinimapTiles(drawList, view, state, &minimap, grid, 0, lookup);
+  Mosaic mosaic;
+  DrawMosaic(drawList, view, mosaic, lookup, view.screenPos, size);
+  ZoomableMosaic(mosaic, size, state, lookup);
+
+  const float points[4]{};
+  float transformed[4]{};
+  const double xs[2]{}, ys[2]{};
+  double outX[2]{}, outY[2]{};
+  view.ImageToScreenTransform().Apply(points, 2, transformed);
+  view.ImageToScreenTransform().Apply(xs, ys, 2, outX, outY);
+
+  auto readRow = [](int, int, int, ImU32*) {};
+  auto writeRow = [](int, const ImU32*) {};
+  ExportRegion(16, 16, 0, 0, 16, 16, ExportOptions(), readRow, writeRow);
+  ExportViewToBmp("view.bmp", *state, TileRowReader(grid, 0,
+    [](const TileKey&, TileImage*) {}));
+  ResampleRows(16, 16, ImVec2(0.0f, 0.0f), size, 8, 8, ResampleFilter::Area,
+    readRow, writeRow);
+
+  const std::uint16_t values[4]{};
+  const float floats[4]{};
+  ImU32 colors[4]{};
+  const std::vector<ImU32> table(256, IM_COL32_WHITE);
+  ApplyColormap(values, 4, 0.0f, 1.0f, table, colors);
+  ApplyColormap(floats, 4, 0.0f, 1.0f, table, colors);
+  ApplyLut(values, 4, BuildValueLut<std::uint16_t>(0.0f, 1.0f, table).data(), colors);
+  BlendChannel(values, BuildChannelLut<std::uint16_t>(ChannelSettings()).data(),
+    ChannelBlend::Additive, 4, colors);
+  std::uint16_t difference[4]{};
+  AbsDifference(values, values, 4, difference);
+
+  const ScalarImage<std::uint16_t> image{ values, 2, 2, 2 };
+  std::vector<float> samples;
+  SampleLineProfile(image, ImVec2(0.0f, 0.0f), ImVec2(1.0f, 1.0f), &samples);
+  SampleLineProfile(ScalarPyramid<std::uint16_t>(image), ImVec2(0.0f, 0.0f),
+    ImVec2(1.0f, 1.0f), &samples);
+
+  OverlayIndex index;
+  index.Build(4, [](std::size_t, ImVec2* min, ImVec2* max) {
+    *min = ImVec2(0.0f, 0.0f);
+    *max = ImVec2(1.0f, 1.0f);
+  });
+
+  CpuTextureProvider provider;
+  TexturePool pool(&provider);
+  TileAtlas atlas(&pool, 256);
+  atlas.EraseIf([](const TileKey&) { return true; });
+  atlas.Defragment([](const TileKey&) -> const TileImage* { return nullptr; });
+  UploadScheduler scheduler;
+  scheduler.Process(grid, *state, [](const TileKey&, const TileImage&) {});
+  scheduler.EraseIf([](const TileKey&) { return true; });
+  TileCache<TileImage> cache(16);
+  cache.EraseIf([](const TileKey&) { return true; });
+}
@@ -0,0 +1,251 @@
+// Headless test of TexturePool, TileAtlas and UploadScheduler, run against
+// CpuTextureProvider.
+
+#include "../imgui_zoomable_texture.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace ImGuiImage;
+
+namespace
+{
+  int failures = 0;
+
+#define CHECK(condition)                                              \
+  do                                                                  \
+  {                                                                   \
+    if (!(condition))                                                 \
+    {                                                                 \
+      std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,    \
+        #condition);                                                  \
+      ++failures;                                                     \
+    }                                                                 \
+  } while (false)
+
+  TileImage MakeTile(int width, int height, ImU32 color)
+  {
+    TileImage image;
+    image.width = width;
+    image.height = height;
+    image.pixels.assign(static_cast<std::size_t>(width) * height, color);
+    return image;
+  }
+
+  // Pixel (x, y) of an RGBA8 texture of the provider.
+  ImU32 PixelAt(const CpuTextureProvider& provider, ImTextureID id, int x, int y)
+  {
+    const CpuTextureProvider::Texture* texture{ provider.Find(id) };
+    if (texture == nullptr)
+    {
+      return 0;
+    }
+    ImU32 pixel;
+    std::memcpy(&pixel, texture->pixels.data() +
+      static_cast<std::size_t>(y) * texture->desc.RowBytes() +
+      static_cast<std::size_t>(x) * sizeof(ImU32), sizeof(pixel));
+    return pixel;
+  }
+
+  void TestTexturePool()
+  {
+    CpuTextureProvider provider;
+    {
+      TexturePool pool(&provider, 1);
+      const TextureDesc small{ 4, 4, TextureFormat::RGBA8 };
+
+      PooledTexture a{ pool.Acquire(small) };
+      CHECK(a.Valid());
+      const std::vector<ImU32> pixels(16, IM_COL32(1, 2, 3, 4));
+      pool.Upload(a, pixels.data());
+      CHECK(PixelAt(provider, a.id, 3, 3) == IM_COL32(1, 2, 3, 4));
+
+      // released textures are reused, content included
+      const ImTextureID id{ a.id };
+      pool.Release(&a);
+      CHECK(!a.Valid());
+      PooledTexture b{ pool.Acquire(small) };
+      CHECK(b.id == id);
+      CHECK(PixelAt(provider, b.id, 0, 0) == IM_COL32(1, 2, 3, 4));
+      CHECK(pool.GetStats().reused == 1);
+      CHECK(provider.GetStats().creates == 1);
+
+      // a different size gets its own texture
+      PooledTexture c{ pool.Acquire({ 8, 8, TextureFormat::RGBA8 }) };
+      CHECK(c.Valid() && c.id != b.id);
+      CHECK(pool.GetStats().live == 2);
+
+      // only `maxIdle` released textures are kept
+      pool.Release(&b);
+      pool.Release(&c);
+      CHECK(pool.GetStats().idle == 1);
+      CHECK(pool.GetStats().destroyed == 1);
+      CHECK(provider.Size() == 1);
+
+      pool.SetMaxIdle(0);
+      CHECK(pool.GetStats().idle == 0);
+      CHECK(provider.Size() == 0);
+    }
+    CHECK(provider.GetStats().creates == provider.GetStats().destroys);
+  }
+
+  void TestTileAtlas()
+  {
+    CpuTextureProvider provider;
+    TexturePool pool(&provider);
+    {
+      // 4 slots of 4x4 pixels per page
+      TileAtlas atlas(&pool, 4, 8);
+      atlas.maxPages = 2;
+      std::vector<TileImage> tiles;
+      for (int i = 0; i < 8; ++i)
+      {
+        tiles.push_back(MakeTile(4, 4, IM_COL32(i, 0, 0, 255)));
+      }
+
+      atlas.NewFrame();
+      for (int i = 0; i < 8; ++i)
+      {
+        CHECK(atlas.Insert({ 0, 0, i, 0 }, tiles[i]));
+      }
+      CHECK(atlas.Size() == 8);
+      CHECK(atlas.PageCount() == 2);
+      CHECK(atlas.FillRatio() == 1.0f);
+
+      // the tile is drawn from its slot of the page texture
+      for (int i = 0; i < 8; ++i)
+      {
+        const TileTexture tile{ atlas.Lookup({ 0, 0, i, 0 }) };
+        CHECK(tile.valid);
+        CHECK(tile.uv1.x - tile.uv0.x == 0.5f && tile.uv1.y - tile.uv0.y == 0.5f);
+        const int x{ static_cast<int>(tile.uv0.x * 8.0f) };
+        const int y{ static_cast<int>(tile.uv0.y * 8.0f) };
+        CHECK(PixelAt(provider, tile.texRef.GetTexID(), x + 3, y + 3) ==
+          IM_COL32(i, 0, 0, 255));
+      }
+      CHECK(!atlas.Lookup({ 0, 0, 8, 0 }).valid);
+
+      // full and all tiles drawn this frame: nothing can be evicted
+      CHECK(!atlas.Insert({ 0, 0, 8, 0 }, tiles[0]));
+
+      // the next frame, the least recently used tile gives its slot
+      atlas.NewFrame();
+      for (int i = 1; i < 8; ++i)
+      {
+        atlas.Lookup({ 0, 0, i, 0 });
+      }
+      CHECK(atlas.Insert({ 0, 0, 8, 0 }, tiles[0]));
+      CHECK(!atlas.Contains({ 0, 0, 0, 0 }));
+      CHECK(atlas.Contains({ 0, 0, 8, 0 }));
+      CHECK(atlas.PageCount() == 2);
+
+      // a sparse atlas is compacted into one page, tiles keep their pixels
+      atlas.EraseIf([](const TileKey& key) { return key.x >= 3; });
+      CHECK(atlas.Size() == 2);
+      CHECK(atlas.NeedsDefragment());
+      const int moved{ atlas.Defragment([&](const TileKey& key) -> const TileImage* {
+        return &tiles[static_cast<std::size_t>(key.x)];
+      }) };
+      CHECK(moved <= 2);
+      CHECK(atlas.PageCount() == 1);
+      CHECK(atlas.Size() == 2);
+      for (int i = 1; i < 3; ++i)
+      {
+        const TileTexture tile{ atlas.Lookup({ 0, 0, i, 0 }) };
+        const int x{ static_cast<int>(tile.uv0.x * 8.0f) };
+        const int y{ static_cast<int>(tile.uv0.y * 8.0f) };
+        CHECK(PixelAt(provider, tile.texRef.GetTexID(), x, y) ==
+          IM_COL32(i, 0, 0, 255));
+      }
+    }
+    // pages are given back to the pool with the atlas
+    CHECK(pool.GetStats().live == 0);
+  }
+
+  void TestUploadScheduler()
+  {
+    // 4x4 tiles of 64 pixels, level 0 only in view
+    const TileGrid grid(256, 256, 64);
+    State state;
+    state.textureSize = ImVec2(256.0f, 256.0f);
+    state.zoomLevel = 4.0f;
+    state.panOffset = ImVec2(0.0f, 0.0f);
+
+    UploadScheduler scheduler;
+    const std::size_t tileBytes{ 64 * 64 * sizeof(ImU32) };
+    scheduler.budget.bytesPerFrame = 2 * tileBytes;
+    for (int y = 0; y < 4; ++y)
+    {
+      for (int x = 0; x < 4; ++x)
+      {
+        scheduler.Enqueue({ 0, 0, x, y },
+          std::make_shared<const TileImage>(MakeTile(64, 64, IM_COL32_WHITE)));
+      }
+    }
+    scheduler.Enqueue({ 0, 1, 1, 1 },
+      std::make_shared<const TileImage>(MakeTile(64, 64, IM_COL32_WHITE)));
+    CHECK(scheduler.GetStats().pending == 17);
+
+    // the visible tile, then the coarser one, within the budget
+    std::vector<TileKey> uploaded;
+    auto upload = [&](const TileKey& key, const TileImage&) { uploaded.push_back(key); };
+    CHECK(scheduler.Process(grid, state, upload) == 2);
+    CHECK(uploaded.size() == 2);
+    CHECK(uploaded[0] == TileKey({ 0, 0, 0, 0 }));
+    CHECK(uploaded[1] == TileKey({ 0, 1, 1, 1 }));
+    CHECK(scheduler.GetStats().lastFrameBytes == 2 * tileBytes);
+    CHECK(scheduler.GetStats().pending == 15);
+
+    // a tile queued again while pending is uploaded once
+    scheduler.Enqueue({ 0, 0, 3, 3 },
+      std::make_shared<const TileImage>(MakeTile(64, 64, IM_COL32(0, 0, 0, 255))));
+    CHECK(scheduler.GetStats().pending == 15);
+
+    // dropped tiles are not uploaded
+    scheduler.EraseIf([](const TileKey& key) { return key.y == 3; });
+    CHECK(!scheduler.IsPending({ 0, 0, 3, 3 }));
+    CHECK(scheduler.GetStats().pending == 11);
+
+    // the rest drains over the next frames
+    int frames{ 0 };
+    while (scheduler.GetStats().pending > 0 && frames < 100)
+    {
+      CHECK(scheduler.Process(grid, state, upload) <= 2);
+      ++frames;
+    }
+    CHECK(frames == 6);
+    CHECK(uploaded.size() == 13);
+    CHECK(scheduler.GetStats().uploaded == 13);
+
+    // uploads into an atlas
+    CpuTextureProvider provider;
+    TexturePool pool(&provider);
+    TileAtlas atlas(&pool, 64, 256);
+    scheduler.budget.bytesPerFrame = 0;
+    scheduler.Enqueue({ 0, 0, 0, 0 },
+      std::make_shared<const TileImage>(MakeTile(64, 64, IM_COL32_WHITE)));
+    atlas.NewFrame();
+    scheduler.Process(grid, state, [&](const TileKey& key, const TileImage& image) {
+      atlas.Insert(key, image);
+    });
+    CHECK(atlas.Contains({ 0, 0, 0, 0 }));
+    CHECK(provider.GetStats().bytesUploaded == tileBytes);
+  }
+}
+
+int main()
+{
+  TestTexturePool();
+  TestTileAtlas();
+  TestUploadScheduler();
+  if (failures > 0)
+  {
+    std::printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("All checks passed\n");
+  return 0;
+}